@@ -0,0 +1,342 @@
+#pragma once
+
+#include "../types.hpp"
+
+/* Implementation, NOT to be passed around */
+
+namespace Impl
+{
+
+/// Banned addresses indexed by the address they're looked up with
+/// Exact addresses are hashed, IPv4 ranges written in CIDR notation ("10.0.0.0/8") or with trailing wildcards ("10.0.*.*") are kept in a binary prefix trie
+/// and other wildcards ("10.*.0.1") are rare enough to be matched one by one
+class BanIndex
+{
+public:
+	static constexpr size_t NotFound = size_t(-1);
+
+	BanIndex()
+	{
+		nodes_.emplace_back();
+	}
+
+	/// Parse a dotted IPv4 address into its host order value
+	static bool parseIPv4(StringView address, uint32_t& ip)
+	{
+		StringView octets[4];
+		if (!splitOctets(address, octets))
+		{
+			return false;
+		}
+
+		uint32_t out = 0;
+		for (StringView octet : octets)
+		{
+			uint32_t value;
+			if (!parseOctet(octet, value))
+			{
+				return false;
+			}
+			out = (out << 8) | value;
+		}
+		ip = out;
+		return true;
+	}
+
+	/// Parse an IPv4 range written in CIDR notation or with trailing wildcards, returns false for anything else
+	static bool parseRange(StringView pattern, uint32_t& prefix, int& bits)
+	{
+		const size_t slash = pattern.find('/');
+		if (slash != StringView::npos)
+		{
+			const StringView length = pattern.substr(slash + 1);
+			uint32_t ip;
+			uint32_t value;
+			if (!parseIPv4(pattern.substr(0, slash), ip) || length.size() > 2 || !parseOctet(length, value) || value > 32)
+			{
+				return false;
+			}
+			bits = int(value);
+			prefix = ip & mask(bits);
+			return true;
+		}
+
+		StringView octets[4];
+		if (!splitOctets(pattern, octets))
+		{
+			return false;
+		}
+
+		uint32_t ip = 0;
+		int numeric = 0;
+		for (int i = 0; i < 4; ++i)
+		{
+			uint32_t value = 0;
+			if (octets[i] == "*")
+			{
+				ip <<= 8;
+				continue;
+			}
+			else if (numeric != i || !parseOctet(octets[i], value))
+			{
+				// Wildcards followed by a number aren't a prefix
+				return false;
+			}
+			ip = (ip << 8) | value;
+			++numeric;
+		}
+
+		if (numeric == 4)
+		{
+			return false;
+		}
+		bits = numeric * 8;
+		prefix = ip;
+		return true;
+	}
+
+	/// Whether a ban on a pattern covers an address
+	static bool matches(StringView pattern, StringView address)
+	{
+		if (pattern == address)
+		{
+			return true;
+		}
+
+		uint32_t ip;
+		if (!parseIPv4(address, ip))
+		{
+			return false;
+		}
+
+		uint32_t prefix;
+		int bits;
+		if (parseRange(pattern, prefix, bits))
+		{
+			return (ip & mask(bits)) == prefix;
+		}
+		return matchesWildcards(pattern, ip);
+	}
+
+	/// Add a banned address or range, returns false if it's already there
+	/// @param index The position of the ban in its owner's list
+	bool insert(StringView pattern, size_t index)
+	{
+		String key(pattern);
+		if (!entries_.emplace(key, index).second)
+		{
+			return false;
+		}
+
+		uint32_t prefix;
+		int bits;
+		if (parseRange(pattern, prefix, bits))
+		{
+			++nodes_[findNode(prefix, bits, true)].ranges;
+		}
+		else if (pattern.find('*') != StringView::npos)
+		{
+			wildcards_.emplace(std::move(key));
+		}
+		return true;
+	}
+
+	/// Remove a banned address or range, returns its position or NotFound
+	size_t erase(StringView pattern)
+	{
+		auto it = entries_.find(String(pattern));
+		if (it == entries_.end())
+		{
+			return NotFound;
+		}
+
+		const size_t index = it->second;
+		entries_.erase(it);
+
+		uint32_t prefix;
+		int bits;
+		if (parseRange(pattern, prefix, bits))
+		{
+			--nodes_[findNode(prefix, bits, false)].ranges;
+		}
+		else if (pattern.find('*') != StringView::npos)
+		{
+			wildcards_.erase(String(pattern));
+		}
+		return index;
+	}
+
+	/// Get the position of a banned address or range, NotFound if it isn't banned as written
+	size_t find(StringView pattern) const
+	{
+		auto it = entries_.find(String(pattern));
+		return it == entries_.end() ? NotFound : it->second;
+	}
+
+	/// Update the position of a ban which moved in its owner's list
+	void move(StringView pattern, size_t index)
+	{
+		auto it = entries_.find(String(pattern));
+		if (it != entries_.end())
+		{
+			it->second = index;
+		}
+	}
+
+	/// Whether any ban covers an address
+	bool matches(StringView address) const
+	{
+		if (entries_.find(String(address)) != entries_.end())
+		{
+			return true;
+		}
+
+		uint32_t ip;
+		if (!parseIPv4(address, ip))
+		{
+			return false;
+		}
+
+		uint32_t node = 0;
+		for (int bit = 0;; ++bit)
+		{
+			if (nodes_[node].ranges)
+			{
+				return true;
+			}
+			if (bit == 32)
+			{
+				break;
+			}
+			node = nodes_[node].children[(ip >> (31 - bit)) & 1];
+			if (node == 0)
+			{
+				break;
+			}
+		}
+
+		for (const String& pattern : wildcards_)
+		{
+			if (matchesWildcards(pattern, ip))
+			{
+				return true;
+			}
+		}
+		return false;
+	}
+
+	size_t size() const
+	{
+		return entries_.size();
+	}
+
+	void clear()
+	{
+		entries_.clear();
+		wildcards_.clear();
+		nodes_.clear();
+		nodes_.emplace_back();
+	}
+
+private:
+	/// A node of the prefix trie, the root is never a child so 0 means no child
+	struct Node
+	{
+		uint32_t children[2] = { 0, 0 };
+		uint32_t ranges = 0; ///< Bans on the range this node's path spells
+	};
+
+	static uint32_t mask(int bits)
+	{
+		return bits == 0 ? 0 : ~uint32_t(0) << (32 - bits);
+	}
+
+	static bool splitOctets(StringView address, StringView (&octets)[4])
+	{
+		for (int i = 0; i < 3; ++i)
+		{
+			const size_t dot = address.find('.');
+			if (dot == StringView::npos)
+			{
+				return false;
+			}
+			octets[i] = address.substr(0, dot);
+			address = address.substr(dot + 1);
+		}
+		octets[3] = address;
+		return address.find('.') == StringView::npos;
+	}
+
+	static bool parseOctet(StringView octet, uint32_t& value)
+	{
+		if (octet.empty() || octet.size() > 3)
+		{
+			return false;
+		}
+
+		uint32_t out = 0;
+		for (char c : octet)
+		{
+			if (c < '0' || c > '9')
+			{
+				return false;
+			}
+			out = out * 10 + (c - '0');
+		}
+		if (out > 255)
+		{
+			return false;
+		}
+		value = out;
+		return true;
+	}
+
+	/// Match an address against a pattern with wildcard octets anywhere
+	static bool matchesWildcards(StringView pattern, uint32_t ip)
+	{
+		StringView octets[4];
+		if (!splitOctets(pattern, octets))
+		{
+			return false;
+		}
+
+		for (int i = 0; i < 4; ++i)
+		{
+			uint32_t value;
+			if (octets[i] != "*" && (!parseOctet(octets[i], value) || value != ((ip >> (24 - i * 8)) & 0xFF)))
+			{
+				return false;
+			}
+		}
+		return true;
+	}
+
+	/// Get the node of a range, creating it and its parents if asked to
+	uint32_t findNode(uint32_t prefix, int bits, bool create)
+	{
+		uint32_t node = 0;
+		for (int bit = 0; bit < bits; ++bit)
+		{
+			const int side = (prefix >> (31 - bit)) & 1;
+			uint32_t next = nodes_[node].children[side];
+			if (next == 0)
+			{
+				if (!create)
+				{
+					return 0;
+				}
+				next = uint32_t(nodes_.size());
+				nodes_[node].children[side] = next;
+				nodes_.emplace_back();
+			}
+			node = next;
+		}
+		return node;
+	}
+
+	FlatHashMap<String, size_t> entries_; ///< Every ban as written, with its position
+	FlatHashSet<String> wildcards_; ///< Wildcard bans which aren't a prefix
+	DynamicArray<Node> nodes_; ///< Prefix trie of the range bans, removed ranges leave their nodes until the index is cleared
+};
+
+}
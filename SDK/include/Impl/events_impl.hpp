@@ -1,6 +1,7 @@
 #pragma once
 
 #include "../events.hpp"
+#include "../profiler.hpp"
 
 /* Implementation, NOT to be passed around */
 
@@ -124,9 +125,17 @@ struct DefaultEventDispatcher final : public IEventDispatcher<EventHandlerType>,
 		return handlers.has(handler, priority);
 	}
 
+	/// Record the time taken by every dispatch of an event to its handlers into a profiler section
+	void setProfileSection(ITickProfilerExtension* profiler, int section)
+	{
+		profiler_ = profiler;
+		profileSection_ = section;
+	}
+
 	template <typename Return, typename... Params, typename... Args>
 	void dispatch(Return (EventHandlerType::*mf)(Params...), Args&&... args)
 	{
+		ProfileScope scope(profiler_, profileSection_);
 		for (const typename Storage::Entry& storage : handlers)
 		{
 			EventHandlerType* handler = storage.handler;
@@ -137,18 +146,21 @@ struct DefaultEventDispatcher final : public IEventDispatcher<EventHandlerType>,
 	template <typename Fn>
 	void all(Fn fn)
 	{
+		ProfileScope scope(profiler_, profileSection_);
 		std::for_each(handlers.begin(), handlers.end(), typename Storage::template Func<void, Fn>(fn));
 	}
 
 	template <typename Fn>
 	auto stopAtFalse(Fn fn)
 	{
+		ProfileScope scope(profiler_, profileSection_);
 		return std::all_of(handlers.begin(), handlers.end(), typename Storage::template Func<bool, Fn>(fn));
 	}
 
 	template <typename Fn>
 	auto anyTrue(Fn fn)
 	{
+		ProfileScope scope(profiler_, profileSection_);
 		// `anyTrue` should still CALL them call, don't short-circuit.
 		bool ret = false;
 		std::for_each(handlers.begin(), handlers.end(), typename Storage::template Func<bool, Fn>([&fn, &ret]()
@@ -161,12 +173,14 @@ struct DefaultEventDispatcher final : public IEventDispatcher<EventHandlerType>,
 	template <typename Fn>
 	auto stopAtTrue(Fn fn)
 	{
+		ProfileScope scope(profiler_, profileSection_);
 		return std::any_of(handlers.begin(), handlers.end(), typename Storage::template Func<bool, Fn>(fn));
 	}
 
 	template <typename Fn>
 	auto allTrue(Fn fn)
 	{
+		ProfileScope scope(profiler_, profileSection_);
 		bool ret = true;
 		std::for_each(handlers.begin(), handlers.end(), typename Storage::template Func<bool, Fn>([&fn, &ret]()
 															{
@@ -182,6 +196,8 @@ struct DefaultEventDispatcher final : public IEventDispatcher<EventHandlerType>,
 
 private:
 	Storage handlers;
+	ITickProfilerExtension* profiler_ = nullptr;
+	int profileSection_ = 0;
 };
 
 template <class EventHandlerType>
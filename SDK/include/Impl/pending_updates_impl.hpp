@@ -0,0 +1,52 @@
+#pragma once
+
+#include "../types.hpp"
+
+/* Implementation, NOT to be passed around */
+
+namespace Impl
+{
+
+/// Entries with changes waiting to be sent to players, sent together once per tick so several changes made in one callback cost one update
+/// T must have a flushUpdate() method which sends its changes; entries must remove themselves when they're destroyed
+template <class T>
+struct PendingUpdates : public NoCopy
+{
+	void add(T& entry)
+	{
+		entries_.insert(&entry);
+	}
+
+	void remove(T& entry)
+	{
+		entries_.erase(&entry);
+	}
+
+	void clear()
+	{
+		entries_.clear();
+	}
+
+	/// Send the changes of every pending entry, call once per tick
+	void flush()
+	{
+		if (entries_.empty())
+		{
+			return;
+		}
+
+		// Swapped out so flushing an entry can't invalidate the iteration
+		flushing_.swap(entries_);
+		for (T* entry : flushing_)
+		{
+			entry->flushUpdate();
+		}
+		flushing_.clear();
+	}
+
+private:
+	FlatPtrHashSet<T> entries_;
+	FlatPtrHashSet<T> flushing_;
+};
+
+}
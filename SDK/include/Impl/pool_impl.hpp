@@ -3,6 +3,10 @@
 #include "../pool.hpp"
 #include "events_impl.hpp"
 
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
 /* Implementation, NOT to be passed around */
 
 namespace Impl
@@ -44,19 +48,123 @@ struct ScopedPoolReleaseLock
 	}
 };
 
-template <typename T, size_t Size>
-struct UniqueIDArray : public NoCopy
+/// A fixed size set of IDs which can be walked in ID order, skipping 64 absent IDs at a time
+template <size_t Size>
+struct PoolIDSet
 {
-	int findFreeIndex(int from) const
+	PoolIDSet()
+	{
+		reset();
+	}
+
+	void set(int index)
+	{
+		words_[index / 64] |= uint64_t(1) << (index % 64);
+	}
+
+	void reset(int index)
+	{
+		words_[index / 64] &= ~(uint64_t(1) << (index % 64));
+	}
+
+	void reset()
 	{
-		for (int i = from; i < Size; ++i)
+		words_.fill(0);
+	}
+
+	bool test(int index) const
+	{
+		return (words_[index / 64] >> (index % 64)) & 1;
+	}
+
+	/// Get the lowest ID at or above from which is in the set, or -1 if there isn't one
+	int next(int from) const
+	{
+		if (from < 0)
 		{
-			if (!valid_[i])
+			from = 0;
+		}
+		size_t word = from / 64;
+		if (word >= Words)
+		{
+			return -1;
+		}
+		uint64_t bits = words_[word] & (~uint64_t(0) << (from % 64));
+		while (bits == 0)
+		{
+			if (++word == Words)
 			{
-				return i;
+				return -1;
 			}
+			bits = words_[word];
 		}
-		return -1;
+		return int(word * 64) + countrZero(bits);
+	}
+
+	/// Get the lowest ID at or above from which isn't in the set, or -1 if there isn't one
+	int nextFree(int from) const
+	{
+		if (from < 0)
+		{
+			from = 0;
+		}
+		size_t word = from / 64;
+		if (word >= Words)
+		{
+			return -1;
+		}
+		uint64_t bits = ~words_[word] & (~uint64_t(0) << (from % 64));
+		while (bits == 0)
+		{
+			if (++word == Words)
+			{
+				return -1;
+			}
+			bits = ~words_[word];
+		}
+		// The unused bits of the last word are never set, so they can look free
+		const int index = int(word * 64) + countrZero(bits);
+		return index < int(Size) ? index : -1;
+	}
+
+private:
+	constexpr static const size_t Words = (Size + 63) / 64;
+
+	/// Index of the lowest set bit of a non-zero word, std::countr_zero without C++20
+	static int countrZero(uint64_t bits)
+	{
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_ARM64))
+		unsigned long index;
+		_BitScanForward64(&index, bits);
+		return int(index);
+#elif defined(_MSC_VER)
+		unsigned long index;
+		if (_BitScanForward(&index, uint32_t(bits)))
+		{
+			return int(index);
+		}
+		_BitScanForward(&index, uint32_t(bits >> 32));
+		return int(index) + 32;
+#else
+		return __builtin_ctzll(bits);
+#endif
+	}
+
+	StaticArray<uint64_t, Words> words_;
+};
+
+template <typename T, size_t Size>
+struct UniqueIDArray : public NoCopy
+{
+	int findFreeIndex(int from) const
+	{
+		return valid_.nextFree(from);
+	}
+
+	/// Get the lowest valid index at or above from, or -1 if there isn't one
+	int nextValid(int from) const
+	{
+		return valid_.next(from);
 	}
 
 	void add(int index)
@@ -114,7 +222,7 @@ struct UniqueIDArray : public NoCopy
 	}
 
 private:
-	StaticBitset<Size> valid_;
+	PoolIDSet<Size> valid_;
 	FlatPtrHashSet<T> entries_;
 };
 
@@ -324,6 +432,13 @@ struct StaticPoolStorageBase : public NoCopy
 		lowestFreeIndex_ = Lower;
 	}
 
+	/// Get the lowest ID at or above from with an entry, or -1 if there isn't one
+	int nextIndex(int from) const
+	{
+		const int index = allocated_.nextValid(toInternalIndex(std::max(from, int(Lower))));
+		return index < 0 ? -1 : fromInternalIndex(index);
+	}
+
 	/// Get the raw entries list
 	/// Don't use this for looping through entries. Use the custom iterators instead.
 	const FlatPtrHashSet<Interface>& _entries()
@@ -420,14 +535,14 @@ struct DynamicPoolStorageBase : public NoCopy
 
 	int findFreeIndex(int from)
 	{
-		for (int i = toInternalIndex(from); i < Capacity; ++i)
-		{
-			if (pool_[i] == nullptr)
-			{
-				return fromInternalIndex(i);
-			}
-		}
-		return fromInternalIndex(-1);
+		return fromInternalIndex(ids_.nextFree(toInternalIndex(from)));
+	}
+
+	/// Get the lowest ID at or above from with an entry, or -1 if there isn't one
+	int nextIndex(int from) const
+	{
+		const int index = ids_.next(toInternalIndex(std::max(from, int(Lower))));
+		return index < 0 ? -1 : fromInternalIndex(index);
 	}
 
 	template <class... Args>
@@ -442,6 +557,7 @@ struct DynamicPoolStorageBase : public NoCopy
 				++lowestFreeIndex_;
 			}
 			pool_[internalIdx] = new Type(std::forward<Args>(args)...);
+			ids_.set(internalIdx);
 			allocated_.add(*pool_[internalIdx]);
 			if constexpr (std::is_base_of<PoolIDProvider, Type>::value)
 			{
@@ -463,6 +579,7 @@ struct DynamicPoolStorageBase : public NoCopy
 			}
 			const int internalIdx = toInternalIndex(hint);
 			pool_[internalIdx] = new Type(std::forward<Args>(args)...);
+			ids_.set(internalIdx);
 			allocated_.add(*pool_[internalIdx]);
 			if constexpr (std::is_base_of<PoolIDProvider, Type>::value)
 			{
@@ -510,6 +627,7 @@ struct DynamicPoolStorageBase : public NoCopy
 		eventDispatcher_.dispatch(&PoolEventHandler<Interface>::onPoolEntryDestroyed, *pool_[index]);
 		delete pool_[index];
 		pool_[index] = nullptr;
+		ids_.reset(index);
 		return std::make_pair(true, it);
 	}
 
@@ -523,6 +641,7 @@ struct DynamicPoolStorageBase : public NoCopy
 			delete static_cast<Type*>(ptr);
 		}
 		pool_.fill(nullptr);
+		ids_.reset();
 		allocated_.clear();
 		lowestFreeIndex_ = Lower;
 	}
@@ -551,6 +670,8 @@ protected:
 	}
 
 	StaticArray<Type*, Capacity> pool_;
+	/// IDs in use, to walk the entries in ID order
+	PoolIDSet<Capacity> ids_;
 	UniqueEntryArray<Interface> allocated_;
 	int lowestFreeIndex_ = Lower;
 	/// Implementation of the pool event dispatcher
@@ -578,21 +699,97 @@ struct ImmediatePoolStorageLifetimeBase final : public PoolBase
 	}
 };
 
+/// A pool storage iterator which walks the entries in ID order and locks the current one like MarkedPoolIterator
+/// Advancing looks the next ID up in the storage, so entries can be created and released while iterating:
+/// released ones are skipped and ones created above the current ID are visited
+template <class Storage>
+class MarkedPoolStorageIterator
+{
+public:
+	using iterator_category = std::forward_iterator_tag;
+	using difference_type = std::ptrdiff_t;
+	using value_type = typename Storage::Interface*;
+	using pointer = value_type*;
+	using reference = value_type;
+
+	inline MarkedPoolStorageIterator(Storage& pool, int index)
+		: pool(pool)
+		, index(index)
+	{
+		lock();
+	}
+
+	inline MarkedPoolStorageIterator(const MarkedPoolStorageIterator<Storage>& other)
+		: pool(other.pool)
+		, index(other.index)
+	{
+		lock();
+	}
+
+	inline ~MarkedPoolStorageIterator()
+	{
+		unlock();
+	}
+
+	MarkedPoolStorageIterator<Storage>& operator=(const MarkedPoolStorageIterator<Storage>& other) = delete;
+
+	inline value_type operator*() const { return pool.get(index); }
+
+	/// Unlocking may release the current entry, only the ID is kept so that's fine
+	inline MarkedPoolStorageIterator<Storage>& operator++()
+	{
+		unlock();
+		index = pool.nextIndex(index + 1);
+		lock();
+		return *this;
+	}
+
+	inline friend bool operator==(const MarkedPoolStorageIterator<Storage>& a, const MarkedPoolStorageIterator<Storage>& b)
+	{
+		return a.index == b.index;
+	}
+
+	inline friend bool operator!=(const MarkedPoolStorageIterator<Storage>& a, const MarkedPoolStorageIterator<Storage>& b)
+	{
+		return a.index != b.index;
+	}
+
+private:
+	inline void lock()
+	{
+		if (index != -1)
+		{
+			pool.lock(index);
+		}
+	}
+
+	inline void unlock()
+	{
+		if (index != -1)
+		{
+			pool.unlock(index);
+		}
+	}
+
+	Storage& pool;
+	int index; ///< ID of the current entry, -1 at the end
+};
+
 template <class PoolBase, typename RefCountType = uint8_t>
 struct MarkedPoolStorageLifetimeBase final : public PoolBase
 {
-	using Iterator = MarkedPoolIterator<typename PoolBase::Interface, MarkedPoolStorageLifetimeBase<PoolBase, RefCountType>>;
+	using Iterator = MarkedPoolStorageIterator<MarkedPoolStorageLifetimeBase<PoolBase, RefCountType>>;
 
-	/// Return the begin iterator
+	/// Return the begin iterator, entries are visited in ID order
 	inline Iterator begin()
 	{
-		return Iterator(*this, PoolBase::_entries(), PoolBase::_entries().begin());
+		return Iterator(*this, PoolBase::nextIndex(PoolBase::Lower));
 	}
 
 	/// Return the end iterator
 	inline Iterator end()
 	{
-		return Iterator(*this, PoolBase::_entries(), PoolBase::_entries().end());
+		return Iterator(*this, -1);
 	}
 
 	MarkedPoolStorageLifetimeBase()
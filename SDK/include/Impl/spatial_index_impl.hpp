@@ -0,0 +1,461 @@
+#pragma once
+
+#include "../player.hpp"
+#include "../pool.hpp"
+#include "../types.hpp"
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+
+/* Implementation, NOT to be passed around */
+
+namespace Impl
+{
+
+/// A uniform grid of world-space cells split by virtual world
+/// Used to find entries near a point without scanning a whole pool
+template <typename T>
+struct SpatialIndex : public NoCopy
+{
+	/// The default cell edge length, roughly the default stream radius
+	constexpr static const float DefaultCellSize = 200.0f;
+
+	SpatialIndex(float cellSize = DefaultCellSize)
+		: cellSize_(cellSize)
+	{
+	}
+
+	/// Insert an entry or move it to the cell of its new position
+	/// Returns true if the entry changed cells
+	bool update(int id, T& entry, Vector3 pos, int vw)
+	{
+		const uint64_t key = cellKey(pos, vw);
+		auto it = slots_.find(id);
+		if (it != slots_.end())
+		{
+			Slot& slot = it->second;
+			if (slot.cell == key)
+			{
+				Item& item = cells_[key][slot.offset];
+				item.entry = &entry;
+				item.pos = pos;
+				return false;
+			}
+			unlink(slot);
+			link(id, slot, key, entry, pos);
+			return true;
+		}
+		link(id, slots_[id], key, entry, pos);
+		return true;
+	}
+
+	/// Remove an entry from the index if it's in it
+	void remove(int id)
+	{
+		auto it = slots_.find(id);
+		if (it == slots_.end())
+		{
+			return;
+		}
+		unlink(it->second);
+		slots_.erase(it);
+	}
+
+	bool contains(int id) const
+	{
+		return slots_.find(id) != slots_.end();
+	}
+
+	/// Get the position an entry was last indexed at
+	Vector3 getPosition(int id) const
+	{
+		auto it = slots_.find(id);
+		assert(it != slots_.end());
+		return cells_.find(it->second.cell)->second[it->second.offset].pos;
+	}
+
+	/// Check whether query() with the same arguments would visit the entry
+	bool inRange(int id, Vector3 pos, int vw, float radius) const
+	{
+		auto it = slots_.find(id);
+		if (it == slots_.end())
+		{
+			return false;
+		}
+		const uint64_t key = it->second.cell;
+		const int x = keyX(key);
+		const int y = keyY(key);
+		return keyWorld(key) == vw && x >= cellCoord(pos.x - radius) && x <= cellCoord(pos.x + radius) && y >= cellCoord(pos.y - radius) && y <= cellCoord(pos.y + radius);
+	}
+
+	void clear()
+	{
+		cells_.clear();
+		slots_.clear();
+	}
+
+	/// Call fn(T& entry, Vector3 pos) for every entry in the cells overlapping the square of half-size radius around pos
+	/// Candidates must still be distance checked; the index must not be modified from within fn
+	/// Returns the number of candidates visited
+	template <typename Fn>
+	size_t query(Vector3 pos, int vw, float radius, Fn fn) const
+	{
+		const int minX = cellCoord(pos.x - radius);
+		const int maxX = cellCoord(pos.x + radius);
+		const int minY = cellCoord(pos.y - radius);
+		const int maxY = cellCoord(pos.y + radius);
+		size_t visited = 0;
+
+		// With a radius spanning more cells than are occupied it's cheaper to walk the occupied ones
+		if (size_t(maxX - minX + 1) * size_t(maxY - minY + 1) > cells_.size())
+		{
+			for (const auto& cell : cells_)
+			{
+				if (keyWorld(cell.first) != vw)
+				{
+					continue;
+				}
+				const int x = keyX(cell.first);
+				const int y = keyY(cell.first);
+				if (x < minX || x > maxX || y < minY || y > maxY)
+				{
+					continue;
+				}
+				visited += visit(cell.second, fn);
+			}
+			return visited;
+		}
+
+		for (int x = minX; x <= maxX; ++x)
+		{
+			for (int y = minY; y <= maxY; ++y)
+			{
+				auto it = cells_.find(makeKey(vw, x, y));
+				if (it != cells_.end())
+				{
+					visited += visit(it->second, fn);
+				}
+			}
+		}
+		return visited;
+	}
+
+private:
+	struct Item
+	{
+		T* entry;
+		Vector3 pos;
+		int id;
+	};
+
+	struct Slot
+	{
+		uint64_t cell;
+		uint32_t offset; ///< Position of the entry in its cell's list
+	};
+
+	template <typename Fn>
+	static size_t visit(const DynamicArray<Item>& cell, Fn& fn)
+	{
+		for (const Item& item : cell)
+		{
+			fn(*item.entry, item.pos);
+		}
+		return cell.size();
+	}
+
+	void link(int id, Slot& slot, uint64_t key, T& entry, Vector3 pos)
+	{
+		DynamicArray<Item>& cell = cells_[key];
+		slot.cell = key;
+		slot.offset = cell.size();
+		cell.push_back(Item { &entry, pos, id });
+	}
+
+	void unlink(const Slot& slot)
+	{
+		auto it = cells_.find(slot.cell);
+		assert(it != cells_.end());
+		DynamicArray<Item>& cell = it->second;
+
+		// Swap-remove and fix up the offset of the moved entry
+		const Item& last = cell.back();
+		slots_[last.id].offset = slot.offset;
+		cell[slot.offset] = last;
+		cell.pop_back();
+
+		if (cell.empty())
+		{
+			cells_.erase(it);
+		}
+	}
+
+	int cellCoord(float v) const
+	{
+		const float c = std::floor(v / cellSize_);
+		// Also catches NaN from bad sync data
+		if (!(c >= float(INT16_MIN)))
+		{
+			return INT16_MIN;
+		}
+		if (c > float(INT16_MAX))
+		{
+			return INT16_MAX;
+		}
+		return int(c);
+	}
+
+	uint64_t cellKey(Vector3 pos, int vw) const
+	{
+		return makeKey(vw, cellCoord(pos.x), cellCoord(pos.y));
+	}
+
+	static uint64_t makeKey(int vw, int x, int y)
+	{
+		return (uint64_t(uint32_t(vw)) << 32) | (uint64_t(uint16_t(x)) << 16) | uint64_t(uint16_t(y));
+	}
+
+	static int keyWorld(uint64_t key)
+	{
+		return int(uint32_t(key >> 32));
+	}
+
+	static int keyX(uint64_t key)
+	{
+		return int16_t(uint16_t(key >> 16));
+	}
+
+	static int keyY(uint64_t key)
+	{
+		return int16_t(uint16_t(key));
+	}
+
+	float cellSize_;
+	FlatHashMap<int, Slot> slots_;
+	FlatHashMap<uint64_t, DynamicArray<Item>> cells_;
+};
+
+/// Entries waiting to be streamed in for a player, streamed nearest first within a budget
+template <typename Key>
+struct StreamInQueue : public NoCopy
+{
+	void push(Key key, float distanceSqr)
+	{
+		entries_.emplace_back(distanceSqr, key);
+	}
+
+	bool empty() const
+	{
+		return entries_.empty();
+	}
+
+	/// Call fn(key) for up to limit of the nearest entries, nearest first, then clear the queue
+	/// Returns true if the limit left entries out
+	template <typename Fn>
+	bool streamNearest(size_t limit, Fn fn)
+	{
+		auto nearer = [](const Pair<float, Key>& a, const Pair<float, Key>& b)
+		{
+			return a.first < b.first;
+		};
+
+		const size_t count = std::min(limit, entries_.size());
+		const bool truncated = count != entries_.size();
+		if (truncated)
+		{
+			std::nth_element(entries_.begin(), entries_.begin() + count, entries_.end(), nearer);
+		}
+		std::sort(entries_.begin(), entries_.begin() + count, nearer);
+
+		// Handlers called by fn may stream for other players and call this again, so the entries are moved to a buffer taken out of the member
+		// A nested call finds the member empty and allocates its own
+		DynamicArray<Pair<float, Key>> pending;
+		pending.swap(spare_);
+		pending.assign(entries_.begin(), entries_.begin() + count);
+		entries_.clear();
+		for (const Pair<float, Key>& entry : pending)
+		{
+			fn(entry.second);
+		}
+		pending.clear();
+		spare_.swap(pending);
+		return truncated;
+	}
+
+private:
+	DynamicArray<Pair<float, Key>> entries_;
+	DynamicArray<Pair<float, Key>> spare_; ///< Kept between calls to reuse its allocation
+};
+
+/// A spatial index of a pool's entries for streaming them to players
+/// Add it to the pool's event dispatcher so entries are indexed when created and dropped when destroyed,
+/// then call update() when an entry moves and streamedIn() when it's streamed in for a player
+template <class Interface>
+struct PoolStreamIndex final : public PoolEventHandler<Interface>, public NoCopy
+{
+	/// The virtual world of entries visible in all worlds
+	constexpr static const int AllWorlds = -1;
+
+	void onPoolEntryCreated(Interface& entry) override
+	{
+		update(entry);
+	}
+
+	void onPoolEntryDestroyed(Interface& entry) override
+	{
+		const int id = entry.getID();
+		grid_.remove(id);
+		unlocated_.erase(id);
+	}
+
+	/// Re-index an entry after its position or virtual world changed
+	/// Entries without a position of their own (e.g. attached to another entity) are checked separately, see forEachCandidate()
+	void update(Interface& entry, bool located = true)
+	{
+		const int id = entry.getID();
+		// Not in the pool yet, it's indexed by onPoolEntryCreated
+		if (id < 0)
+		{
+			return;
+		}
+		if (located)
+		{
+			unlocated_.erase(id);
+			grid_.update(id, entry, entry.getPosition(), entry.getVirtualWorld());
+		}
+		else
+		{
+			grid_.remove(id);
+			unlocated_.insert(id);
+		}
+	}
+
+	/// Record that an entry was streamed in for a player so it's checked for streaming out
+	void streamedIn(const IPlayer& player, int id)
+	{
+		streamed_[player.getID()].insert(id);
+	}
+
+	/// Queue an entry to be streamed in for the player being updated by streamInNearest()
+	void queueStreamIn(Interface& entry, float distanceSqr)
+	{
+		streamInQueue_.push(entry.getID(), distanceSqr);
+	}
+
+	/// Call fn(entry) for up to limit of the nearest queued entries, nearest first, locking each like forEachCandidate
+	/// Returns true if the limit left entries out
+	template <class Pool, class Fn>
+	bool streamInNearest(Pool& pool, size_t limit, Fn fn)
+	{
+		return streamInQueue_.streamNearest(limit, [&pool, &fn](int id)
+			{
+				auto entry = pool.get(id);
+				if (entry)
+				{
+					pool.lock(id);
+					fn(*entry);
+					pool.unlock(id);
+				}
+			});
+	}
+
+	/// Forget everything streamed in for a player, call on disconnect
+	void removePlayer(const IPlayer& player)
+	{
+		streamed_[player.getID()].clear();
+	}
+
+	/// Call fn(entry) for every entry of the pool that may need its stream state changed for a player:
+	/// entries in the cells around pos in vw or in all worlds, entries without a position, and entries currently streamed in for the player
+	/// Each entry is locked while fn runs, like when iterating the pool; candidates must still be distance checked
+	/// Returns the number of candidates
+	template <class Pool, class Fn>
+	size_t forEachCandidate(Pool& pool, IPlayer& player, Vector3 pos, int vw, float radius, Fn fn)
+	{
+		return forEachCandidate(pool, player, pos, vw, radius, fn, [pos](Interface&)
+			{
+				return pos;
+			});
+	}
+
+	/// Like forEachCandidate() above, but entries without a position of their own are only candidates when streamed in for the player
+	/// or when locate(entry), e.g. the position of the entity they're attached to, is in the cells around pos
+	template <class Pool, class Fn, class Locate>
+	size_t forEachCandidate(Pool& pool, IPlayer& player, Vector3 pos, int vw, float radius, Fn fn, Locate locate)
+	{
+		// fn may stream for other players and call this again, so the candidates are collected in a buffer taken out of the member
+		// A nested call finds the member empty and allocates its own
+		DynamicArray<int> candidates;
+		candidates.swap(spare_);
+		auto collect = [&candidates](Interface& entry, Vector3)
+		{
+			candidates.push_back(entry.getID());
+		};
+		grid_.query(pos, vw, radius, collect);
+		if (vw != AllWorlds)
+		{
+			grid_.query(pos, AllWorlds, radius, collect);
+		}
+
+		for (int id : unlocated_)
+		{
+			auto entry = pool.get(id);
+			if (entry == nullptr)
+			{
+				continue;
+			}
+			if (entry->isStreamedInForPlayer(player))
+			{
+				candidates.push_back(id);
+				continue;
+			}
+			const Vector3 located = locate(*entry);
+			if (std::abs(located.x - pos.x) <= radius && std::abs(located.y - pos.y) <= radius)
+			{
+				candidates.push_back(id);
+			}
+		}
+
+		// Entries streamed in from outside the queried cells, dropping the ones which were streamed out since
+		FlatHashSet<int>& streamed = streamed_[player.getID()];
+		for (auto it = streamed.begin(); it != streamed.end();)
+		{
+			const int id = *it;
+			auto entry = pool.get(id);
+			if (entry == nullptr || !entry->isStreamedInForPlayer(player))
+			{
+				it = streamed.erase(it);
+				continue;
+			}
+			if (unlocated_.find(id) == unlocated_.end() && !grid_.inRange(id, pos, vw, radius) && !grid_.inRange(id, pos, AllWorlds, radius))
+			{
+				candidates.push_back(id);
+			}
+			++it;
+		}
+
+		const size_t count = candidates.size();
+		for (int id : candidates)
+		{
+			auto entry = pool.get(id);
+			if (entry)
+			{
+				pool.lock(id);
+				fn(*entry);
+				pool.unlock(id);
+			}
+		}
+		candidates.clear();
+		spare_.swap(candidates);
+		return count;
+	}
+
+private:
+	SpatialIndex<Interface> grid_;
+	FlatHashSet<int> unlocated_;
+	StaticArray<FlatHashSet<int>, PLAYER_POOL_SIZE> streamed_;
+	DynamicArray<int> spare_; ///< Kept between calls to reuse its allocation
+	StreamInQueue<int> streamInQueue_;
+};
+
+}
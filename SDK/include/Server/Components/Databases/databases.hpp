@@ -10,6 +10,59 @@ struct LegacyDBResult
 	char** results;
 };
 
+/// A value bound to a parameter of a prepared query
+struct DatabaseParameter
+{
+	enum class Type
+	{
+		Null,
+		Integer,
+		Float,
+		Text
+	};
+
+	Type type;
+	int64_t integer;
+	double floating;
+	StringView text; ///< Only has to stay valid until the query returns
+
+	DatabaseParameter()
+		: type(Type::Null)
+		, integer(0)
+		, floating(0.0)
+	{
+	}
+
+	DatabaseParameter(int value)
+		: type(Type::Integer)
+		, integer(value)
+		, floating(0.0)
+	{
+	}
+
+	DatabaseParameter(int64_t value)
+		: type(Type::Integer)
+		, integer(value)
+		, floating(0.0)
+	{
+	}
+
+	DatabaseParameter(double value)
+		: type(Type::Float)
+		, integer(0)
+		, floating(value)
+	{
+	}
+
+	DatabaseParameter(StringView value)
+		: type(Type::Text)
+		, integer(0)
+		, floating(0.0)
+		, text(value)
+	{
+	}
+};
+
 struct IDatabaseResultSetRow
 {
 
@@ -116,6 +169,21 @@ struct IDatabaseResultSet : public IExtensible, public IIDProvider
 	virtual LegacyDBResult& getLegacyDBResult() = 0;
 };
 
+struct IDatabaseConnection;
+
+/// Receives the result of a query executed in the background, called from the main thread
+struct DatabaseQueryHandler
+{
+	/// Called when the query has been executed
+	/// @param connection The connection the query was executed on
+	/// @param resultSet Result set, "nullptr" if the query failed; freed after this returns so it mustn't be freed or kept
+	virtual void onDatabaseQueryExecuted(IDatabaseConnection& connection, IDatabaseResultSet* resultSet) = 0;
+
+	/// Called instead of onDatabaseQueryExecuted when the connection is closed before the result could be delivered
+	/// @param connection The connection being closed
+	virtual void onDatabaseQueryCancelled(IDatabaseConnection& connection) { }
+};
+
 struct IDatabaseConnection : public IExtensible, public IIDProvider
 {
 
@@ -127,6 +195,22 @@ struct IDatabaseConnection : public IExtensible, public IIDProvider
 	/// @param query Query to execute
 	/// @returns Result set
 	virtual IDatabaseResultSet* executeQuery(StringView query) = 0;
+
+	/// Executes a single query with its ? parameters bound in order to the specified values
+	/// The compiled query is cached by the connection and reused the next time the same query text is executed
+	/// @param query Query to execute
+	/// @param parameters Parameter values
+	/// @returns Result set
+	virtual IDatabaseResultSet* executePreparedQuery(StringView query, Span<const DatabaseParameter> parameters) = 0;
+
+	/// Executes a query on the connection's background thread, queries are executed in the order they're queued
+	/// Parameters work like executePreparedQuery, their text is copied so it only has to stay valid for this call
+	/// Closing the connection waits for queued queries to be executed and cancels the results which weren't delivered yet
+	/// @param query Query to execute
+	/// @param parameters Parameter values
+	/// @param handler Handler called from the main thread once the query has been executed
+	/// @returns "true" if the query has been queued, otherwise "false"
+	virtual bool executeQueryAsync(StringView query, Span<const DatabaseParameter> parameters, DatabaseQueryHandler* handler) = 0;
 };
 
 static const UID DatabasesComponent_UID = UID(0x80092e7eb5821a96 /*0x80092e7eb5821a969640def7747a231a*/);
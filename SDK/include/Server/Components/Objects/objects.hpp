@@ -253,6 +253,11 @@ struct ObjectEventHandler
 	virtual void onObjectEdited(IPlayer& player, IObject& object, ObjectEditResponse response, Vector3 offset, Vector3 rotation) { }
 	virtual void onPlayerObjectEdited(IPlayer& player, IPlayerObject& object, ObjectEditResponse response, Vector3 offset, Vector3 rotation) { }
 	virtual void onPlayerAttachedObjectEdited(IPlayer& player, int index, bool saved, const ObjectAttachmentSlotData& data) { }
+
+	/// Called once every global object which existed when the player connected (or finished downloading custom models) has been created for them
+	/// Creation is spread over ticks according to network.object_creation_budget, nearest to the player's spawn first
+	/// With network.use_object_streamer it's called straight away, objects are then created as the player comes within network.object_stream_radius of them
+	virtual void onPlayerGlobalObjectsCreated(IPlayer& player) { }
 };
 
 static const UID PlayerObjectData_UID = UID(0x93d4ed2344b07456);
@@ -142,7 +142,7 @@ struct ITextDrawBase : public IExtensible, public IIDProvider
 	/// Get the textdraw's preview zoom factor
 	virtual float getPreviewZoom() const = 0;
 
-	/// Restream the textdraw
+	/// Show the textdraw again to the players it's shown for, sent once at the end of the tick however many times it's called
 	virtual void restream() = 0;
 };
 
@@ -159,6 +159,12 @@ struct ITextDraw : public ITextDrawBase
 
 	/// Set the textdraw's text for one player
 	virtual void setTextForPlayer(IPlayer& player, StringView text) = 0;
+
+	/// Show the textdraw for several players, sending them all the same encoded packet
+	virtual void showForPlayers(const FlatPtrHashSet<IPlayer>& players) = 0;
+
+	/// Hide the textdraw for several players, sending them all the same encoded packet
+	virtual void hideForPlayers(const FlatPtrHashSet<IPlayer>& players) = 0;
 };
 
 struct IPlayerTextDraw : public ITextDrawBase
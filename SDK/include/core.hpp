@@ -4,6 +4,7 @@
 #include "events.hpp"
 #include "network.hpp"
 #include "player.hpp"
+#include "profiler.hpp"
 #include "types.hpp"
 #include "values.hpp"
 
@@ -80,12 +81,14 @@ struct IConfig : public IExtensible
 	virtual size_t getBansCount() const = 0;
 
 	/// Get a list of banned addresses
+	/// The order isn't kept when bans are removed, see removeBan()
 	virtual const BanEntry& getBan(size_t index) const = 0;
 
 	/// Add a ban
 	virtual void addBan(const BanEntry& entry) = 0;
 
 	/// Remove a ban
+	/// The last ban takes its index, so iterate backwards when removing bans by index
 	virtual void removeBan(size_t index) = 0;
 
 	/// Remove a ban
@@ -101,6 +104,7 @@ struct IConfig : public IExtensible
 	virtual void clearBans() = 0;
 
 	/// Check if ban entry is banned
+	/// Its address is matched against every ban, including IPv4 ranges in CIDR notation (1.2.3.0/24) and wildcards (1.2.*.*)
 	virtual bool isBanned(const BanEntry& entry) const = 0;
 
 	/// Get an option name from an alias if available
@@ -356,6 +360,8 @@ struct ICore : public IExtensible, public ILogger
 /// Helper class to get streamer config properties
 struct StreamConfigHelper
 {
+	float getDistance() const { return *distance; }
+
 	float getDistanceSqr() const
 	{
 		const float dist = *distance;
@@ -363,9 +369,16 @@ struct StreamConfigHelper
 	}
 	int getRate() const { return *rate; }
 
+	/// Get the maximum number of entities of one type to stream in for a player per update, nearest first
+	size_t getStreamInBudget() const
+	{
+		return (budget && *budget > 0) ? size_t(*budget) : SIZE_MAX;
+	}
+
 	StreamConfigHelper()
 		: distance(nullptr)
 		, rate(nullptr)
+		, budget(nullptr)
 		, last()
 	{
 	}
@@ -373,6 +386,7 @@ struct StreamConfigHelper
 	StreamConfigHelper(IConfig& config)
 		: distance(config.getFloat("network.stream_radius"))
 		, rate(config.getInt("network.stream_rate"))
+		, budget(config.getInt("network.stream_in_budget"))
 	{
 	}
 
@@ -386,8 +400,16 @@ struct StreamConfigHelper
 		return false;
 	}
 
+	/// Stream for a player on their next update instead of waiting for the stream rate
+	/// Used when the stream in budget left entities waiting
+	void requestStream(int pid)
+	{
+		last[pid] = TimePoint();
+	}
+
 private:
 	float* distance;
 	int* rate;
+	int* budget;
 	StaticArray<TimePoint, PLAYER_POOL_SIZE> last;
 };
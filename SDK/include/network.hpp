@@ -348,6 +348,13 @@ struct INetwork : public IExtensible
 
 	/// Update server parameters
 	virtual void update() = 0;
+
+	/// Attempt to send the same packet to several network peers, dispatching send events for each of them like sendPacket
+	/// Peers which aren't on this network are skipped, as are peers a send event handler returned false for
+	/// @param peers The network peers to send the packet to
+	/// @param data The data span with the length in BITS
+	/// @param dispatchEvents If calling sendPacketToMany should dispatch send events or not
+	virtual bool sendPacketToMany(Span<IPlayer* const> peers, Span<uint8_t> data, int channel, bool dispatchEvents = true) = 0;
 };
 
 /// A component interface which allows for writing a network component
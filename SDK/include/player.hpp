@@ -448,6 +448,10 @@ enum EPlayerNameStatus
 	Invalid ///< The name is invalid
 };
 
+/// The most player extensions which can be given a slot with IPlayerPool::registerExtensionSlot
+/// A slotted extension is kept in its own slot on the player so querying it is an array read instead of a hash map lookup
+static constexpr int PlayerExtensionSlotCount = 32;
+
 /// A player interface
 struct IPlayer : public IExtensible, public IEntity
 {
@@ -919,8 +923,40 @@ struct IPlayer : public IExtensible, public IEntity
 
 	/// Check if player is using an official client or not
 	virtual bool isUsingOfficialClient() const = 0;
+
+	/// Get the extension in a slot registered with IPlayerPool::registerExtensionSlot, or nullptr if it wasn't added
+	/// Don't call directly, use global queryExtension() instead
+	virtual IExtension* getExtensionInSlot(int slot) = 0;
+
+	/// Get the slot registered for an extension UID, or -1 if it doesn't have one
+	virtual int getExtensionSlot(UID id) const = 0;
 };
 
+/// Query an extension of a player by its type
+/// Extensions with a registered slot are read from it, any other is looked up by UID
+/// @typeparam ExtensionT The extension type, must derive from IExtension
+template <class ExtensionT>
+ExtensionT* queryExtension(IPlayer& player)
+{
+	static_assert(std::is_base_of<IExtension, ExtensionT>::value, "queryExtension parameter must inherit from IExtension");
+
+	// Looked up once per type, slots are registered in onLoad and players only exist once every component has loaded
+	static const int slot = player.getExtensionSlot(ExtensionT::ExtensionIID);
+	if (slot != -1)
+	{
+		return static_cast<ExtensionT*>(player.getExtensionInSlot(slot));
+	}
+	return player._queryExtension<ExtensionT>();
+}
+
+/// Query an extension of a player by its type
+/// @typeparam ExtensionT The extension type, must derive from IExtension
+template <class ExtensionT>
+ExtensionT* queryExtension(IPlayer* player)
+{
+	return queryExtension<ExtensionT>(*player);
+}
+
 /// Player spawn event handlers
 struct PlayerSpawnEventHandler
 {
@@ -1079,4 +1115,9 @@ struct IPlayerPool : public IExtensible, public IReadOnlyPool<IPlayer>
 
 	/// Get the colour assigned to a player ID when it first connects.
 	virtual Colour getDefaultColour(int pid) const = 0;
+
+	/// Give a player extension its own slot on every player so queryExtension reads it without a hash map lookup
+	/// Call it in IComponent::onLoad for an extension added to most players, registering a UID again returns its slot
+	/// @return The slot, or -1 if all PlayerExtensionSlotCount slots are taken and the extension is looked up by UID
+	virtual int registerExtensionSlot(UID id) = 0;
 };
@@ -0,0 +1,49 @@
+#pragma once
+
+#include "component.hpp"
+#include "types.hpp"
+
+static const UID TickProfilerExtension_UID = UID(0x5a3c0e9b27d14f68);
+
+/// Timings of the core loop, event dispatching and packet handling, provided by the core as an extension
+/// Query it once on load and only time anything while isProfiling() returns true
+struct ITickProfilerExtension : public IExtension
+{
+	PROVIDE_EXT_UID(TickProfilerExtension_UID);
+
+	/// Check whether timings are currently being recorded
+	virtual bool isProfiling() const = 0;
+
+	/// Get the ID of a named section, creating it if it doesn't exist yet
+	virtual int getSection(StringView name) = 0;
+
+	/// Record one run of a section which took the given time
+	virtual void record(int section, Microseconds time) = 0;
+};
+
+/// Times the scope it's declared in into a profiler section, does nothing if the profiler is missing or not profiling
+struct ProfileScope : public NoCopy
+{
+	ProfileScope(ITickProfilerExtension* profiler, int section)
+		: profiler_((profiler && profiler->isProfiling()) ? profiler : nullptr)
+		, section_(section)
+	{
+		if (profiler_)
+		{
+			start_ = Time::now();
+		}
+	}
+
+	~ProfileScope()
+	{
+		if (profiler_)
+		{
+			profiler_->record(section_, duration_cast<Microseconds>(Time::now() - start_));
+		}
+	}
+
+private:
+	ITickProfilerExtension* profiler_;
+	int section_;
+	TimePoint start_;
+};
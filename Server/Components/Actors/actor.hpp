@@ -7,6 +7,7 @@
  */
 
 #include <Impl/pool_impl.hpp>
+#include <Impl/spatial_index_impl.hpp>
 #include <Server/Components/Actors/actors.hpp>
 #include <Server/Components/CustomModels/custommodels.hpp>
 #include <Server/Components/Fixes/fixes.hpp>
@@ -48,6 +49,7 @@ private:
 	bool* validateAnimations_;
 	ICustomModelsComponent*& modelsComponent_;
 	IFixesComponent* fixesComponent_;
+	PoolStreamIndex<IActor>& streamIndex_;
 
 	void restream()
 	{
@@ -103,7 +105,7 @@ public:
 		}
 	}
 
-	Actor(int skin, Vector3 pos, float angle, bool* allAnimationLibraries, bool* validateAnimations, ICustomModelsComponent*& modelsComponent, IFixesComponent* fixesComponent)
+	Actor(PoolStreamIndex<IActor>& streamIndex, int skin, Vector3 pos, float angle, bool* allAnimationLibraries, bool* validateAnimations, ICustomModelsComponent*& modelsComponent, IFixesComponent* fixesComponent)
 		: virtualWorld_(0)
 		, skin_(skin)
 		, invulnerable_(true)
@@ -116,6 +118,7 @@ public:
 		, validateAnimations_(validateAnimations)
 		, modelsComponent_(modelsComponent)
 		, fixesComponent_(fixesComponent)
+		, streamIndex_(streamIndex)
 	{
 	}
 
@@ -216,6 +219,7 @@ public:
 				{
 					++actor_data->numStreamed;
 					streamedFor_.add(pid, player);
+					streamIndex_.streamedIn(player, poolID);
 					streamInForClient(player);
 				}
 			}
@@ -245,6 +249,7 @@ public:
 	void setVirtualWorld(int vw) override
 	{
 		virtualWorld_ = vw;
+		streamIndex_.update(*this);
 	}
 
 	int getID() const override
@@ -260,6 +265,7 @@ public:
 	void setPosition(Vector3 position) override
 	{
 		pos_ = position;
+		streamIndex_.update(*this);
 
 		NetCode::RPC::SetActorPosForPlayer RPC;
 		RPC.ActorID = poolID;
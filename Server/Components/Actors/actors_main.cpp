@@ -13,6 +13,8 @@ class ActorsComponent final : public IActorsComponent, public PlayerConnectEvent
 {
 private:
 	ICore* core = nullptr;
+	/// Declared before the storage so it outlives the entries it indexes
+	PoolStreamIndex<IActor> streamIndex;
 	MarkedPoolStorage<Actor, IActor, 0, ACTOR_POOL_SIZE> storage;
 	DefaultEventDispatcher<ActorEventHandler> eventDispatcher;
 	IPlayerPool* players;
@@ -81,6 +83,7 @@ public:
 		: players(nullptr)
 		, playerDamageActorEventHandler(*this)
 	{
+		storage.getEventDispatcher().addEventHandler(&streamIndex);
 	}
 
 	void onLoad(ICore* core) override
@@ -88,6 +91,7 @@ public:
 		this->core = core;
 		players = &core->getPlayers();
 		players->getPlayerConnectDispatcher().addEventHandler(this);
+		players->registerExtensionSlot(PlayerActorData::ExtensionIID);
 		players->getPlayerUpdateDispatcher().addEventHandler(this);
 		players->getPoolEventDispatcher().addEventHandler(this);
 		NetCode::RPC::OnPlayerDamageActor::addEventHandler(*core, &playerDamageActorEventHandler);
@@ -135,11 +139,12 @@ public:
 		{
 			static_cast<Actor*>(a)->removeFor(pid, player);
 		}
+		streamIndex.removePlayer(player);
 	}
 
 	IActor* create(int skin, Vector3 pos, float angle) override
 	{
-		return storage.emplace(skin, pos, angle, core->getConfig().getBool("game.use_all_animations"), core->getConfig().getBool("game.validate_animations"), modelsComponent, fixesComponent_);
+		return storage.emplace(streamIndex, skin, pos, angle, core->getConfig().getBool("game.use_all_animations"), core->getConfig().getBool("game.validate_animations"), modelsComponent, fixesComponent_);
 	}
 
 	void free() override
@@ -208,33 +213,50 @@ public:
 		const float maxDist = streamConfigHelper.getDistanceSqr();
 		if (streamConfigHelper.shouldStream(player.getID(), now))
 		{
-			for (IActor* a : storage)
-			{
-				Actor* actor = static_cast<Actor*>(a);
-
-				const PlayerState state = player.getState();
-				const Vector2 dist2D = actor->getPosition() - player.getPosition();
-				const bool shouldBeStreamedIn = state != PlayerState_None && (player.getVirtualWorld() == actor->getVirtualWorld() || actor->getVirtualWorld() == -1) && glm::dot(dist2D, dist2D) < maxDist;
-
-				const bool isStreamedIn = actor->isStreamedInForPlayer(player);
-				if (!isStreamedIn && shouldBeStreamedIn)
+			const PlayerState state = player.getState();
+			const Vector3 pos = player.getPosition();
+			const int vw = player.getVirtualWorld();
+			streamIndex.forEachCandidate(storage, player, pos, vw, streamConfigHelper.getDistance(), [&](IActor& a)
 				{
-					actor->streamInForPlayer(player);
-					ScopedPoolReleaseLock<IActor> lock(*this, *actor);
-					eventDispatcher.dispatch(
-						&ActorEventHandler::onActorStreamIn,
-						*lock.entry,
-						player);
-				}
-				else if (isStreamedIn && !shouldBeStreamedIn)
+					Actor& actor = static_cast<Actor&>(a);
+
+					const Vector2 dist2D = actor.getPosition() - pos;
+					const float distSqr = glm::dot(dist2D, dist2D);
+					const bool shouldBeStreamedIn = state != PlayerState_None && (vw == actor.getVirtualWorld() || actor.getVirtualWorld() == -1) && distSqr < maxDist;
+
+					const bool isStreamedIn = actor.isStreamedInForPlayer(player);
+					if (!isStreamedIn && shouldBeStreamedIn)
+					{
+						streamIndex.queueStreamIn(actor, distSqr);
+					}
+					else if (isStreamedIn && !shouldBeStreamedIn)
+					{
+						actor.streamOutForPlayer(player);
+						ScopedPoolReleaseLock<IActor> lock(*this, actor);
+						eventDispatcher.dispatch(
+							&ActorEventHandler::onActorStreamOut,
+							*lock.entry,
+							player);
+					}
+				});
+
+			PlayerActorData* data = queryExtension<PlayerActorData>(player);
+			const int numStreamed = data ? data->numStreamed : MAX_STREAMED_ACTORS;
+			const size_t room = size_t(std::max(MAX_STREAMED_ACTORS - numStreamed, 0));
+			const size_t budget = streamConfigHelper.getStreamInBudget();
+			const bool waiting = streamIndex.streamInNearest(storage, std::min(budget, room), [&](IActor& a)
 				{
-					actor->streamOutForPlayer(player);
-					ScopedPoolReleaseLock<IActor> lock(*this, *actor);
+					Actor& actor = static_cast<Actor&>(a);
+					actor.streamInForPlayer(player);
+					ScopedPoolReleaseLock<IActor> lock(*this, actor);
 					eventDispatcher.dispatch(
-						&ActorEventHandler::onActorStreamOut,
+						&ActorEventHandler::onActorStreamIn,
 						*lock.entry,
 						player);
-				}
+				});
+			if (waiting && budget < room)
+			{
+				streamConfigHelper.requestStream(player.getID());
 			}
 		}
 
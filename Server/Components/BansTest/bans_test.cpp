@@ -0,0 +1,333 @@
+/*
+ *  This Source Code Form is subject to the terms of the Mozilla Public License,
+ *  v. 2.0. If a copy of the MPL was not distributed with this file, You can
+ *  obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ *  The original code is copyright (c) 2022, open.mp team and contributors.
+ */
+
+#include "../../Source/ban_store.hpp"
+#include <Impl/ban_index_impl.hpp>
+#include <random>
+#include <sdk.hpp>
+#include <set>
+
+using namespace Impl;
+
+/// Directory the ban store is tested in, so the server's own bans file is never touched
+const char* testBansDirectory("bans_test/");
+
+/// Rounds of random bans checked against matching every ban one by one
+const int testIndexRounds(200);
+
+/// Changes made to the tested ban store, enough for it to compact its journal a few times
+const int testStoreChanges(3000);
+
+/// Checks the ban index against matching every ban one by one, and the ban store's journal, replay and compaction
+struct BansTestComponent final : public IComponent, public NoCopy
+{
+	/// Core
+	ICore* core = nullptr;
+
+	/// Failed checks
+	int errors = 0;
+
+	/// Random bans and addresses, seeded so every run checks the same ones
+	std::mt19937 random { 1 };
+
+	/// Gets the component UID
+	/// @returns Component UID
+	UID getUID() override
+	{
+		return 0x5d4e2a9b17c3f860;
+	}
+
+	/// Gets the component name
+	/// @returns Component name
+	StringView componentName() const override
+	{
+		return "Bans test";
+	}
+
+	/// Gets the component type
+	/// @returns Component type
+	ComponentType componentType() const override
+	{
+		return ComponentType::Other;
+	}
+
+	/// Gets the component version
+	/// @return Component version
+	SemanticVersion componentVersion() const override
+	{
+		return SemanticVersion(OMP_VERSION_MAJOR, OMP_VERSION_MINOR, OMP_VERSION_PATCH, BUILD_NUMBER);
+	}
+
+	/// Called for every component after components have been loaded
+	/// @param c Core
+	void onLoad(ICore* c) override
+	{
+		core = c;
+	}
+
+	/// Runs the checks, none of them touch the server's own bans
+	void onReady() override
+	{
+		testIndex();
+		testIndexAgainstEveryBan();
+		testStore();
+
+		if (errors)
+		{
+			core->printLn("[ERROR] Bans test: %d checks failed.", errors);
+		}
+		else
+		{
+			core->printLn("Bans test passed");
+		}
+	}
+
+	/// Counts a failed check
+	/// @param condition Checked condition
+	/// @param description What was checked
+	void check(bool condition, const char* description)
+	{
+		if (!condition)
+		{
+			core->printLn("[ERROR] Bans test: %s", description);
+			++errors;
+		}
+	}
+
+	/// Tests exact addresses, CIDR ranges and wildcards
+	void testIndex()
+	{
+		BanIndex index;
+		check(index.insert("10.0.0.0/8", 0), "Inserting a range failed.");
+		check(!index.insert("10.0.0.0/8", 1), "Inserting a range twice succeeded.");
+		check(index.insert("192.168.*.*", 1), "Inserting trailing wildcards failed.");
+		check(index.insert("1.*.0.1", 2), "Inserting a wildcard in the middle failed.");
+		check(index.insert("5.6.7.8", 3), "Inserting an address failed.");
+		check(index.matches("10.200.3.4"), "An address in a range isn't banned.");
+		check(!index.matches("11.0.0.1"), "An address outside of a range is banned.");
+		check(index.matches("192.168.44.1"), "An address matching trailing wildcards isn't banned.");
+		check(!index.matches("192.169.0.1"), "An address not matching trailing wildcards is banned.");
+		check(index.matches("1.99.0.1"), "An address matching a wildcard in the middle isn't banned.");
+		check(!index.matches("1.99.0.2"), "An address not matching a wildcard in the middle is banned.");
+		check(index.matches("5.6.7.8"), "A banned address isn't banned.");
+		check(index.find("192.168.*.*") == 1, "A ban wasn't found by its pattern.");
+		check(index.erase("10.0.0.0/8") == 0, "Erasing a range didn't return its index.");
+		check(!index.matches("10.200.3.4"), "An address in an erased range is banned.");
+		check(index.insert("0.0.0.0/0", 4), "Inserting the range of every address failed.");
+		check(index.matches("200.1.2.3"), "The range of every address doesn't ban everyone.");
+	}
+
+	/// Gets a random octet, kept small so patterns and addresses often match
+	String randomOctet()
+	{
+		return std::to_string(random() % 4);
+	}
+
+	/// Gets a random address, range or wildcard pattern
+	String randomPattern()
+	{
+		switch (random() % 6)
+		{
+		case 0:
+			return randomOctet() + "." + randomOctet() + "." + randomOctet() + "." + randomOctet();
+		case 1:
+			return randomOctet() + "." + randomOctet() + "." + randomOctet() + ".0/" + std::to_string(random() % 33);
+		case 2:
+			return randomOctet() + ".*.*.*";
+		case 3:
+			return randomOctet() + "." + randomOctet() + ".*.*";
+		case 4:
+			return randomOctet() + ".*." + randomOctet() + "." + randomOctet();
+		default:
+			return "*." + randomOctet() + ".*." + randomOctet();
+		}
+	}
+
+	/// Tests random bans being added and removed against matching every ban one by one
+	void testIndexAgainstEveryBan()
+	{
+		int mismatches = 0;
+		for (int round = 0; round < testIndexRounds; ++round)
+		{
+			BanIndex index;
+			std::set<String> bans;
+			for (int change = 0; change < 40; ++change)
+			{
+				const String pattern = randomPattern();
+				if (random() % 3 == 0)
+				{
+					mismatches += (index.erase(pattern) != BanIndex::NotFound) != (bans.erase(pattern) == 1);
+				}
+				else
+				{
+					mismatches += index.insert(pattern, 0) != bans.insert(pattern).second;
+				}
+
+				for (int query = 0; query < 20; ++query)
+				{
+					const String address = randomOctet() + "." + randomOctet() + "." + randomOctet() + "." + randomOctet();
+					bool expected = false;
+					for (const String& ban : bans)
+					{
+						expected |= BanIndex::matches(ban, address);
+					}
+					mismatches += index.matches(address) != expected;
+				}
+			}
+		}
+
+		check(mismatches == 0, "The ban index disagreed with matching every ban one by one.");
+		core->printLn("Bans test: %d rounds of random bans checked against every ban, %d mismatches", testIndexRounds, mismatches);
+	}
+
+	/// Gets the JSON record of a ban, only its address is read back
+	static String banRecord(StringView address)
+	{
+		return "{\"address\":\"" + String(address) + "\"}";
+	}
+
+	/// Gets the address of a ban record or journal line
+	static String recordAddress(StringView line, size_t from = 0)
+	{
+		const size_t start = line.find("\"address\":\"", from);
+		if (start == StringView::npos)
+		{
+			return String();
+		}
+		const size_t end = line.find('"', start + 11);
+		return String(line.substr(start + 11, end - start - 11));
+	}
+
+	/// Loads the bans file and replays the journals like the server does at startup
+	void reload(BanStore& store)
+	{
+		store.reset();
+		std::ifstream file(store.fileName());
+		const String content((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+		for (size_t at = 0; (at = content.find("\"address\":\"", at)) != String::npos; at += 11)
+		{
+			const String address = recordAddress(content, at);
+			store.add(BanEntry(address), banRecord(address), false /* journal */);
+		}
+
+		store.replay([&store](StringView line)
+			{
+				const String address = recordAddress(line);
+				if (line.find("\"clear\"") != StringView::npos)
+				{
+					store.clear(false /* journal */);
+				}
+				else if (line.find("\"add\"") != StringView::npos)
+				{
+					store.add(BanEntry(address), banRecord(address), false /* journal */);
+				}
+				else if (line.find("\"remove\"") != StringView::npos)
+				{
+					store.remove(address, false /* journal */);
+				}
+			});
+	}
+
+	/// Checks a reloaded store has exactly the expected bans
+	void checkBans(const BanStore& store, const std::set<String>& expected)
+	{
+		check(store.size() == expected.size(), "The reloaded bans have another count than the bans written.");
+		for (const String& address : expected)
+		{
+			check(store.contains(address), "A written ban is missing after reloading.");
+		}
+	}
+
+	/// Tests writing changes to the journal, compacting it and replaying it, including after a compaction that didn't finish
+	void testStore()
+	{
+		std::error_code ec;
+		ghc::filesystem::remove_all(testBansDirectory, ec);
+		ghc::filesystem::create_directories(testBansDirectory, ec);
+		if (ec)
+		{
+			check(false, "Couldn't create the test directory.");
+			return;
+		}
+
+		std::set<String> expected;
+		{
+			BanStore store(testBansDirectory);
+			store.settle();
+			for (int change = 0; change < testStoreChanges; ++change)
+			{
+				const String address = "2." + std::to_string(change % 50) + "." + std::to_string(change % 7) + ".0/24";
+				if (change % 5 == 4)
+				{
+					store.remove(address);
+					expected.erase(address);
+				}
+				else if (store.add(BanEntry(address), banRecord(address)))
+				{
+					expected.insert(address);
+				}
+
+				if (change == testStoreChanges * 2 / 3)
+				{
+					store.clear();
+					expected.clear();
+				}
+				if (change % 100 == 0)
+				{
+					store.write();
+				}
+			}
+			store.write();
+			check(store.size() == expected.size(), "The store has another count than the bans added.");
+		}
+
+		const String journal = String(testBansDirectory) + BanStore::JournalFileName;
+		const String compacting = String(testBansDirectory) + BanStore::CompactingFileName;
+		{
+			BanStore store(testBansDirectory);
+			reload(store);
+			checkBans(store, expected);
+			store.settle();
+			check(!ghc::filesystem::exists(journal, ec), "Settling left the journal behind.");
+			check(!ghc::filesystem::exists(compacting, ec), "Settling left the compacted journal behind.");
+		}
+		{
+			// A compaction that didn't finish leaves the rotated journal, which is replayed again
+			BanStore store(testBansDirectory);
+			reload(store);
+			checkBans(store, expected);
+			store.add(BanEntry("3.3.3.3"), banRecord("3.3.3.3"));
+			store.write();
+			ghc::filesystem::rename(journal, compacting, ec);
+			expected.insert("3.3.3.3");
+		}
+		{
+			BanStore store(testBansDirectory);
+			reload(store);
+			checkBans(store, expected);
+		}
+
+		ghc::filesystem::remove_all(testBansDirectory, ec);
+		core->printLn("Bans test: %d changes journalled, %zu bans reloaded", testStoreChanges, expected.size());
+	}
+
+	/// Frees this component, it isn't allocated
+	void free() override
+	{
+	}
+
+	void reset() override
+	{
+		// Nothing to reset here.
+	}
+} bansTestComponent;
+
+COMPONENT_ENTRY_POINT()
+{
+	return &bansTestComponent;
+}
@@ -126,6 +126,7 @@ public:
 	{
 		core = c;
 		core->getPlayers().getPlayerConnectDispatcher().addEventHandler(this);
+		core->getPlayers().registerExtensionSlot(IPlayerCheckpointData::ExtensionIID);
 		core->getPlayers().getPlayerUpdateDispatcher().addEventHandler(&playerCheckpointActionHandler);
 	}
 
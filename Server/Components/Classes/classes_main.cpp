@@ -271,6 +271,7 @@ public:
 		core = c;
 		NetCode::RPC::PlayerRequestClass::addEventHandler(*core, &onPlayerRequestClassHandler);
 		core->getPlayers().getPlayerConnectDispatcher().addEventHandler(this);
+		core->getPlayers().registerExtensionSlot(IPlayerClassData::ExtensionIID);
 	}
 
 	void onInit(IComponentList* components) override
@@ -207,6 +207,7 @@ public:
 		core->getEventDispatcher().addEventHandler(this);
 		this->getEventDispatcher().addEventHandler(this);
 		core->getPlayers().getPlayerConnectDispatcher().addEventHandler(this);
+		core->getPlayers().registerExtensionSlot(IPlayerConsoleData::ExtensionIID);
 
 		NetCode::Packet::PlayerRconCommand::addEventHandler(*core, &playerRconCommandHandler);
 
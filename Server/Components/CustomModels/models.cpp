@@ -457,6 +457,7 @@ public:
 		this->core = core;
 		players = &core->getPlayers();
 		players->getPlayerConnectDispatcher().addEventHandler(this);
+		players->registerExtensionSlot(IPlayerCustomModelsData::ExtensionIID);
 
 		enabled = *core->getConfig().getBool("artwork.enable");
 		modelsPath = String(core->getConfig().getString("artwork.models_path"));
@@ -14,6 +14,11 @@ DatabaseConnection::DatabaseConnection(DatabasesComponent* parentDatabasesCompon
 {
 }
 
+DatabaseConnection::~DatabaseConnection()
+{
+	close();
+}
+
 /// Gets its pool element ID
 /// @return Pool element ID
 int DatabaseConnection::getID() const
@@ -28,6 +33,12 @@ bool DatabaseConnection::close()
 	bool ret(databaseConnectionHandle != nullptr);
 	if (ret)
 	{
+		// Let queued queries write their changes, their results can't be delivered anymore
+		stopWorker();
+		parentDatabasesComponent->cancelCompletedQueries(*this);
+
+		// The connection can't be closed with unfinalized statements
+		clearStatementCache();
 		sqlite3_close(databaseConnectionHandle);
 		databaseConnectionHandle = nullptr;
 	}
@@ -38,15 +49,119 @@ bool DatabaseConnection::close()
 /// @param query Query to execute
 /// @returns Result set
 IDatabaseResultSet* DatabaseConnection::executeQuery(StringView query)
+{
+	return executeIntoResultSet(query, Span<const DatabaseParameter>());
+}
+
+/// Executes a single query with its ? parameters bound in order to the specified values
+/// @param query Query to execute
+/// @param parameters Parameter values
+/// @returns Result set
+IDatabaseResultSet* DatabaseConnection::executePreparedQuery(StringView query, Span<const DatabaseParameter> parameters)
+{
+	return executeIntoResultSet(query, parameters);
+}
+
+/// Executes a query on the connection's background thread
+/// @param query Query to execute
+/// @param parameters Parameter values
+/// @param handler Handler called from the main thread once the query has been executed
+/// @returns "true" if the query has been queued, otherwise "false"
+bool DatabaseConnection::executeQueryAsync(StringView query, Span<const DatabaseParameter> parameters, DatabaseQueryHandler* handler)
+{
+	if (databaseConnectionHandle == nullptr || handler == nullptr)
+	{
+		return false;
+	}
+	parentDatabasesComponent->logQuery("[log_sqlite_queries]: %.*s", PRINT_VIEW(query));
+
+	AsyncQuery async_query { String(query), DynamicArray<DatabaseParameter>(parameters.begin(), parameters.end()), {}, handler };
+	for (const DatabaseParameter& parameter : parameters)
+	{
+		if (parameter.type == DatabaseParameter::Type::Text)
+		{
+			async_query.texts.emplace_back(parameter.text);
+		}
+	}
+
+	{
+		std::scoped_lock lock(asyncQueriesMutex);
+		asyncQueries.emplace_back(std::move(async_query));
+		if (!workerRunning)
+		{
+			workerRunning = true;
+			worker = std::thread(&DatabaseConnection::runWorker, this);
+		}
+	}
+	asyncQueriesSignal.notify_one();
+	return true;
+}
+
+/// Executes queued queries until the worker is stopped and the queue is empty, runs on the worker thread
+void DatabaseConnection::runWorker()
+{
+	for (;;)
+	{
+		AsyncQuery async_query;
+		{
+			std::unique_lock lock(asyncQueriesMutex);
+			asyncQueriesSignal.wait(lock, [this]()
+				{
+					return !asyncQueries.empty() || !workerRunning;
+				});
+			if (asyncQueries.empty())
+			{
+				break;
+			}
+			async_query = std::move(asyncQueries.front());
+			asyncQueries.pop_front();
+		}
+
+		// The copied text has moved with the query, point the parameters at it again
+		std::size_t text_index(0);
+		for (DatabaseParameter& parameter : async_query.parameters)
+		{
+			if (parameter.type == DatabaseParameter::Type::Text)
+			{
+				parameter.text = async_query.texts[text_index++];
+			}
+		}
+
+		std::unique_ptr<DatabaseResultSet> result_set(new DatabaseResultSet());
+		if (!execute(async_query.query, Span<const DatabaseParameter>(async_query.parameters.data(), async_query.parameters.size()), *result_set))
+		{
+			result_set.reset();
+		}
+		parentDatabasesComponent->queueCompletedQuery(*this, async_query.handler, std::move(result_set));
+	}
+}
+
+/// Stops the worker thread after it has executed the queued queries
+void DatabaseConnection::stopWorker()
+{
+	if (worker.joinable())
+	{
+		{
+			std::scoped_lock lock(asyncQueriesMutex);
+			workerRunning = false;
+		}
+		asyncQueriesSignal.notify_all();
+		worker.join();
+	}
+}
+
+/// Creates a result set and executes a query into it
+/// @param query Query to execute
+/// @param parameters Parameter values
+/// @returns Result set if successful, otherwise "nullptr"
+IDatabaseResultSet* DatabaseConnection::executeIntoResultSet(StringView query, Span<const DatabaseParameter> parameters)
 {
 	IDatabaseResultSet* ret(parentDatabasesComponent->createResultSet());
 	if (ret)
 	{
-		// TODO: Properly handle errors
 		parentDatabasesComponent->logQuery("[log_sqlite_queries]: %.*s", PRINT_VIEW(query));
-		if (sqlite3_exec(databaseConnectionHandle, query.data(), queryStepExecuted, ret, nullptr) != SQLITE_OK)
+		if (!execute(query, parameters, static_cast<DatabaseResultSet&>(*ret)))
 		{
-			parentDatabasesComponent->log(LogLevel::Error, "[log_sqlite]: Error executing query.");
 			parentDatabasesComponent->freeResultSet(*ret);
 			ret = nullptr;
 		}
@@ -58,13 +173,180 @@ IDatabaseResultSet* DatabaseConnection::executeQuery(StringView query)
 	return ret;
 }
 
-/// Gets invoked when a query step has been performed
-/// @param userData User data
-/// @param fieldCount Field count
-/// @param values Values
-/// @param fieldNames Field names
-/// @returns Query step result
-int DatabaseConnection::queryStepExecuted(void* userData, int fieldCount, char** values, char** fieldNames)
+/// Executes every statement of a query, adding their rows to a result set
+/// @param query Query to execute
+/// @param parameters Parameter values, only allowed for single statement queries
+/// @param resultSet Result set to add the rows to
+/// @returns "true" if all statements have been executed successfully, otherwise "false"
+bool DatabaseConnection::execute(StringView query, Span<const DatabaseParameter> parameters, DatabaseResultSet& resultSet)
+{
+	if (databaseConnectionHandle == nullptr)
+	{
+		parentDatabasesComponent->log(LogLevel::Error, "[log_sqlite]: Error executing query, the connection is closed.");
+		return false;
+	}
+
+	// The worker thread may be executing a query, the connection and its statement cache are used by one thread at a time
+	std::scoped_lock lock(executeMutex);
+	sqlite3_stmt* statement(findCachedStatement(query));
+	if (statement)
+	{
+		return run(statement, parameters, resultSet);
+	}
+
+	// Like sqlite3_exec, run the statements one after the other until one fails
+	const char* sql(query.data());
+	const char* end(sql + query.size());
+	bool first(true);
+	while (sql < end)
+	{
+		const char* tail(end);
+		statement = nullptr;
+		if (sqlite3_prepare_v2(databaseConnectionHandle, sql, static_cast<int>(end - sql), &statement, &tail) != SQLITE_OK)
+		{
+			parentDatabasesComponent->log(LogLevel::Error, "[log_sqlite]: Error executing query: %s", sqlite3_errmsg(databaseConnectionHandle));
+			return false;
+		}
+
+		// Whitespace or a comment
+		if (statement == nullptr)
+		{
+			sql = tail;
+			continue;
+		}
+
+		while (tail < end && std::isspace(static_cast<unsigned char>(*tail)))
+		{
+			++tail;
+		}
+
+		const bool single(first && tail == end);
+		if (!single && !parameters.empty())
+		{
+			sqlite3_finalize(statement);
+			parentDatabasesComponent->log(LogLevel::Error, "[log_sqlite]: Error executing query, queries with parameters can only have one statement.");
+			return false;
+		}
+
+		const bool ret(run(statement, parameters, resultSet));
+		if (single)
+		{
+			cacheStatement(query, statement);
+		}
+		else
+		{
+			sqlite3_finalize(statement);
+		}
+
+		if (!ret)
+		{
+			return false;
+		}
+		first = false;
+		sql = tail;
+	}
+	return true;
+}
+
+/// Binds parameters, steps a statement until it's done and resets it
+/// @param statement Statement
+/// @param parameters Parameter values
+/// @param resultSet Result set to add the rows to
+/// @returns "true" if the statement has been executed successfully, otherwise "false"
+bool DatabaseConnection::run(sqlite3_stmt* statement, Span<const DatabaseParameter> parameters, DatabaseResultSet& resultSet)
+{
+	int result(SQLITE_DONE);
+	for (std::size_t index(0); index < parameters.size(); index++)
+	{
+		const DatabaseParameter& parameter(parameters[index]);
+		const int parameter_index(static_cast<int>(index) + 1);
+		switch (parameter.type)
+		{
+		case DatabaseParameter::Type::Null:
+			result = sqlite3_bind_null(statement, parameter_index);
+			break;
+		case DatabaseParameter::Type::Integer:
+			result = sqlite3_bind_int64(statement, parameter_index, parameter.integer);
+			break;
+		case DatabaseParameter::Type::Float:
+			result = sqlite3_bind_double(statement, parameter_index, parameter.floating);
+			break;
+		case DatabaseParameter::Type::Text:
+			// The text outlives the statement's use, it's unbound before returning
+			result = sqlite3_bind_text(statement, parameter_index, parameter.text.data(), static_cast<int>(parameter.text.size()), SQLITE_STATIC);
+			break;
+		}
+		if (result != SQLITE_OK)
+		{
+			break;
+		}
+	}
+
+	if (result == SQLITE_OK || result == SQLITE_DONE)
+	{
+		bool columns_added(false);
+		while ((result = sqlite3_step(statement)) == SQLITE_ROW)
+		{
+			if (!columns_added)
+			{
+				resultSet.addColumns(statement);
+				columns_added = true;
+			}
+			resultSet.addRow(statement);
+		}
+	}
+
+	if (result != SQLITE_DONE)
+	{
+		parentDatabasesComponent->log(LogLevel::Error, "[log_sqlite]: Error executing query: %s", sqlite3_errmsg(databaseConnectionHandle));
+	}
+
+	sqlite3_reset(statement);
+	sqlite3_clear_bindings(statement);
+	return result == SQLITE_DONE;
+}
+
+/// Gets the cached statement of a single statement query
+/// @param query Query
+/// @returns Statement if the query is cached, otherwise "nullptr"
+sqlite3_stmt* DatabaseConnection::findCachedStatement(StringView query)
 {
-	return reinterpret_cast<DatabaseResultSet*>(userData)->addRow(fieldCount, fieldNames, values) ? SQLITE_OK : SQLITE_ABORT;
+	auto it(statementCache.find(query));
+	if (it == statementCache.end())
+	{
+		return nullptr;
+	}
+	it->second.lastUsed = ++statementUses;
+	return it->second.statement;
+}
+
+/// Caches the statement of a single statement query, evicting the least recently used statement if the cache is full
+/// @param query Query
+/// @param statement Statement
+void DatabaseConnection::cacheStatement(StringView query, sqlite3_stmt* statement)
+{
+	if (statementCache.size() >= MaxCachedStatements)
+	{
+		auto oldest(statementCache.begin());
+		for (auto it(statementCache.begin()); it != statementCache.end(); ++it)
+		{
+			if (it->second.lastUsed < oldest->second.lastUsed)
+			{
+				oldest = it;
+			}
+		}
+		sqlite3_finalize(oldest->second.statement);
+		statementCache.erase(oldest);
+	}
+	statementCache.emplace(String(query), CachedStatement { statement, ++statementUses });
+}
+
+/// Finalizes all cached statements
+void DatabaseConnection::clearStatementCache()
+{
+	for (auto& entry : statementCache)
+	{
+		sqlite3_finalize(entry.second.statement);
+	}
+	statementCache.clear();
 }
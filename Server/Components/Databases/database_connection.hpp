@@ -8,8 +8,14 @@
 
 #pragma once
 
+#include <cctype>
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
 #include <pool.hpp>
 #include <sqlite3.h>
+#include <thread>
 
 #include "database_result_set.hpp"
 #include <Impl/pool_impl.hpp>
@@ -27,9 +33,81 @@ private:
 	/// Database connection handle
 	sqlite3* databaseConnectionHandle;
 
+	/// A compiled statement kept for reuse
+	struct CachedStatement
+	{
+		sqlite3_stmt* statement;
+
+		/// When the statement was last used, for evicting the least recently used one
+		uint64_t lastUsed;
+	};
+
+	/// Hashes query text as a view, so looking a query up doesn't copy it
+	struct QueryHash
+	{
+		using is_transparent = void;
+
+		std::size_t operator()(StringView query) const
+		{
+			return robin_hood::hash_bytes(query.data(), query.size());
+		}
+	};
+
+	/// Compares query text as views, see QueryHash
+	struct QueryEqual
+	{
+		using is_transparent = void;
+
+		bool operator()(StringView a, StringView b) const
+		{
+			return a == b;
+		}
+	};
+
+	/// Compiled single statement queries by query text
+	robin_hood::unordered_flat_map<String, CachedStatement, QueryHash, QueryEqual> statementCache;
+
+	/// Incremented every time a cached statement is used
+	uint64_t statementUses = 0;
+
+	/// Held while executing a statement, async queries run on the worker thread while the main thread may execute its own
+	std::mutex executeMutex;
+
+	/// A query waiting to be executed by the worker thread
+	struct AsyncQuery
+	{
+		String query;
+		DynamicArray<DatabaseParameter> parameters;
+
+		/// Copies of the text parameters, in order, the parameters are pointed at them right before executing
+		DynamicArray<String> texts;
+
+		DatabaseQueryHandler* handler;
+	};
+
+	/// Executes queued queries, started by the first async query
+	std::thread worker;
+
+	/// Guards asyncQueries and workerRunning
+	std::mutex asyncQueriesMutex;
+
+	/// Signalled when a query is queued or the worker should stop
+	std::condition_variable asyncQueriesSignal;
+
+	/// Queries waiting to be executed
+	std::deque<AsyncQuery> asyncQueries;
+
+	/// Cleared to stop the worker once it has executed the queued queries
+	bool workerRunning = false;
+
 public:
+	/// The number of compiled statements kept per connection
+	static constexpr std::size_t MaxCachedStatements = 32;
+
 	DatabaseConnection(DatabasesComponent* parentDatabasesComponent, sqlite3* databaseConnectionHandle);
 
+	~DatabaseConnection();
+
 	/// Gets its pool element ID
 	/// @return Pool element ID
 	int getID() const override;
@@ -44,12 +122,56 @@ public:
 	/// @returns Result set
 	IDatabaseResultSet* executeQuery(StringView query) override;
 
+	/// Executes a single query with its ? parameters bound in order to the specified values
+	/// @param query Query to execute
+	/// @param parameters Parameter values
+	/// @returns Result set
+	IDatabaseResultSet* executePreparedQuery(StringView query, Span<const DatabaseParameter> parameters) override;
+
+	/// Executes a query on the connection's background thread
+	/// @param query Query to execute
+	/// @param parameters Parameter values
+	/// @param handler Handler called from the main thread once the query has been executed
+	/// @returns "true" if the query has been queued, otherwise "false"
+	bool executeQueryAsync(StringView query, Span<const DatabaseParameter> parameters, DatabaseQueryHandler* handler) override;
+
+	/// Executes every statement of a query, adding their rows to a result set
+	/// @param query Query to execute
+	/// @param parameters Parameter values, only allowed for single statement queries
+	/// @param resultSet Result set to add the rows to
+	/// @returns "true" if all statements have been executed successfully, otherwise "false"
+	bool execute(StringView query, Span<const DatabaseParameter> parameters, DatabaseResultSet& resultSet);
+
 private:
-	/// Gets invoked when a query step has been performed
-	/// @param userData User data
-	/// @param fieldCount Field count
-	/// @param values Values
-	/// @param fieldNames Field names
-	/// @returns Query step result
-	static int queryStepExecuted(void* userData, int fieldCount, char** values, char** fieldNames);
+	/// Gets the cached statement of a single statement query
+	/// @param query Query
+	/// @returns Statement if the query is cached, otherwise "nullptr"
+	sqlite3_stmt* findCachedStatement(StringView query);
+
+	/// Caches the statement of a single statement query, evicting the least recently used statement if the cache is full
+	/// @param query Query
+	/// @param statement Statement
+	void cacheStatement(StringView query, sqlite3_stmt* statement);
+
+	/// Finalizes all cached statements
+	void clearStatementCache();
+
+	/// Binds parameters, steps a statement until it's done and resets it
+	/// @param statement Statement
+	/// @param parameters Parameter values
+	/// @param resultSet Result set to add the rows to
+	/// @returns "true" if the statement has been executed successfully, otherwise "false"
+	bool run(sqlite3_stmt* statement, Span<const DatabaseParameter> parameters, DatabaseResultSet& resultSet);
+
+	/// Creates a result set and executes a query into it
+	/// @param query Query to execute
+	/// @param parameters Parameter values
+	/// @returns Result set if successful, otherwise "nullptr"
+	IDatabaseResultSet* executeIntoResultSet(StringView query, Span<const DatabaseParameter> parameters);
+
+	/// Executes queued queries until the worker is stopped and the queue is empty, runs on the worker thread
+	void runWorker();
+
+	/// Stops the worker thread after it has executed the queued queries
+	void stopWorker();
 };
@@ -8,51 +8,116 @@
 
 #include "database_result_set.hpp"
 
-/// Adds a row
-/// @param fieldCount Field count
-/// @param values Field values
-/// @param fieldNames Field names
-/// @returns "true" if row has been successfully added, otherwise "false"
-bool DatabaseResultSet::addRow(int fieldCount, char** fieldNames, char** values)
-{
-	bool ret((fieldCount <= 0) || (values && fieldNames));
-	if (ret)
+/// Starts the rows of a statement, must be called before adding its first row
+/// @param statement The statement, stepped to its first row
+void DatabaseResultSet::addColumns(sqlite3_stmt* statement)
+{
+	Columns& statement_columns(columns.emplace_back());
+	const int field_count(sqlite3_column_count(statement));
+	statement_columns.names.reserve(field_count);
+	for (int field_index(0); field_index < field_count; field_index++)
 	{
+		const char* field_name(sqlite3_column_name(statement, field_index));
+		statement_columns.names.emplace_back(field_name ? field_name : "");
+		statement_columns.indices.emplace(statement_columns.names.back(), field_index);
+	}
+}
 
-		// First time DatabaseResultSet::addRow being called after query exeuction
-		// so push all field names back to our vector of char* so we are keeping data
-		// for using it in legacy database result structure
-		legacyDbResult.addColumns(fieldCount, fieldNames, values);
+/// Adds the row a statement has been stepped to
+/// @param statement The statement
+void DatabaseResultSet::addRow(sqlite3_stmt* statement)
+{
+	const std::size_t field_count(columns.back().names.size());
+	rows.push_back({ fields.size(), columns.size() - 1 });
+	for (std::size_t field_index(0); field_index < field_count; field_index++)
+	{
+		Field& field(fields.emplace_back());
+		field.type = sqlite3_column_type(statement, field_index);
+		field.integer = field.type == SQLITE_INTEGER ? sqlite3_column_int64(statement, field_index) : 0;
+		field.real = field.type == SQLITE_FLOAT ? sqlite3_column_double(statement, field_index) : 0.0;
+
+		// Read the text after the type, it converts the value
+		const unsigned char* value(sqlite3_column_text(statement, field_index));
+		field.length = value ? sqlite3_column_bytes(statement, field_index) : 0;
+		field.offset = text.size();
+		text.append(reinterpret_cast<const char*>(value), field.length);
+		text.push_back('\0');
+	}
+}
 
-		rows.push({});
-		DatabaseResultSetRow* result_set_row(&rows.back());
-		for (int field_index(0); field_index < fieldCount; field_index++)
-		{
+/// Takes the rows of a result set which was filled outside of the pool
+/// @param other Result set to take the rows of, it's left empty
+void DatabaseResultSet::moveFrom(DatabaseResultSet& other)
+{
+	columns = std::move(other.columns);
+	rows = std::move(other.rows);
+	fields = std::move(other.fields);
+	text = std::move(other.text);
+	currentRow = 0;
+	other.columns.clear();
+	other.rows.clear();
+	other.fields.clear();
+	other.text.clear();
+}
 
-			// Push values in a row back to our vector of char*, keeping them and all rows
-			// in order for using it in legacy database result structure
-			legacyDbResult.addField(values[field_index]);
+/// Gets the index of a field of the selected row
+/// @param fieldName Field name
+/// @returns Field index if the field name is available, otherwise -1
+std::ptrdiff_t DatabaseResultSet::getFieldIndex(StringView fieldName) const
+{
+	if (currentRow >= rows.size())
+	{
+		return -1;
+	}
+	const FlatHashMap<String, std::size_t>& indices(columns[rows[currentRow].columns].indices);
+	const FlatHashMap<String, std::size_t>::const_iterator& field_name_to_field_index_iterator(indices.find(String(fieldName)));
+	return (field_name_to_field_index_iterator == indices.end()) ? -1 : static_cast<std::ptrdiff_t>(field_name_to_field_index_iterator->second);
+}
 
-			if (!result_set_row->addField(fieldNames[field_index], values[field_index] ? values[field_index] : ""))
-			{
-				ret = false;
-				break;
-			}
-		}
-		if (ret)
-		{
-			++rowCount;
-		}
-		else
-		{
-			rows.pop();
-		}
+/// Gets a field of the selected row
+/// @param fieldIndex Field index
+/// @returns Field if the field index is valid, otherwise nullptr
+const DatabaseResultSet::Field* DatabaseResultSet::getField(std::size_t fieldIndex) const
+{
+	if (currentRow >= rows.size() || fieldIndex >= columns[rows[currentRow].columns].names.size())
+	{
+		return nullptr;
+	}
+	return &fields[rows[currentRow].firstField + fieldIndex];
+}
 
-		// Now here we are assigning collected results in legacy structure to
-		// our LegacyDBResult::results
-		legacyDbResult.columns = rowCount;
+/// Gets the string of a field
+StringView DatabaseResultSet::getFieldString(const Field* field) const
+{
+	return field ? StringView(text.data() + field->offset, field->length) : StringView();
+}
+
+/// Gets the integer of a field
+long DatabaseResultSet::getFieldInt(const Field* field) const
+{
+	if (!field)
+	{
+		return 0L;
+	}
+	return field->type == SQLITE_INTEGER ? static_cast<long>(field->integer) : std::atol(text.data() + field->offset);
+}
+
+/// Gets the floating point number of a field
+double DatabaseResultSet::getFieldFloat(const Field* field) const
+{
+	if (!field)
+	{
+		return 0.0;
+	}
+	switch (field->type)
+	{
+	case SQLITE_INTEGER:
+		return static_cast<double>(field->integer);
+	case SQLITE_FLOAT:
+		return field->real;
+	default:
+		return std::atof(text.data() + field->offset);
 	}
-	return ret;
 }
 
 /// Gets its pool element ID
@@ -66,25 +131,25 @@ int DatabaseResultSet::getID() const
 /// @returns Number of rows
 std::size_t DatabaseResultSet::getRowCount() const
 {
-	return rowCount;
+	return rows.size();
 }
 
 /// Selects next row
 /// @returns "true" if next row has been selected successfully, otherwise "false"
 bool DatabaseResultSet::selectNextRow()
 {
-	if (!rows.empty())
+	if (currentRow < rows.size())
 	{
-		rows.pop();
+		++currentRow;
 	}
-	return !rows.empty();
+	return currentRow < rows.size();
 }
 
 /// Gets the number of fields
 /// @returns Number of fields
 std::size_t DatabaseResultSet::getFieldCount() const
 {
-	return rows.empty() ? static_cast<std::size_t>(0) : rows.front().getFieldCount();
+	return (currentRow < rows.size()) ? columns[rows[currentRow].columns].names.size() : static_cast<std::size_t>(0);
 }
 
 /// Is field name available
@@ -92,7 +157,7 @@ std::size_t DatabaseResultSet::getFieldCount() const
 /// @returns "true" if field name is available, otherwise "false"
 bool DatabaseResultSet::isFieldNameAvailable(StringView fieldName) const
 {
-	return !rows.empty() && rows.front().isFieldNameAvailable(fieldName);
+	return getFieldIndex(fieldName) != -1;
 }
 
 /// Gets the name of the field by the specified field index
@@ -100,7 +165,7 @@ bool DatabaseResultSet::isFieldNameAvailable(StringView fieldName) const
 /// @returns Name of the field
 StringView DatabaseResultSet::getFieldName(std::size_t fieldIndex) const
 {
-	return rows.empty() ? StringView() : rows.front().getFieldName(fieldIndex);
+	return getField(fieldIndex) ? StringView(columns[rows[currentRow].columns].names[fieldIndex]) : StringView();
 }
 
 /// Gets the string of the field by the specified field index
@@ -108,7 +173,7 @@ StringView DatabaseResultSet::getFieldName(std::size_t fieldIndex) const
 /// @returns String
 StringView DatabaseResultSet::getFieldString(std::size_t fieldIndex) const
 {
-	return rows.empty() ? StringView() : rows.front().getFieldString(fieldIndex);
+	return getFieldString(getField(fieldIndex));
 }
 
 /// Gets the integer of the field by the specified field index
@@ -116,7 +181,7 @@ StringView DatabaseResultSet::getFieldString(std::size_t fieldIndex) const
 /// @returns Integer
 long DatabaseResultSet::getFieldInt(std::size_t fieldIndex) const
 {
-	return rows.empty() ? 0L : rows.front().getFieldInt(fieldIndex);
+	return getFieldInt(getField(fieldIndex));
 }
 
 /// Gets the floating point number of the field by the specified field index
@@ -124,7 +189,7 @@ long DatabaseResultSet::getFieldInt(std::size_t fieldIndex) const
 /// @returns Floating point number
 double DatabaseResultSet::getFieldFloat(std::size_t fieldIndex) const
 {
-	return rows.empty() ? 0.0 : rows.front().getFieldFloat(fieldIndex);
+	return getFieldFloat(getField(fieldIndex));
 }
 
 /// Gets the string of the field by the specified field name
@@ -132,7 +197,8 @@ double DatabaseResultSet::getFieldFloat(std::size_t fieldIndex) const
 /// @returns String
 StringView DatabaseResultSet::getFieldStringByName(StringView fieldName) const
 {
-	return rows.empty() ? StringView() : rows.front().getFieldStringByName(fieldName);
+	const std::ptrdiff_t field_index(getFieldIndex(fieldName));
+	return (field_index == -1) ? StringView() : getFieldString(getField(field_index));
 }
 
 /// Gets the integer of the field by the specified field name
@@ -140,7 +206,8 @@ StringView DatabaseResultSet::getFieldStringByName(StringView fieldName) const
 /// @returns Integer
 long DatabaseResultSet::getFieldIntByName(StringView fieldName) const
 {
-	return rows.empty() ? 0L : rows.front().getFieldIntByName(fieldName);
+	const std::ptrdiff_t field_index(getFieldIndex(fieldName));
+	return (field_index == -1) ? 0L : getFieldInt(getField(field_index));
 }
 
 /// Gets the floating point number of the field by the specified field name
@@ -148,11 +215,39 @@ long DatabaseResultSet::getFieldIntByName(StringView fieldName) const
 /// @returns Floating point number
 double DatabaseResultSet::getFieldFloatByName(StringView fieldName) const
 {
-	return rows.empty() ? 0.0 : rows.front().getFieldFloatByName(fieldName);
+	const std::ptrdiff_t field_index(getFieldIndex(fieldName));
+	return (field_index == -1) ? 0.0 : getFieldFloat(getField(field_index));
 }
 
 /// Gets database results in legacy structure
 LegacyDBResult& DatabaseResultSet::getLegacyDBResult()
 {
+	// Only built when a script asks for it, pointing into the names and text buffer which don't change once the query is done
+	if (!legacyDbResult.isBuilt() && !columns.empty())
+	{
+		// The legacy structure has one column count for every row, so like sqlite3_get_table
+		// it's left empty when the statements of the query returned different numbers of fields
+		const Columns& first_columns(columns.front());
+		for (const Columns& statement_columns : columns)
+		{
+			if (statement_columns.names.size() != first_columns.names.size())
+			{
+				legacyDbResult.build(0, 0, {});
+				return legacyDbResult;
+			}
+		}
+
+		DynamicArray<char*> results;
+		results.reserve(first_columns.names.size() + fields.size());
+		for (const String& name : first_columns.names)
+		{
+			results.push_back(const_cast<char*>(name.c_str()));
+		}
+		for (const Field& field : fields)
+		{
+			results.push_back(const_cast<char*>(text.data() + field.offset));
+		}
+		legacyDbResult.build(static_cast<int>(rows.size()), static_cast<int>(first_columns.names.size()), std::move(results));
+	}
 	return legacyDbResult;
 }
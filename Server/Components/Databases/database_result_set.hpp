@@ -8,9 +8,10 @@
 
 #pragma once
 
-#include "database_result_set_row.hpp"
 #include <Impl/pool_impl.hpp>
-#include <queue>
+#include <Server/Components/Databases/databases.hpp>
+#include <sqlite3.h>
+#include <types.hpp>
 
 using namespace Impl;
 
@@ -19,49 +20,122 @@ class LegacyDBResultImpl : public LegacyDBResult
 private:
 	// Extra members to be used in open.mp code
 	DynamicArray<char*> results_;
-	bool fieldsAreAdded = false;
+	bool built_ = false;
 
 public:
-	void addColumns(int fieldCount, char** fieldNames, char** values)
+	LegacyDBResultImpl()
 	{
-		if (!fieldsAreAdded)
-		{
-			for (int field_index(0); field_index < fieldCount; field_index++)
-			{
-				results_.push_back(fieldNames[field_index]);
-			}
-			columns = fieldCount;
-			fieldsAreAdded = true;
-		}
-		results = results_.data();
+		rows = 0;
+		columns = 0;
+		results = nullptr;
 	}
 
-	void addField(char* value)
+	bool isBuilt() const
 	{
-		results_.push_back(const_cast<char*>(value ? value : ""));
-		results = results_.data();
+		return built_;
+	}
+
+	/// Sets the field names followed by the values of every row, like sqlite3_get_table
+	void build(int rowCount, int columnCount, DynamicArray<char*>&& fields)
+	{
+		results_ = std::move(fields);
+		rows = rowCount;
+		columns = columnCount;
+		results = results_.empty() ? nullptr : results_.data();
+		built_ = true;
 	}
 };
 
 class DatabaseResultSet final : public IDatabaseResultSet, public PoolIDProvider, public NoCopy
 {
 private:
+	/// Field names of the rows of one statement, stored once for all of them
+	struct Columns
+	{
+		/// Field names
+		DynamicArray<String> names;
+
+		/// Field name to field index lookup, the first field is used for duplicate names
+		FlatHashMap<String, std::size_t> indices;
+	};
+
+	/// A field value, the text is stored in the result set's text buffer
+	struct Field
+	{
+		/// Offset of the NUL terminated text in the text buffer
+		std::size_t offset;
+
+		/// Length of the text
+		std::size_t length;
+
+		/// SQLite storage class of the value
+		int type;
+
+		/// The value when it's stored as an integer
+		sqlite3_int64 integer;
+
+		/// The value when it's stored as a floating point number, the text SQLite converts it to is rounded
+		double real;
+	};
+
+	struct Row
+	{
+		/// Index of the row's first field
+		std::size_t firstField;
+
+		/// Index of the row's field names
+		std::size_t columns;
+	};
+
+	/// Field names of each statement which returned rows
+	DynamicArray<Columns> columns;
+
 	/// Rows
-	std::queue<DatabaseResultSetRow> rows;
+	DynamicArray<Row> rows;
+
+	/// Fields of all the rows, row by row
+	DynamicArray<Field> fields;
+
+	/// Text of all the fields
+	String text;
 
-	/// Number of rows
-	std::size_t rowCount;
+	/// The selected row
+	std::size_t currentRow = 0;
 
 	/// Legacy database result to allow libraries access members of this structure from pawn (don't even ask)
 	LegacyDBResultImpl legacyDbResult;
 
+	/// Gets the index of a field of the selected row
+	/// @param fieldName Field name
+	/// @returns Field index if the field name is available, otherwise -1
+	std::ptrdiff_t getFieldIndex(StringView fieldName) const;
+
+	/// Gets a field of the selected row
+	/// @param fieldIndex Field index
+	/// @returns Field if the field index is valid, otherwise nullptr
+	const Field* getField(std::size_t fieldIndex) const;
+
+	/// Gets the string of a field
+	StringView getFieldString(const Field* field) const;
+
+	/// Gets the integer of a field
+	long getFieldInt(const Field* field) const;
+
+	/// Gets the floating point number of a field
+	double getFieldFloat(const Field* field) const;
+
 public:
-	/// Adds a row
-	/// @param fieldCount Field count
-	/// @param values Field values
-	/// @param fieldNames Field names
-	/// @returns "true" if row has been successfully added, otherwise "false"
-	bool addRow(int fieldCount, char** values, char** fieldNames);
+	/// Starts the rows of a statement, must be called before adding its first row
+	/// @param statement The statement, stepped to its first row
+	void addColumns(sqlite3_stmt* statement);
+
+	/// Adds the row a statement has been stepped to
+	/// @param statement The statement
+	void addRow(sqlite3_stmt* statement);
+
+	/// Takes the rows of a result set which was filled outside of the pool
+	/// @param other Result set to take the rows of, it's left empty
+	void moveFrom(DatabaseResultSet& other);
 
 	/// Gets its pool element ID
 	/// @return Pool element ID
@@ -12,6 +12,103 @@ DatabasesComponent::DatabasesComponent()
 {
 }
 
+DatabasesComponent::~DatabasesComponent()
+{
+	if (core_)
+	{
+		core_->getEventDispatcher().removeEventHandler(this);
+	}
+
+	// Stop the worker threads while the completion queue still exists
+	for (IDatabaseConnection* connection : databaseConnections.entries())
+	{
+		connection->close();
+	}
+}
+
+/// Queues an executed query to be delivered on the main thread, called from connection worker threads
+/// @param connection Connection the query was executed on
+/// @param handler Handler to deliver the result to
+/// @param resultSet Result set, "nullptr" if the query failed
+void DatabasesComponent::queueCompletedQuery(DatabaseConnection& connection, DatabaseQueryHandler* handler, std::unique_ptr<DatabaseResultSet> resultSet)
+{
+	std::scoped_lock lock(completedQueriesMutex);
+	completedQueries.push_back({ &connection, handler, std::move(resultSet) });
+}
+
+/// Cancels the executed queries of a connection which haven't been delivered yet
+/// @param connection Connection being closed
+void DatabasesComponent::cancelCompletedQueries(DatabaseConnection& connection)
+{
+	DynamicArray<DatabaseQueryHandler*> cancelled;
+	{
+		std::scoped_lock lock(completedQueriesMutex);
+		for (auto it(completedQueries.begin()); it != completedQueries.end();)
+		{
+			if (it->connection == &connection)
+			{
+				cancelled.push_back(it->handler);
+				it = completedQueries.erase(it);
+			}
+			else
+			{
+				++it;
+			}
+		}
+	}
+
+	for (DatabaseQueryHandler* handler : cancelled)
+	{
+		handler->onDatabaseQueryCancelled(connection);
+	}
+}
+
+/// Delivers executed queries
+void DatabasesComponent::onTick(Microseconds elapsed, TimePoint now)
+{
+	// Handlers may close connections, which removes their queries, or queue more queries, which are delivered next tick
+	std::size_t count;
+	{
+		std::scoped_lock lock(completedQueriesMutex);
+		count = completedQueries.size();
+	}
+
+	for (; count > 0; count--)
+	{
+		CompletedQuery completed_query;
+		{
+			std::scoped_lock lock(completedQueriesMutex);
+			if (completedQueries.empty())
+			{
+				break;
+			}
+			completed_query = std::move(completedQueries.front());
+			completedQueries.pop_front();
+		}
+
+		// Result sets are made by the worker outside of the pool, the pool isn't thread safe
+		DatabaseResultSet* result_set(nullptr);
+		if (completed_query.resultSet)
+		{
+			result_set = static_cast<DatabaseResultSet*>(createResultSet());
+			if (result_set)
+			{
+				result_set->moveFrom(*completed_query.resultSet);
+			}
+			else
+			{
+				log(LogLevel::Error, "[log_sqlite]: Could not create SQLite result set.");
+			}
+		}
+
+		completed_query.handler->onDatabaseQueryExecuted(*completed_query.connection, result_set);
+		if (result_set)
+		{
+			freeResultSet(*result_set);
+		}
+	}
+}
+
 /// Creates a  result set
 /// @returns Result set if successful, otherwise "nullptr"
 IDatabaseResultSet* DatabasesComponent::createResultSet()
@@ -26,6 +123,7 @@ IDatabaseResultSet* DatabasesComponent::createResultSet()
 void DatabasesComponent::onLoad(ICore* c)
 {
 	core_ = c;
+	core_->getEventDispatcher().addEventHandler(this);
 	logSQLite_ = core_->getConfig().getBool("logging.log_sqlite");
 	logSQLiteQueries_ = core_->getConfig().getBool("logging.log_sqlite_queries");
 }
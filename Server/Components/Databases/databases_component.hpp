@@ -9,13 +9,32 @@
 #pragma once
 
 #include "database_connection.hpp"
+#include <deque>
+#include <memory>
+#include <mutex>
 #include <Impl/pool_impl.hpp>
 
 using namespace Impl;
 
-class DatabasesComponent final : public IDatabasesComponent, public NoCopy
+class DatabasesComponent final : public IDatabasesComponent, public CoreEventHandler, public NoCopy
 {
 private:
+	/// A query executed by a connection's worker thread, waiting to be delivered on the main thread
+	struct CompletedQuery
+	{
+		DatabaseConnection* connection;
+		DatabaseQueryHandler* handler;
+
+		/// Rows of the query, "nullptr" if it failed
+		std::unique_ptr<DatabaseResultSet> resultSet;
+	};
+
+	/// Guards completedQueries
+	std::mutex completedQueriesMutex;
+
+	/// Queries waiting to be delivered, in the order they were executed
+	std::deque<CompletedQuery> completedQueries;
+
 	/// Database connections
 	/// TODO: Replace with a pool type that grows dynamically
 	DynamicPoolStorage<DatabaseConnection, IDatabaseConnection, 1, 1025> databaseConnections;
@@ -27,7 +46,7 @@ private:
 	bool* logSQLite_;
 	bool* logSQLiteQueries_;
 
-	ICore* core_;
+	ICore* core_ = nullptr;
 
 public:
 	/// Creates a result set
@@ -36,6 +55,21 @@ public:
 
 	DatabasesComponent();
 
+	~DatabasesComponent();
+
+	/// Queues an executed query to be delivered on the main thread, called from connection worker threads
+	/// @param connection Connection the query was executed on
+	/// @param handler Handler to deliver the result to
+	/// @param resultSet Result set, "nullptr" if the query failed
+	void queueCompletedQuery(DatabaseConnection& connection, DatabaseQueryHandler* handler, std::unique_ptr<DatabaseResultSet> resultSet);
+
+	/// Cancels the executed queries of a connection which haven't been delivered yet
+	/// @param connection Connection being closed
+	void cancelCompletedQueries(DatabaseConnection& connection);
+
+	/// Delivers executed queries
+	void onTick(Microseconds elapsed, TimePoint now) override;
+
 	/// Gets the component name
 	/// @returns Component name
 	StringView componentName() const override
@@ -8,6 +8,9 @@
 
 #include <Server/Components/Databases/databases.hpp>
 #include <sdk.hpp>
+#include <thread>
+
+using namespace Impl;
 
 /// Test database file path
 const char* testDatabaseFilePath("../../../test.db");
@@ -15,12 +18,115 @@ const char* testDatabaseFilePath("../../../test.db");
 /// Test query
 const char* testQuery("SELECT * FROM `test`");
 
-struct DatabasesTestComponent final : public IComponent, public NoCopy
+/// Test query with a parameter
+const char* testParameterQuery("SELECT `test_integer` FROM `test` WHERE `test_string` = ?");
+
+/// Test query with several statements
+const char* testMultipleStatementsQuery("SELECT 1 AS `first`; SELECT 'two' AS `second`, 3 AS `third`");
+
+/// Test query which fails
+const char* testFailingQuery("SELECT * FROM `missing_table`");
+
+/// How long to wait for queries executed in the background to be delivered
+const Seconds asyncQueryTimeout(5);
+
+struct DatabasesTestComponent final : public IComponent, public CoreEventHandler, public NoCopy
 {
+	/// Checks the result of a query executed in the background
+	struct AsyncQueryCheck final : public DatabaseQueryHandler
+	{
+		/// Test component
+		DatabasesTestComponent& test;
+
+		/// Check name
+		const char* name;
+
+		/// Expected row count, -1 if the query is expected to fail
+		int expectedRowCount;
+
+		/// Field index of the integer checked in the first row
+		int integerFieldIndex;
+
+		/// Expected integer of the first row
+		long expectedInteger;
+
+		/// Number of times the result has been delivered
+		int executed = 0;
+
+		/// Number of times the result has been cancelled
+		int cancelled = 0;
+
+		AsyncQueryCheck(DatabasesTestComponent& test, const char* name, int expectedRowCount, int integerFieldIndex = 0, long expectedInteger = 0)
+			: test(test)
+			, name(name)
+			, expectedRowCount(expectedRowCount)
+			, integerFieldIndex(integerFieldIndex)
+			, expectedInteger(expectedInteger)
+		{
+		}
+
+		void onDatabaseQueryExecuted(IDatabaseConnection& connection, IDatabaseResultSet* resultSet) override
+		{
+			++executed;
+			if (std::this_thread::get_id() != test.mainThreadID)
+			{
+				test.core->printLn("[ERROR] Async %s was delivered outside of the main thread.", name);
+				return;
+			}
+			if (expectedRowCount < 0)
+			{
+				if (resultSet)
+				{
+					test.core->printLn("[ERROR] Async %s delivered a result set. Expected it to be \"nullptr\".", name);
+					return;
+				}
+				test.core->printLn("Async %s delivered \"nullptr\"", name);
+				return;
+			}
+			if (resultSet == nullptr)
+			{
+				test.core->printLn("[ERROR] Async %s delivered \"nullptr\". Expected a result set.", name);
+				return;
+			}
+			std::size_t row_count(resultSet->getRowCount());
+			if (row_count != static_cast<std::size_t>(expectedRowCount))
+			{
+				test.core->printLn("[ERROR] Async %s row count: %zu. Expected it to be \"%d\".", name, row_count, expectedRowCount);
+				return;
+			}
+			if (test.validateFieldInteger(resultSet, integerFieldIndex, expectedInteger))
+			{
+				test.core->printLn("Async %s delivered %zu rows on the main thread", name, row_count);
+			}
+		}
+
+		void onDatabaseQueryCancelled(IDatabaseConnection& connection) override
+		{
+			++cancelled;
+		}
+	};
 
 	/// Core
 	ICore* core = nullptr;
 
+	/// Databases component
+	IDatabasesComponent* databasesComponent = nullptr;
+
+	/// The thread components are initialised and ticked on
+	std::thread::id mainThreadID;
+
+	/// Connection of the queries executed in the background, closed once they have been delivered
+	IDatabaseConnection* asyncConnection = nullptr;
+
+	/// When the queries were queued
+	TimePoint asyncQueriesQueued;
+
+	/// Background query checks
+	AsyncQueryCheck asyncQueryCheck { *this, "query", 2, 1, 69 };
+	AsyncQueryCheck asyncParameterQueryCheck { *this, "query with a parameter", 1, 0, 1337 };
+	AsyncQueryCheck asyncFailingQueryCheck { *this, "failing query", -1 };
+	AsyncQueryCheck asyncCancelledQueryCheck { *this, "cancelled query", 2, 1, 69 };
+
 	/// Gets the component UID
 	/// @returns COmponent UID
 	UID getUID() override
@@ -49,6 +155,41 @@ struct DatabasesTestComponent final : public IComponent, public NoCopy
 	void onLoad(ICore* c) override
 	{
 		core = c;
+		core->getEventDispatcher().addEventHandler(this);
+	}
+
+	/// Gets the component version
+	/// @return Component version
+	SemanticVersion componentVersion() const override
+	{
+		return SemanticVersion(OMP_VERSION_MAJOR, OMP_VERSION_MINOR, OMP_VERSION_PATCH, BUILD_NUMBER);
+	}
+
+	/// Called when another component is about to be freed
+	/// @param component The component being freed
+	void onFree(IComponent* component) override
+	{
+		if (component == databasesComponent)
+		{
+			databasesComponent = nullptr;
+			asyncConnection = nullptr;
+		}
+	}
+
+	/// Frees this component, it isn't allocated
+	void free() override
+	{
+		if (databasesComponent && asyncConnection)
+		{
+			databasesComponent->close(*asyncConnection);
+			asyncConnection = nullptr;
+		}
+		core->getEventDispatcher().removeEventHandler(this);
+	}
+
+	void reset() override
+	{
+		// Nothing to reset here.
 	}
 
 	/// Called when all components have been initialised
@@ -56,7 +197,8 @@ struct DatabasesTestComponent final : public IComponent, public NoCopy
 	/// @param components Tcomponentgins list to query
 	void onInit(IComponentList* components) override
 	{
-		IDatabasesComponent* databases_component(components->queryComponent<IDatabasesComponent>());
+		databasesComponent = components->queryComponent<IDatabasesComponent>();
+		IDatabasesComponent* databases_component(databasesComponent);
 		if (databases_component)
 		{
 			IDatabaseConnection* database_connection(databases_component->open(testDatabaseFilePath));
@@ -272,6 +414,303 @@ struct DatabasesTestComponent final : public IComponent, public NoCopy
 		}
 	}
 
+	/// Called when all components have been initialised and the synchronous checks have closed their connection
+	void onReady() override
+	{
+		if (databasesComponent)
+		{
+			testPreparedQueries(databasesComponent);
+			testAsyncQueries(databasesComponent);
+		}
+	}
+
+	/// Executes a query and checks its row count
+	/// @param databaseConnection Database connection
+	/// @param query Query to execute
+	/// @param parameters Parameter values
+	/// @param expectedRowCount Expected row count
+	/// @returns Result set if the query has been executed with the expected row count, otherwise "nullptr"
+	IDatabaseResultSet* executeQueryWithRowCount(IDatabaseConnection* databaseConnection, const char* query, Span<const DatabaseParameter> parameters, std::size_t expectedRowCount)
+	{
+		IDatabaseResultSet* result_set(databaseConnection->executePreparedQuery(query, parameters));
+		if (result_set == nullptr)
+		{
+			core->printLn("[ERROR] Failed to execute query \"%s\".", query);
+			return nullptr;
+		}
+		std::size_t row_count(result_set->getRowCount());
+		if (row_count != expectedRowCount)
+		{
+			core->printLn("[ERROR] Row count: %zu of query \"%s\". Expected it to be \"%zu\".", row_count, query, expectedRowCount);
+			databasesComponent->freeResultSet(*result_set);
+			return nullptr;
+		}
+		return result_set;
+	}
+
+	/// Tests executing queries with parameters, queries with several statements and the legacy result layout
+	/// @param databases_component Databases component
+	void testPreparedQueries(IDatabasesComponent* databases_component)
+	{
+		IDatabaseConnection* database_connection(databases_component->open(testDatabaseFilePath));
+		if (database_connection == nullptr)
+		{
+			core->printLn("[ERROR] Failed to open \"%s\".", testDatabaseFilePath);
+			return;
+		}
+		if (testParameterTypes(database_connection) && testCachedStatement(database_connection) && testMultipleStatements(database_connection) && testLegacyDBResult(database_connection))
+		{
+			core->printLn("Prepared queries passed");
+		}
+		databases_component->close(*database_connection);
+	}
+
+	/// Tests binding each parameter type, the rows are inserted into a temporary table so the test database isn't changed
+	/// @param databaseConnection Database connection
+	/// @returns "true" if validation was successful, otherwise "false"
+	bool testParameterTypes(IDatabaseConnection* databaseConnection)
+	{
+		IDatabaseResultSet* result_set(executeQueryWithRowCount(databaseConnection, "CREATE TEMP TABLE `prepared` (`value`)", Span<const DatabaseParameter>(), 0));
+		if (result_set == nullptr)
+		{
+			return false;
+		}
+		databasesComponent->freeResultSet(*result_set);
+
+		// Bigger than 32 bits to check integers are bound as 64 bit
+		const DatabaseParameter parameters[] = { DatabaseParameter(), DatabaseParameter(int64_t(1) << 40), DatabaseParameter(2.5), DatabaseParameter(StringView("Prepared text")) };
+		for (const DatabaseParameter& parameter : parameters)
+		{
+			result_set = executeQueryWithRowCount(databaseConnection, "INSERT INTO `prepared` (`value`) VALUES (?)", Span<const DatabaseParameter>(&parameter, 1), 0);
+			if (result_set == nullptr)
+			{
+				return false;
+			}
+			databasesComponent->freeResultSet(*result_set);
+		}
+
+		result_set = executeQueryWithRowCount(databaseConnection, "SELECT `value`, typeof(`value`) AS `type` FROM `prepared` ORDER BY rowid", Span<const DatabaseParameter>(), 4);
+		if (result_set == nullptr)
+		{
+			return false;
+		}
+		const char* expected_types[] = { "null", "integer", "real", "text" };
+		const char* expected_values[] = { "", "1099511627776", "2.5", "Prepared text" };
+		bool ret(true);
+		for (std::size_t row_index(0); ret && row_index < 4; row_index++)
+		{
+			if (row_index != 0 && !result_set->selectNextRow())
+			{
+				core->printLn("[ERROR] result_set->selectNextRow() returned \"false\".");
+				ret = false;
+				break;
+			}
+			ret = validateFieldString(result_set, 1, expected_types[row_index]) && validateFieldString(result_set, 0, expected_values[row_index]);
+		}
+		databasesComponent->freeResultSet(*result_set);
+		if (ret)
+		{
+			core->printLn("Parameters of every type bound");
+		}
+		return ret;
+	}
+
+	/// Tests executing a cached statement again with other parameters and without any
+	/// @param databaseConnection Database connection
+	/// @returns "true" if validation was successful, otherwise "false"
+	bool testCachedStatement(IDatabaseConnection* databaseConnection)
+	{
+		const DatabaseParameter first_parameter(StringView("Hello world!"));
+		IDatabaseResultSet* result_set(executeQueryWithRowCount(databaseConnection, testParameterQuery, Span<const DatabaseParameter>(&first_parameter, 1), 1));
+		if (result_set == nullptr)
+		{
+			return false;
+		}
+		bool ret(validateFieldInteger(result_set, 0, 69));
+		databasesComponent->freeResultSet(*result_set);
+		if (!ret)
+		{
+			return false;
+		}
+
+		const DatabaseParameter second_parameter(StringView("Another test!"));
+		result_set = executeQueryWithRowCount(databaseConnection, testParameterQuery, Span<const DatabaseParameter>(&second_parameter, 1), 1);
+		if (result_set == nullptr)
+		{
+			return false;
+		}
+		ret = validateFieldInteger(result_set, 0, 1337);
+		databasesComponent->freeResultSet(*result_set);
+		if (!ret)
+		{
+			return false;
+		}
+
+		// The last bindings are cleared, an unbound parameter is NULL and matches nothing
+		result_set = executeQueryWithRowCount(databaseConnection, testParameterQuery, Span<const DatabaseParameter>(), 0);
+		if (result_set == nullptr)
+		{
+			return false;
+		}
+		databasesComponent->freeResultSet(*result_set);
+		core->printLn("Cached statement executed with new parameters");
+		return true;
+	}
+
+	/// Tests executing a query with several statements, their rows are added in order with their own field names
+	/// @param databaseConnection Database connection
+	/// @returns "true" if validation was successful, otherwise "false"
+	bool testMultipleStatements(IDatabaseConnection* databaseConnection)
+	{
+		IDatabaseResultSet* result_set(executeQueryWithRowCount(databaseConnection, testMultipleStatementsQuery, Span<const DatabaseParameter>(), 2));
+		if (result_set == nullptr)
+		{
+			return false;
+		}
+		bool ret(result_set->getFieldCount() == 1 && validateFieldName(result_set, 0, "first") && validateFieldInteger(result_set, 0, 1));
+		if (ret && !result_set->selectNextRow())
+		{
+			core->printLn("[ERROR] result_set->selectNextRow() returned \"false\".");
+			ret = false;
+		}
+		ret = ret && result_set->getFieldCount() == 2 && validateFieldName(result_set, 0, "second") && validateFieldString(result_set, 0, "two") && validateFieldName(result_set, 1, "third") && validateFieldInteger(result_set, 1, 3);
+		databasesComponent->freeResultSet(*result_set);
+		if (!ret)
+		{
+			core->printLn("[ERROR] Rows of query \"%s\" don't match their statements.", testMultipleStatementsQuery);
+			return false;
+		}
+
+		// Parameters can only be bound to single statement queries
+		const DatabaseParameter parameter(1);
+		result_set = databaseConnection->executePreparedQuery(testMultipleStatementsQuery, Span<const DatabaseParameter>(&parameter, 1));
+		if (result_set)
+		{
+			core->printLn("[ERROR] Query \"%s\" with a parameter returned a result set. Expected it to be \"nullptr\".", testMultipleStatementsQuery);
+			databasesComponent->freeResultSet(*result_set);
+			return false;
+		}
+		core->printLn("Query with several statements returned their rows in order");
+		return true;
+	}
+
+	/// Tests the legacy result layout, the field names followed by the fields of each row like sqlite3_get_table
+	/// @param databaseConnection Database connection
+	/// @returns "true" if validation was successful, otherwise "false"
+	bool testLegacyDBResult(IDatabaseConnection* databaseConnection)
+	{
+		IDatabaseResultSet* result_set(executeQueryWithRowCount(databaseConnection, testQuery, Span<const DatabaseParameter>(), 2));
+		if (result_set == nullptr)
+		{
+			return false;
+		}
+		const LegacyDBResult& legacy_db_result(result_set->getLegacyDBResult());
+		if (legacy_db_result.rows != 2 || legacy_db_result.columns != 3)
+		{
+			core->printLn("[ERROR] Legacy result: %d rows and %d columns. Expected it to be \"2\" rows and \"3\" columns.", legacy_db_result.rows, legacy_db_result.columns);
+			databasesComponent->freeResultSet(*result_set);
+			return false;
+		}
+		const char* expected_results[] = { "test_string", "test_integer", "test_float", "Hello world!", "69", "420.69", "Another test!", "1337", "1.5" };
+		for (int result_index(0); result_index < 9; result_index++)
+		{
+			StringView result(legacy_db_result.results[result_index]);
+			if (result != expected_results[result_index])
+			{
+				core->printLn("[ERROR] Legacy result: \"%s\" at index \"%d\". Expected it to be \"%s\".", result.data(), result_index, expected_results[result_index]);
+				databasesComponent->freeResultSet(*result_set);
+				return false;
+			}
+		}
+		core->printLn("Legacy result: %d rows and %d columns", legacy_db_result.rows, legacy_db_result.columns);
+		databasesComponent->freeResultSet(*result_set);
+		return true;
+	}
+
+	/// Tests executing queries in the background, their results are checked when they're delivered
+	/// @param databases_component Databases component
+	void testAsyncQueries(IDatabasesComponent* databases_component)
+	{
+		mainThreadID = std::this_thread::get_id();
+
+		// Closing a connection waits for its queued queries and cancels their results
+		IDatabaseConnection* cancelled_connection(databases_component->open(testDatabaseFilePath));
+		if (cancelled_connection == nullptr)
+		{
+			core->printLn("[ERROR] Failed to open \"%s\".", testDatabaseFilePath);
+			return;
+		}
+		for (int query_index(0); query_index < 2; query_index++)
+		{
+			if (!cancelled_connection->executeQueryAsync(testQuery, Span<const DatabaseParameter>(), &asyncCancelledQueryCheck))
+			{
+				core->printLn("[ERROR] cancelled_connection->executeQueryAsync returned \"false\".");
+				databases_component->close(*cancelled_connection);
+				return;
+			}
+		}
+		databases_component->close(*cancelled_connection);
+		if (asyncCancelledQueryCheck.cancelled != 2 || asyncCancelledQueryCheck.executed != 0)
+		{
+			core->printLn("[ERROR] Closing the connection cancelled %d and delivered %d queries. Expected it to cancel \"2\" and deliver \"0\".", asyncCancelledQueryCheck.cancelled, asyncCancelledQueryCheck.executed);
+			return;
+		}
+		core->printLn("Closing the connection cancelled %d queued queries", asyncCancelledQueryCheck.cancelled);
+
+		asyncConnection = databases_component->open(testDatabaseFilePath);
+		if (asyncConnection == nullptr)
+		{
+			core->printLn("[ERROR] Failed to open \"%s\".", testDatabaseFilePath);
+			return;
+		}
+
+		// Text parameters are copied when the query is queued
+		String test_string("Another test!");
+		DatabaseParameter parameter { StringView(test_string) };
+		const bool queued(asyncConnection->executeQueryAsync(testQuery, Span<const DatabaseParameter>(), &asyncQueryCheck)
+			&& asyncConnection->executeQueryAsync(testParameterQuery, Span<const DatabaseParameter>(&parameter, 1), &asyncParameterQueryCheck)
+			&& asyncConnection->executeQueryAsync(testFailingQuery, Span<const DatabaseParameter>(), &asyncFailingQueryCheck));
+		test_string.assign(test_string.size(), '?');
+		if (!queued)
+		{
+			core->printLn("[ERROR] asyncConnection->executeQueryAsync returned \"false\".");
+			databases_component->close(*asyncConnection);
+			asyncConnection = nullptr;
+			return;
+		}
+		asyncQueriesQueued = Time::now();
+	}
+
+	/// Closes the connection of the queries executed in the background once they have been delivered or timed out
+	void onTick(Microseconds elapsed, TimePoint now) override
+	{
+		if (asyncConnection == nullptr)
+		{
+			return;
+		}
+
+		AsyncQueryCheck* checks[] = { &asyncQueryCheck, &asyncParameterQueryCheck, &asyncFailingQueryCheck };
+		bool delivered(true);
+		for (AsyncQueryCheck* check : checks)
+		{
+			delivered = delivered && check->executed != 0;
+		}
+		if (!delivered && now - asyncQueriesQueued < asyncQueryTimeout)
+		{
+			return;
+		}
+
+		for (AsyncQueryCheck* check : checks)
+		{
+			if (check->executed != 1)
+			{
+				core->printLn("[ERROR] Async %s was delivered %d times. Expected it to be delivered \"1\" time.", check->name, check->executed);
+			}
+		}
+		databasesComponent->close(*asyncConnection);
+		asyncConnection = nullptr;
+	}
+
 	/// Validates field name
 	/// @param databaseResultSet Database result set
 	/// @param fieldIndex Field index
@@ -319,7 +758,7 @@ struct DatabasesTestComponent final : public IComponent, public NoCopy
 	/// "true" if validation was successful, otherwise "false"
 	inline bool validateFieldInteger(IDatabaseResultSet* databaseResultSet, int fieldIndex, long expectedFieldInteger)
 	{
-		long field_integer(databaseResultSet->getFieldInteger(fieldIndex));
+		long field_integer(databaseResultSet->getFieldInt(fieldIndex));
 		bool ret(field_integer == expectedFieldInteger);
 		if (ret)
 		{
@@ -379,7 +818,7 @@ struct DatabasesTestComponent final : public IComponent, public NoCopy
 	/// "true" if validation was successful, otherwise "false"
 	inline bool validateFieldIntegerByName(IDatabaseResultSet* databaseResultSet, const char* fieldName, long expectedFieldInteger)
 	{
-		long field_integer(databaseResultSet->getFieldIntegerByName(fieldName));
+		long field_integer(databaseResultSet->getFieldIntByName(fieldName));
 		bool ret(field_integer == expectedFieldInteger);
 		if (ret)
 		{
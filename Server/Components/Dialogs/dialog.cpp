@@ -200,6 +200,7 @@ public:
 	{
 		core = c;
 		core->getPlayers().getPlayerConnectDispatcher().addEventHandler(this);
+		core->getPlayers().registerExtensionSlot(IPlayerDialogData::ExtensionIID);
 		NetCode::RPC::OnPlayerDialogResponse::addEventHandler(*core, &dialogResponseHandler);
 	}
 
@@ -686,6 +686,7 @@ public:
 		constexpr event_order_t EventPriority_Fixes = 100;
 		players_ = &c->getPlayers();
 		players_->getPlayerConnectDispatcher().addEventHandler(this, EventPriority_Fixes);
+		players_->registerExtensionSlot(IPlayerFixesData::ExtensionIID);
 		players_->getPlayerSpawnDispatcher().addEventHandler(this, EventPriority_Fixes);
 		players_->getPlayerDamageDispatcher().addEventHandler(this, EventPriority_Fixes);
 	}
@@ -118,6 +118,7 @@ public:
 	{
 		this->core = core;
 		this->core->getPlayers().getPlayerConnectDispatcher().addEventHandler(this);
+		this->core->getPlayers().registerExtensionSlot(IPlayerGangZoneData::ExtensionIID);
 		this->core->getPlayers().getPlayerClickDispatcher().addEventHandler(this);
 		this->core->getPlayers().getPlayerUpdateDispatcher().addEventHandler(this);
 		this->core->getPlayers().getPoolEventDispatcher().addEventHandler(this);
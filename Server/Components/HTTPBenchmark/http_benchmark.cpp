@@ -0,0 +1,234 @@
+/*
+ *  This Source Code Form is subject to the terms of the Mozilla Public License,
+ *  v. 2.0. If a copy of the MPL was not distributed with this file, You can
+ *  obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ *  The original code is copyright (c) 2022, open.mp team and contributors.
+ */
+
+#include <httplib.h>
+#include <sdk.hpp>
+#include <thread>
+
+using namespace Impl;
+
+/// Path served by the benchmark server
+const char* benchmarkPath("/benchmark");
+
+/// Body served by the benchmark server
+const char* benchmarkBody("open.mp");
+
+/// Number of requests made
+const int benchmarkRequestCount(5000);
+
+/// Most requests made per tick, like a busy script would
+const int benchmarkRequestsPerTick(100);
+
+/// Most requests waiting for their response, kept below network.http_queue_size
+const int benchmarkMaxPendingRequests(512);
+
+/// How long to wait for the responses
+const Seconds benchmarkTimeout(30);
+
+/// Measures how many ICore::requestHTTP requests to a local server are answered per second and what they cost the main thread
+struct HTTPBenchmarkComponent final : public IComponent, public CoreEventHandler, public HTTPResponseHandler, public NoCopy
+{
+	/// Core
+	ICore* core = nullptr;
+
+	/// Local server answering the requests
+	httplib::Server server;
+
+	/// Thread running the server
+	std::thread serverThread;
+
+	/// URL of the benchmark path on the local server
+	String url;
+
+	/// Whether the benchmark is running
+	bool running = false;
+
+	/// Requests made
+	int requested = 0;
+
+	/// Responses received
+	int responded = 0;
+
+	/// Responses which weren't the expected body with status 200
+	int failed = 0;
+
+	/// When the first request was made
+	TimePoint started;
+
+	/// Time spent in requestHTTP
+	Microseconds requestTime { 0 };
+
+	/// Time spent delivering responses, from the first to the last response of each tick
+	Microseconds deliveryTime { 0 };
+
+	/// When the first and last response of the current tick were delivered
+	TimePoint deliveryStart;
+	TimePoint deliveryEnd;
+
+	/// Ticks which delivered responses
+	int deliveries = 0;
+
+	/// Gets the component UID
+	/// @returns Component UID
+	UID getUID() override
+	{
+		return 0x3f6e9a1c0b7d2e58;
+	}
+
+	/// Gets the component name
+	/// @returns Component name
+	StringView componentName() const override
+	{
+		return "HTTP benchmark";
+	}
+
+	/// Gets the component type
+	/// @returns Component type
+	ComponentType componentType() const override
+	{
+		return ComponentType::Other;
+	}
+
+	/// Gets the component version
+	/// @return Component version
+	SemanticVersion componentVersion() const override
+	{
+		return SemanticVersion(OMP_VERSION_MAJOR, OMP_VERSION_MINOR, OMP_VERSION_PATCH, BUILD_NUMBER);
+	}
+
+	/// Called for every component after components have been loaded
+	/// Should be used for storing the core interface, registering player/core event handlers
+	/// Should NOT be used for interacting with other components as they might not have been initialised yet
+	/// @param c Core
+	void onLoad(ICore* c) override
+	{
+		core = c;
+		core->getEventDispatcher().addEventHandler(this);
+	}
+
+	/// Called when all components are ready, starts the local server and the benchmark
+	void onReady() override
+	{
+		server.Get(benchmarkPath, [](const httplib::Request& request, httplib::Response& response)
+			{
+				response.set_content(benchmarkBody, "text/plain");
+			});
+
+		const int port(server.bind_to_any_port("127.0.0.1"));
+		if (port <= 0)
+		{
+			core->printLn("[ERROR] Failed to start the HTTP benchmark server.");
+			return;
+		}
+		serverThread = std::thread([this]()
+			{
+				server.listen_after_bind();
+			});
+
+		const TimePoint waitStart(Time::now());
+		while (!server.is_running() && Time::now() - waitStart < Seconds(1))
+		{
+			std::this_thread::sleep_for(Milliseconds(1));
+		}
+
+		url = "127.0.0.1:" + std::to_string(port) + benchmarkPath;
+		core->printLn("HTTP benchmark: making %d requests to %s", benchmarkRequestCount, url.c_str());
+		running = true;
+	}
+
+	/// Makes the next requests, and prints the results once every response has been received or the benchmark timed out
+	void onTick(Microseconds elapsed, TimePoint now) override
+	{
+		if (!running)
+		{
+			return;
+		}
+
+		if (deliveryEnd > deliveryStart)
+		{
+			deliveryTime += duration_cast<Microseconds>(deliveryEnd - deliveryStart);
+		}
+		deliveryStart = deliveryEnd = TimePoint();
+
+		if (responded == benchmarkRequestCount || (requested != 0 && now - started > benchmarkTimeout))
+		{
+			printResults(now);
+			running = false;
+			return;
+		}
+
+		for (int count(0); count < benchmarkRequestsPerTick && requested < benchmarkRequestCount && requested - responded < benchmarkMaxPendingRequests; count++)
+		{
+			const TimePoint requestStart(Time::now());
+			if (requested == 0)
+			{
+				started = requestStart;
+			}
+			core->requestHTTP(this, HTTPRequestType_Get, url);
+			requestTime += duration_cast<Microseconds>(Time::now() - requestStart);
+			++requested;
+		}
+	}
+
+	/// Called from the core's tick for every response
+	void onHTTPResponse(int status, StringView body) override
+	{
+		const TimePoint now(Time::now());
+		if (deliveryStart == TimePoint())
+		{
+			deliveryStart = now;
+			++deliveries;
+		}
+		deliveryEnd = now;
+
+		++responded;
+		if (status != 200 || body != benchmarkBody)
+		{
+			++failed;
+		}
+	}
+
+	/// Prints the request rate and main thread cost
+	/// @param now Current time
+	void printResults(TimePoint now)
+	{
+		const double seconds(duration_cast<Microseconds>(now - started).count() / 1000000.0);
+		core->printLn("HTTP benchmark: %d of %d responses in %.3f seconds, %.0f requests per second", responded, requested, seconds, seconds > 0.0 ? responded / seconds : 0.0);
+		core->printLn("HTTP benchmark: main thread spent %.2f us per request in requestHTTP and %.2f us per response delivering %d batches", requested ? requestTime.count() / double(requested) : 0.0, responded ? deliveryTime.count() / double(responded) : 0.0, deliveries);
+		if (responded != requested)
+		{
+			core->printLn("[ERROR] HTTP benchmark: %d requests weren't answered within %d seconds.", requested - responded, int(benchmarkTimeout.count()));
+		}
+		if (failed)
+		{
+			core->printLn("[ERROR] HTTP benchmark: %d responses failed.", failed);
+		}
+	}
+
+	/// Stops the local server, the core cancels the requests in flight before components are freed
+	void free() override
+	{
+		running = false;
+		if (serverThread.joinable())
+		{
+			server.stop();
+			serverThread.join();
+		}
+		core->getEventDispatcher().removeEventHandler(this);
+	}
+
+	void reset() override
+	{
+		// Nothing to reset here.
+	}
+} httpBenchmarkComponent;
+
+COMPONENT_ENTRY_POINT()
+{
+	return &httpBenchmarkComponent;
+}
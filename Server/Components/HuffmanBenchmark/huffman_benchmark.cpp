@@ -0,0 +1,261 @@
+/*
+ *  This Source Code Form is subject to the terms of the Mozilla Public License,
+ *  v. 2.0. If a copy of the MPL was not distributed with this file, You can
+ *  obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ *  The original code is copyright (c) 2022, open.mp team and contributors.
+ */
+
+#include <Encoding/huffman_tree.hpp>
+#include <random>
+#include <sdk.hpp>
+
+using namespace Impl;
+using Encoding::DataStructures::HuffmanEncodingTree;
+
+/// Random strings encoded and decoded per frequency table
+const int huffmanCheckStrings(500);
+
+/// Random bitstreams which aren't the output of EncodeArray decoded per frequency table
+const int huffmanCheckGarbage(500);
+
+/// Longest random string or bitstream in bytes
+const int huffmanCheckMaxLength(300);
+
+/// Strings decoded by the benchmark, like a burst of chat messages
+const int huffmanBenchmarkStrings(1000);
+
+/// Length of the benchmarked strings
+const int huffmanBenchmarkLength(64);
+
+/// How many times the benchmarked strings are decoded
+const int huffmanBenchmarkRepeats(200);
+
+/// Checks that the table driven HuffmanEncodingTree::DecodeArray decodes exactly like the bit by bit DecodeBits and times both
+struct HuffmanBenchmarkComponent final : public IComponent, public NoCopy
+{
+	/// The result of decoding a bitstream
+	struct Decoded
+	{
+		unsigned count;
+		unsigned remainingBits;
+		int readOffset;
+		DynamicArray<unsigned char> output;
+
+		bool operator==(const Decoded& other) const
+		{
+			return count == other.count && remainingBits == other.remainingBits && readOffset == other.readOffset && std::equal(output.begin(), output.begin() + count, other.output.begin());
+		}
+	};
+
+	/// Core
+	ICore* core = nullptr;
+
+	/// Random input, seeded so every run checks the same strings
+	std::mt19937 random { 0x5eed };
+
+	/// Gets the component UID
+	/// @returns Component UID
+	UID getUID() override
+	{
+		return 0x7c31e9a5f04d2b68;
+	}
+
+	/// Gets the component name
+	/// @returns Component name
+	StringView componentName() const override
+	{
+		return "Huffman benchmark";
+	}
+
+	/// Gets the component type
+	/// @returns Component type
+	ComponentType componentType() const override
+	{
+		return ComponentType::Other;
+	}
+
+	/// Gets the component version
+	/// @return Component version
+	SemanticVersion componentVersion() const override
+	{
+		return SemanticVersion(OMP_VERSION_MAJOR, OMP_VERSION_MINOR, OMP_VERSION_PATCH, BUILD_NUMBER);
+	}
+
+	/// Called for every component after components have been loaded
+	/// @param c Core
+	void onLoad(ICore* c) override
+	{
+		core = c;
+	}
+
+	/// Runs the checks and the benchmark on trees of their own, the string compressor isn't touched
+	void onReady() override
+	{
+		unsigned int frequencies[256];
+
+		// Weighted like text, as the string compressor's English table is
+		std::uniform_int_distribution<unsigned int> weight(0, 1000);
+		for (int i = 0; i < 256; ++i)
+		{
+			frequencies[i] = (i >= 32 && i < 127) ? weight(random) : 0;
+		}
+		check("text", frequencies);
+		benchmark(frequencies);
+
+		// Every code is 8 bits long
+		std::fill_n(frequencies, 256, 1);
+		check("uniform", frequencies);
+
+		// Codes up to about 40 bits long, so most of them go past the decode table
+		unsigned int a = 1, b = 1;
+		for (int i = 0; i < 256; ++i)
+		{
+			frequencies[i] = i < 40 ? a : 1;
+			const unsigned int next = a + b;
+			a = b;
+			b = next;
+		}
+		check("fibonacci", frequencies);
+
+		// The weights wrap around while building the tree, giving codes too long for EncodeArray's accumulator
+		std::fill_n(frequencies, 256, 0x80000000);
+		check("overflowing", frequencies);
+	}
+
+	/// Decode a bitstream with either decoder
+	Decoded decode(HuffmanEncodingTree& tree, bool table, unsigned char* data, unsigned bytes, unsigned sizeInBits, unsigned maxChars, bool skip)
+	{
+		NetworkBitStream input(data, bytes, false);
+		Decoded decoded;
+		decoded.output.resize(maxChars);
+		decoded.remainingBits = sizeInBits;
+		if (table)
+		{
+			decoded.count = tree.DecodeArray(&input, decoded.remainingBits, maxChars, decoded.output.data(), skip);
+		}
+		else
+		{
+			decoded.count = tree.DecodeBits(&input, decoded.remainingBits, maxChars, decoded.output.data(), skip);
+		}
+		decoded.readOffset = input.GetReadOffset();
+		return decoded;
+	}
+
+	/// Decode a bitstream with both decoders, returns false if they disagree
+	bool compare(HuffmanEncodingTree& tree, unsigned char* data, unsigned bytes, unsigned sizeInBits, unsigned maxChars, bool skip)
+	{
+		return decode(tree, true, data, bytes, sizeInBits, maxChars, skip) == decode(tree, false, data, bytes, sizeInBits, maxChars, skip);
+	}
+
+	/// Round trip random strings through a tree and decode random bitstreams with it
+	void check(const char* name, unsigned int frequencies[256])
+	{
+		HuffmanEncodingTree tree;
+		tree.GenerateFromFrequencyTable(frequencies);
+
+		std::uniform_int_distribution<int> length(0, huffmanCheckMaxLength);
+		std::uniform_int_distribution<int> byte(0, 255);
+		std::bernoulli_distribution coin;
+		int roundTripErrors = 0;
+		int mismatches = 0;
+
+		for (int i = 0; i < huffmanCheckStrings; ++i)
+		{
+			DynamicArray<unsigned char> string(length(random));
+			for (unsigned char& c : string)
+			{
+				c = byte(random);
+			}
+
+			NetworkBitStream encoded;
+			tree.EncodeArray(string.data(), string.size(), &encoded);
+			const unsigned bits = encoded.GetNumberOfBitsUsed();
+			const unsigned bytes = bitsToBytes(bits);
+
+			Decoded decoded = decode(tree, true, encoded.GetData(), bytes, bits, string.size() + 1, true);
+			if (decoded.count != string.size() || !std::equal(string.begin(), string.end(), decoded.output.begin()))
+			{
+				++roundTripErrors;
+			}
+
+			// Cut the output off part way through, then the bits left over are either skipped or left to read
+			mismatches += !compare(tree, encoded.GetData(), bytes, bits, string.size() + 1, true);
+			mismatches += !compare(tree, encoded.GetData(), bytes, bits, string.size() / 2, coin(random));
+		}
+
+		for (int i = 0; i < huffmanCheckGarbage; ++i)
+		{
+			DynamicArray<unsigned char> data(length(random) + 1);
+			for (unsigned char& c : data)
+			{
+				c = byte(random);
+			}
+
+			// Any number of bits, stopping mid code, and sometimes more than the stream holds
+			const unsigned bits = std::uniform_int_distribution<unsigned>(0, bytesToBits(data.size()) + 16)(random);
+			mismatches += !compare(tree, data.data(), data.size(), bits, huffmanCheckMaxLength * 8, true);
+			mismatches += !compare(tree, data.data(), data.size(), bits, length(random), coin(random));
+		}
+
+		if (roundTripErrors || mismatches)
+		{
+			core->printLn("[ERROR] Huffman benchmark: %s tree, %d strings didn't round trip and the decoders disagreed %d times.", name, roundTripErrors, mismatches);
+		}
+		else
+		{
+			core->printLn("Huffman benchmark: %s tree, strings round trip and the decoders agree", name);
+		}
+	}
+
+	/// Time decoding the same strings with either decoder
+	void benchmark(unsigned int frequencies[256])
+	{
+		HuffmanEncodingTree tree;
+		tree.GenerateFromFrequencyTable(frequencies);
+
+		std::uniform_int_distribution<int> printable(32, 126);
+		DynamicArray<NetworkBitStream> encoded(huffmanBenchmarkStrings);
+		unsigned char string[huffmanBenchmarkLength];
+		for (NetworkBitStream& bs : encoded)
+		{
+			for (unsigned char& c : string)
+			{
+				c = printable(random);
+			}
+			tree.EncodeArray(string, huffmanBenchmarkLength, &bs);
+		}
+
+		for (const bool table : { false, true })
+		{
+			size_t decodedChars = 0;
+			const TimePoint start = Time::now();
+			for (int repeat = 0; repeat < huffmanBenchmarkRepeats; ++repeat)
+			{
+				for (NetworkBitStream& bs : encoded)
+				{
+					bs.resetReadPointer();
+					unsigned bits = bs.GetNumberOfBitsUsed();
+					decodedChars += table ? tree.DecodeArray(&bs, bits, huffmanBenchmarkLength, string, true) : tree.DecodeBits(&bs, bits, huffmanBenchmarkLength, string, true);
+				}
+			}
+			const Microseconds time = duration_cast<Microseconds>(Time::now() - start);
+			core->printLn("Huffman benchmark: %s decoded %zu characters in %.3f ms, %.2f ns per character", table ? "DecodeArray" : "DecodeBits", decodedChars, time.count() / 1000.0, decodedChars ? time.count() * 1000.0 / decodedChars : 0.0);
+		}
+	}
+
+	/// Frees this component, it isn't allocated
+	void free() override
+	{
+	}
+
+	void reset() override
+	{
+		// Nothing to reset here.
+	}
+} huffmanBenchmarkComponent;
+
+COMPONENT_ENTRY_POINT()
+{
+	return &huffmanBenchmarkComponent;
+}
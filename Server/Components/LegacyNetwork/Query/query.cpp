@@ -38,70 +38,70 @@ void writeToBuffer(char* output, char const* src, size_t& offset, size_t size)
 	offset += size;
 }
 
-void Query::buildPlayerInfoBuffer(IPlayer* except)
+std::shared_ptr<const DynamicArray<QueryBuffer>> Query::buildPlayerList(bool detailed)
 {
-	if (core == nullptr)
-	{
-		return;
-	}
-
+	auto packets = std::make_shared<DynamicArray<QueryBuffer>>();
 	const FlatPtrHashSet<IPlayer>& players = core->getPlayers().players();
-	const uint16_t playerCount = (except && !except->isBot()) ? players.size() - 1 : players.size();
+	assert(players.size() <= maxPlayers);
+
+	const size_t maxPlayerSize = detailed ? sizeof(uint8_t) + sizeof(uint8_t) + MAX_PLAYER_NAME + sizeof(int32_t) + sizeof(uint32_t) : sizeof(uint8_t) + MAX_PLAYER_NAME + sizeof(int32_t);
+	const size_t packetCount = std::max<size_t>((players.size() + MAX_QUERY_PLAYERS_PER_PACKET - 1) / MAX_QUERY_PLAYERS_PER_PACKET, 1);
+	packets->resize(packetCount);
 
-	if (playerCount > 100)
+	auto it = players.begin();
+	size_t remaining = players.size();
+	for (QueryBuffer& packet : *packets)
 	{
-		playerListBuffer.reset();
-		playerListBufferLength = 0;
-		return;
-	}
+		const uint16_t playerCount = static_cast<uint16_t>(std::min(remaining, MAX_QUERY_PLAYERS_PER_PACKET));
+		remaining -= playerCount;
+		packet.resize(BASE_QUERY_SIZE + sizeof(uint16_t) + maxPlayerSize * playerCount);
+		size_t offset = QUERY_TYPE_INDEX;
+		char* output = packet.data();
+
+		// Write 'c' or 'd' signal and the count of players in this packet
+		writeToBuffer(output, offset, static_cast<uint8_t>(detailed ? 'd' : 'c'));
+		writeToBuffer(output, offset, playerCount);
 
-	assert(playerCount <= maxPlayers);
-	playerListBufferLength = BASE_QUERY_SIZE + sizeof(uint16_t) + (sizeof(uint8_t) + MAX_PLAYER_NAME + sizeof(int32_t)) * playerCount;
-	playerListBuffer.reset(new char[playerListBufferLength]);
-	size_t offset = QUERY_TYPE_INDEX;
-	char* output = playerListBuffer.get();
+		for (uint16_t i = 0; i < playerCount; ++i, ++it)
+		{
+			IPlayer* player = *it;
+			StringView playerName = player->getName();
 
-	// Write 'c' signal and player count
-	writeToBuffer(output, offset, static_cast<uint8_t>('c'));
-	writeToBuffer(output, offset, playerCount);
+			// The protocol only has room for a byte
+			if (detailed)
+			{
+				writeToBuffer(output, offset, static_cast<uint8_t>(player->getID()));
+			}
 
-	for (IPlayer* player : players)
-	{
-		if (player == except)
-		{
-			continue;
-		}
+			// Write player name
+			const uint8_t playerNameLength = static_cast<uint8_t>(playerName.length());
+			writeToBuffer(output, offset, playerNameLength);
+			writeToBuffer(output, playerName.data(), offset, playerNameLength);
 
-		StringView playerName = player->getName();
+			// Write player score
+			writeToBuffer(output, offset, static_cast<int32_t>(player->getScore()));
 
-		// Write player name
-		const uint8_t playerNameLength = static_cast<uint8_t>(playerName.length());
-		writeToBuffer(output, offset, playerNameLength);
-		writeToBuffer(output, playerName.data(), offset, playerNameLength);
+			if (detailed)
+			{
+				writeToBuffer(output, offset, static_cast<uint32_t>(player->getPing()));
+			}
+		}
 
-		// Write player score
-		writeToBuffer(output, offset, static_cast<int32_t>(player->getScore()));
+		// Don't read (and send) uninitialized memory
+		packet.resize(offset);
 	}
-
-	// Don't read (and send) uninitialized memory
-	playerListBufferLength = offset;
+	return packets;
 }
 
-void Query::buildServerInfoBuffer()
+std::shared_ptr<const QueryBuffer> Query::buildServerInfo()
 {
-	if (core == nullptr)
-	{
-		return;
-	}
-
 	uint32_t serverNameLength = std::min(serverName.length(), MAX_ACCEPTABLE_HOSTNAME_SIZE);
 	uint32_t gameModeNameLength = std::min(gameModeName.length(), MAX_ACCEPTABLE_GMTEXT_SIZE);
 	uint32_t languageLength = std::min(language.length(), MAX_ACCEPTABLE_LANGUAGE_SIZE);
 
-	serverInfoBufferLength = BASE_QUERY_SIZE + sizeof(uint8_t) + sizeof(uint16_t) + sizeof(uint16_t) + sizeof(serverNameLength) + serverNameLength + sizeof(gameModeNameLength) + gameModeNameLength + sizeof(languageLength) + languageLength;
-	serverInfoBuffer.reset(new char[serverInfoBufferLength]);
+	auto buffer = std::make_shared<QueryBuffer>(BASE_QUERY_SIZE + sizeof(uint8_t) + sizeof(uint16_t) + sizeof(uint16_t) + sizeof(serverNameLength) + serverNameLength + sizeof(gameModeNameLength) + gameModeNameLength + sizeof(languageLength) + languageLength);
 	size_t offset = QUERY_TYPE_INDEX;
-	char* output = serverInfoBuffer.get();
+	char* output = buffer->data();
 
 	// Write `i` signal and player count details
 	writeToBuffer(output, offset, static_cast<uint8_t>('i'));
@@ -120,37 +120,14 @@ void Query::buildServerInfoBuffer()
 	// Write language name (since 0.3.7, it was map name before that)
 	writeToBuffer(output, offset, languageLength);
 	writeToBuffer(output, language.c_str(), offset, languageLength);
+	return buffer;
 }
 
-void Query::updateServerInfoBufferPlayerCount(IPlayer* except)
-{
-	if (core == nullptr)
-	{
-		return;
-	}
-
-	if (serverInfoBuffer)
-	{
-		char* output = serverInfoBuffer.get();
-		size_t offset = BASE_QUERY_SIZE + sizeof(uint8_t);
-		uint16_t playerCount = (except && !except->isBot()) ? core->getPlayers().players().size() - 1 : core->getPlayers().players().size();
-		assert(playerCount <= maxPlayers);
-		uint16_t realPlayers = maxPlayers - core->getPlayers().bots().size();
-		if (except && except->isBot())
-		{
-			++realPlayers;
-		}
-		writeToBuffer(output, offset, playerCount);
-		writeToBuffer(output, offset, realPlayers);
-	}
-}
-
-void Query::buildRulesBuffer()
+std::shared_ptr<const QueryBuffer> Query::buildRules()
 {
-	rulesBufferLength = BASE_QUERY_SIZE + sizeof(uint16_t) + rulesLength;
-	rulesBuffer.reset(new char[rulesBufferLength]);
+	auto buffer = std::make_shared<QueryBuffer>(BASE_QUERY_SIZE + sizeof(uint16_t) + rulesLength);
 	size_t offset = QUERY_TYPE_INDEX;
-	char* output = rulesBuffer.get();
+	char* output = buffer->data();
 
 	// Write 'r' signal and rule count
 	writeToBuffer(output, offset, static_cast<uint8_t>('r'));
@@ -168,18 +145,103 @@ void Query::buildRulesBuffer()
 		writeToBuffer(output, offset, ruleValueLength);
 		writeToBuffer(output, rule.second.first.c_str(), offset, ruleValueLength);
 	}
+	return buffer;
 }
 
-constexpr Span<char> getBuffer(Span<const char> input, std::unique_ptr<char[]>& buffer, size_t length)
+void Query::update(TimePoint now)
 {
-	if (!buffer)
+	if (!serverInfoChanged && !rulesChanged && !playersChanged && !detailedPlayersRequested)
 	{
-		return Span<char>();
+		return;
 	}
 
-	char* buf = buffer.get();
-	memcpy(buf, input.data(), QUERY_COPY_TO);
-	return Span<char>(buf, length);
+	if (now - lastUpdate < updateRate.load())
+	{
+		return;
+	}
+
+	lastUpdate = now;
+	publish();
+}
+
+void Query::publish()
+{
+	if (core == nullptr)
+	{
+		return;
+	}
+
+	// Unchanged responses are shared with the previous snapshot
+	std::shared_ptr<const QueryResponses> current = getResponses();
+	auto next = current ? std::make_shared<QueryResponses>(*current) : std::make_shared<QueryResponses>();
+
+	if (serverInfoChanged)
+	{
+		next->serverInfo = buildServerInfo();
+	}
+
+	if (rulesChanged)
+	{
+		next->rules = buildRules();
+	}
+
+	if (playersChanged)
+	{
+		next->players = buildPlayerList(false);
+	}
+
+	if (detailedPlayersRequested.exchange(false) || (playersChanged && next->detailedPlayers))
+	{
+		next->detailedPlayers = buildPlayerList(true);
+	}
+
+	serverInfoChanged = false;
+	rulesChanged = false;
+	playersChanged = false;
+
+	std::scoped_lock lock(responsesMutex);
+	responses = std::move(next);
+}
+
+bool Query::allowResponse(uint32_t address, size_t packets)
+{
+	const int limit = rateLimit;
+	if (limit <= 0)
+	{
+		return true;
+	}
+
+	const TimePoint now = Time::now();
+	const float capacity = float(limit);
+	std::scoped_lock lock(sourcesMutex);
+
+	if (sources.size() >= MaxTrackedSources)
+	{
+		// Addresses quiet for a second have a full bucket again, forgetting them changes nothing
+		for (auto it = sources.begin(); it != sources.end();)
+		{
+			it = now - it->second.last >= Seconds(1) ? sources.erase(it) : std::next(it);
+		}
+
+		if (sources.size() >= MaxTrackedSources)
+		{
+			sources.clear();
+		}
+	}
+
+	QuerySource& source = sources.try_emplace(address, QuerySource { capacity, now }).first->second;
+	const float elapsed = std::chrono::duration_cast<RealSeconds>(now - source.last).count();
+	source.tokens = std::min(capacity, source.tokens + elapsed * capacity);
+	source.last = now;
+
+	// Every packet is charged, a response bigger than the bucket waits for a full one and is paid back before the next
+	const float cost = float(packets);
+	if (source.tokens < std::min(capacity, cost))
+	{
+		return false;
+	}
+	source.tokens -= cost;
+	return true;
 }
 
 struct LegacyConsoleMessageHandler : ConsoleMessageHandler
@@ -264,7 +326,7 @@ Span<const char> Query::handleQuery(Span<const char> buffer, uint32_t sock, cons
 	// This is how we detect open.mp, just resend the buffer
 	if (buffer[QUERY_TYPE_INDEX] == 'o')
 	{
-		if (buffer.size() != BASE_QUERY_SIZE + sizeof(uint32_t))
+		if (buffer.size() != BASE_QUERY_SIZE + sizeof(uint32_t) || !allowResponse(client.sin_addr.s_addr, 1))
 		{
 			return Span<char>();
 		}
@@ -273,7 +335,7 @@ Span<const char> Query::handleQuery(Span<const char> buffer, uint32_t sock, cons
 	// Ping
 	else if (buffer[QUERY_TYPE_INDEX] == 'p')
 	{
-		if (buffer.size() != BASE_QUERY_SIZE + sizeof(uint32_t))
+		if (buffer.size() != BASE_QUERY_SIZE + sizeof(uint32_t) || !allowResponse(client.sin_addr.s_addr, 1))
 		{
 			return Span<char>();
 		}
@@ -281,28 +343,70 @@ Span<const char> Query::handleQuery(Span<const char> buffer, uint32_t sock, cons
 	}
 	else if (buffer.size() == BASE_QUERY_SIZE)
 	{
-		// Server info
-		if (buffer[QUERY_TYPE_INDEX] == 'i')
+		std::shared_ptr<const QueryResponses> current = getResponses();
+		if (!current)
 		{
-			return getBuffer(buffer, serverInfoBuffer, serverInfoBufferLength);
+			return Span<char>();
 		}
 
+		const QueryBuffer* response = nullptr;
+		const DynamicArray<QueryBuffer>* packets = nullptr;
+		switch (buffer[QUERY_TYPE_INDEX])
+		{
+		// Server info
+		case 'i':
+			response = current->serverInfo.get();
+			break;
+		// Rules
+		case 'r':
+			response = current->rules.get();
+			break;
 		// Players
-		else if (buffer[QUERY_TYPE_INDEX] == 'c')
+		case 'c':
+			packets = current->players.get();
+			break;
+		// Players with their ID and ping
+		case 'd':
+			detailedPlayersRequested = true;
+			packets = current->detailedPlayers.get();
+			break;
+		}
+
+		if (packets && !packets->empty())
 		{
-			return getBuffer(buffer, playerListBuffer, playerListBufferLength);
+			response = &packets->back();
 		}
 
-		// Rules
-		else if (buffer[QUERY_TYPE_INDEX] == 'r' && rulesBuffer)
+		if (response == nullptr || !allowResponse(client.sin_addr.s_addr, packets ? packets->size() : 1))
+		{
+			return Span<char>();
+		}
+
+		// The responses are shared, each one is copied to add the query's header
+		static thread_local QueryBuffer output;
+		if (packets)
 		{
-			return getBuffer(buffer, rulesBuffer, rulesBufferLength);
+			// Lists too long for one packet are sent in several, each one a valid list of some of the players
+			for (size_t i = 0; i + 1 < packets->size(); ++i)
+			{
+				const QueryBuffer& packet = (*packets)[i];
+				output.assign(packet.begin(), packet.end());
+				memcpy(output.data(), buffer.data(), QUERY_COPY_TO);
+				sendto(sock, output.data(), output.size(), 0, reinterpret_cast<const sockaddr*>(&client), tolen);
+			}
 		}
+
+		output.assign(response->begin(), response->end());
+		memcpy(output.data(), buffer.data(), QUERY_COPY_TO);
+		return Span<const char>(output.data(), output.size());
 	}
 	else if (buffer[QUERY_TYPE_INDEX] == 'x' && console && rconEnabled)
 	{
 		// RCON
-		handleRCON(buffer, sock, client, tolen);
+		if (allowResponse(client.sin_addr.s_addr, 1))
+		{
+			handleRCON(buffer, sock, client, tolen);
+		}
 	}
 
 	return Span<char>();
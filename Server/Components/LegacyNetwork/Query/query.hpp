@@ -9,13 +9,29 @@
 #pragma once
 #include "Server/Components/Console/console.hpp"
 #include "sdk.hpp"
+#include <atomic>
 #include <map>
+#include <memory>
+#include <mutex>
 
 using namespace Impl;
 
 constexpr size_t BASE_QUERY_SIZE = 11;
 constexpr size_t QUERY_TYPE_INDEX = 10;
 constexpr size_t QUERY_COPY_TO = 10;
+constexpr size_t MAX_QUERY_PLAYERS_PER_PACKET = 100;
+
+/// A query response starting with room for the header copied from each query
+using QueryBuffer = DynamicArray<char>;
+
+/// Query responses shared with the thread answering queries, never changed once published
+struct QueryResponses
+{
+	std::shared_ptr<const QueryBuffer> serverInfo;
+	std::shared_ptr<const QueryBuffer> rules;
+	std::shared_ptr<const DynamicArray<QueryBuffer>> players; ///< The client list, split in packets of at most MAX_QUERY_PLAYERS_PER_PACKET players
+	std::shared_ptr<const DynamicArray<QueryBuffer>> detailedPlayers; ///< The detailed player list, split like the client list
+};
 
 class Query : NoCopy
 {
@@ -35,20 +51,42 @@ public:
 		return console;
 	}
 
+	/// Answer a query from the published responses, safe to call from the network thread
 	Span<const char> handleQuery(Span<const char> buffer, uint32_t sock, const sockaddr_in& client, int tolen);
 	void handleRCON(Span<const char> buffer, uint32_t sock, const sockaddr_in& client, int tolen);
-	void buildRulesBuffer();
 
-	void buildPlayerDependentBuffers(IPlayer* except = nullptr)
+	/// Rebuild the changed responses and publish them, at most once per update rate
+	void update(TimePoint now);
+
+	/// Rebuild the changed responses and publish them now
+	void publish();
+
+	void markPlayersChanged()
+	{
+		playersChanged = true;
+		serverInfoChanged = true;
+	}
+
+	void markRulesChanged()
+	{
+		rulesChanged = true;
+	}
+
+	void markConfigChanged()
+	{
+		serverInfoChanged = true;
+		rulesChanged = true;
+	}
+
+	void setUpdateRate(Milliseconds value)
 	{
-		buildPlayerInfoBuffer(except);
-		updateServerInfoBufferPlayerCount(except);
+		updateRate = value;
 	}
 
-	void buildConfigDependentBuffers()
+	/// Responses sent to one address per second, with bursts of as many; 0 to disable
+	void setRateLimit(int value)
 	{
-		buildServerInfoBuffer();
-		buildRulesBuffer();
+		rateLimit = value;
 	}
 
 	void setMaxPlayers(uint16_t value)
@@ -155,19 +193,44 @@ private:
 	bool logQueries = false;
 	bool rconEnabled = false;
 
-	std::unique_ptr<char[]> playerListBuffer;
-	size_t playerListBufferLength = 0;
-
-	std::unique_ptr<char[]> serverInfoBuffer;
-	size_t serverInfoBufferLength = 0;
-
 	std::map<String, Pair<String, bool>> rules;
 	size_t rulesLength = 0;
 
-	std::unique_ptr<char[]> rulesBuffer;
-	size_t rulesBufferLength = 0;
+	bool serverInfoChanged = true;
+	bool rulesChanged = true;
+	bool playersChanged = true;
+	std::atomic_bool detailedPlayersRequested = false; ///< Set by the network thread, the detailed list has pings so it's only rebuilt once asked for
+	std::atomic<Milliseconds> updateRate = Milliseconds(0); ///< Set when the config is updated
+	TimePoint lastUpdate;
+
+	std::mutex responsesMutex;
+	std::shared_ptr<const QueryResponses> responses;
+
+	/// Tokens of an address sending queries, refilled at the rate limit
+	struct QuerySource
+	{
+		float tokens;
+		TimePoint last;
+	};
+
+	/// Addresses tracked before the ones with a full bucket are forgotten
+	static constexpr size_t MaxTrackedSources = 4096;
+
+	std::atomic_int rateLimit = 0; ///< Set when the config is updated, read by the thread answering queries
+	std::mutex sourcesMutex;
+	FlatHashMap<uint32_t, QuerySource> sources;
+
+	std::shared_ptr<const QueryResponses> getResponses()
+	{
+		std::scoped_lock lock(responsesMutex);
+		return responses;
+	}
+
+	/// Take a token for each packet sent to an address, returns false if it's over the rate limit
+	/// Responses of more packets than the bucket holds go out once it's full and leave it in debt
+	bool allowResponse(uint32_t address, size_t packets);
 
-	void buildPlayerInfoBuffer(IPlayer* except = nullptr);
-	void updateServerInfoBufferPlayerCount(IPlayer* except = nullptr);
-	void buildServerInfoBuffer();
+	std::shared_ptr<const DynamicArray<QueryBuffer>> buildPlayerList(bool detailed);
+	std::shared_ptr<const QueryBuffer> buildServerInfo();
+	std::shared_ptr<const QueryBuffer> buildRules();
 };
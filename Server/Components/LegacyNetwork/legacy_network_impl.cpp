@@ -329,6 +329,14 @@ IPlayer* RakNetLegacyNetwork::OnPeerConnect(RakNet::RPCParameters* rpcParams, bo
 	netData.networkID.port = rid.port;
 	netData.network = this;
 
+	// RakNet's ban list only matches wildcards, ranges such as CIDR bans are checked against the config's ban index
+	PeerAddress::AddressString address;
+	if (PeerAddress::ToString(netData.networkID.address, address) && address != StringView("127.0.0.1") && core->getConfig().isBanned(BanEntry(address)))
+	{
+		rakNetServer.Kick(rid);
+		return nullptr;
+	}
+
 	Pair<NewConnectionResult, IPlayer*> newConnectionResult { NewConnectionResult_Ignore, nullptr };
 
 	const bool isDL = version == LegacyClientVersion_03DL && (SAMPRakNet::GetToken() == (challenge ^ LegacyClientVersion_03DL));
@@ -557,6 +565,7 @@ void RakNetLegacyNetwork::RPCHook(RakNet::RPCParameters* rpcParams, void* extra)
 	}
 
 	NetworkBitStream bs = GetBitStream(*rpcParams);
+	ProfileScope scope(network->profiler, network->getProfileSection(true, ID));
 
 	if (!network->inEventDispatcher.stopAtFalse(
 			[&player, &bs](NetworkInEventHandler* handler)
@@ -586,10 +595,9 @@ void RakNetLegacyNetwork::RPCHook(RakNet::RPCParameters* rpcParams, void* extra)
 #endif
 }
 
-void RakNetLegacyNetwork::synchronizeBans()
+void RakNetLegacyNetwork::synchronizeBans(const BanEntry& entry)
 {
-	char addr[22] = { 0 };
-	unsigned short port;
+	PeerAddress::AddressString address;
 	for (IPlayer* player : core->getPlayers().entries())
 	{
 		const PeerNetworkData& netData = player->getNetworkData();
@@ -598,10 +606,7 @@ void RakNetLegacyNetwork::synchronizeBans()
 			continue;
 		}
 
-		const PeerNetworkData::NetworkID& nid = netData.networkID;
-		const RakNet::PlayerID rid { unsigned(nid.address.v4), nid.port };
-		rakNetServer.GetPlayerIPFromID(rid, addr, &port);
-		if (rakNetServer.IsBanned(addr))
+		if (PeerAddress::ToString(netData.networkID.address, address) && BanIndex::matches(entry.address, address))
 		{
 			player->kick();
 		}
@@ -614,7 +619,7 @@ void RakNetLegacyNetwork::ban(const BanEntry& entry, Milliseconds expire)
 	if (entry.address != StringView("127.0.0.1"))
 	{
 		rakNetServer.AddToBanList(entry.address.data(), expire.count());
-		synchronizeBans();
+		synchronizeBans(entry);
 	}
 }
 
@@ -725,6 +730,8 @@ void RakNetLegacyNetwork::update()
 	SAMPRakNet::SetLogCookies(*config.getBool("logging.log_cookies"));
 
 	query.setLogQueries(*config.getBool("logging.log_queries"));
+	query.setUpdateRate(Milliseconds(*config.getInt("network.query_update_rate")));
+	query.setRateLimit(*config.getInt("network.query_rate_limit"));
 	if (*config.getBool("enable_query"))
 	{
 		SAMPRakNet::SetQuery(&query);
@@ -778,7 +785,7 @@ void RakNetLegacyNetwork::update()
 	query.setPassworded(!password.empty());
 	rakNetServer.SetPassword(password.empty() ? 0 : password.data());
 
-	query.buildConfigDependentBuffers();
+	query.markConfigChanged();
 
 	int mtu = *config.getInt("network.mtu");
 	rakNetServer.SetMTUSize(mtu);
@@ -787,6 +794,9 @@ void RakNetLegacyNetwork::update()
 void RakNetLegacyNetwork::init(ICore* c)
 {
 	core = c;
+	profiler = queryExtension<ITickProfilerExtension>(core);
+	packetProfileSections.fill(-1);
+	rpcProfileSections.fill(-1);
 
 	core->getEventDispatcher().addEventHandler(this);
 	core->getPlayers().getPlayerChangeDispatcher().addEventHandler(this);
@@ -824,9 +834,10 @@ void RakNetLegacyNetwork::start()
 	query.setRuleValue<false>("artwork", artwork ? "Yes" : "No");
 
 	query.setMaxPlayers(maxPlayers);
-	query.buildPlayerDependentBuffers();
+	query.markPlayersChanged();
 
 	update();
+	query.publish();
 
 	for (size_t i = 0; i < config.getBansCount(); ++i)
 	{
@@ -907,76 +918,98 @@ void RakNetLegacyNetwork::handlePreConnectPacketData(int playerIndex)
 	preConnectPackets[playerIndex].clear();
 }
 
-void RakNetLegacyNetwork::onTick(Microseconds elapsed, TimePoint now)
+int RakNetLegacyNetwork::getProfileSection(bool rpc, uint8_t id)
 {
-	for (RakNet::Packet* pkt = rakNetServer.Receive(); pkt; pkt = rakNetServer.Receive())
+	if (!profiler || !profiler->isProfiling())
 	{
+		return -1;
+	}
 
-		bool mustDeallocatePacket = true;
+	int& section = rpc ? rpcProfileSections[id] : packetProfileSections[id];
+	if (section == -1)
+	{
+		section = profiler->getSection((rpc ? "rpc:" : "packet:") + std::to_string(id));
+	}
+	return section;
+}
 
-		if (pkt->playerIndex >= playerFromRakIndex.size())
-		{
-			rakNetServer.DeallocatePacket(pkt);
-			continue;
-		}
+void RakNetLegacyNetwork::handlePacket(RakNet::Packet* pkt)
+{
+	bool mustDeallocatePacket = true;
 
-		NetworkBitStream bs(pkt->data, pkt->length, false);
-		uint8_t type;
+	if (pkt->playerIndex >= playerFromRakIndex.size())
+	{
+		rakNetServer.DeallocatePacket(pkt);
+		return;
+	}
 
-		if (bs.readUINT8(type))
+	NetworkBitStream bs(pkt->data, pkt->length, false);
+	uint8_t type;
+
+	if (bs.readUINT8(type))
+	{
+		if (type == RakNet::ID_DISCONNECTION_NOTIFICATION)
 		{
-			if (type == RakNet::ID_DISCONNECTION_NOTIFICATION)
-			{
-				OnRakNetDisconnect(pkt->playerIndex, PeerDisconnectReason_Quit);
-			}
-			else if (type == RakNet::ID_CONNECTION_LOST)
+			OnRakNetDisconnect(pkt->playerIndex, PeerDisconnectReason_Quit);
+		}
+		else if (type == RakNet::ID_CONNECTION_LOST)
+		{
+			OnRakNetDisconnect(pkt->playerIndex, PeerDisconnectReason_Timeout);
+		}
+		else
+		{
+			IPlayer* player = playerFromRakIndex[pkt->playerIndex];
+			if (!player)
 			{
-				OnRakNetDisconnect(pkt->playerIndex, PeerDisconnectReason_Timeout);
+				// Here we collect custom packets sent before player is fully initialized
+				preConnectPackets[pkt->playerIndex].push_back(pkt);
+				hasUnprocessedPreConnectPackets[pkt->playerIndex] = true;
+				mustDeallocatePacket = false;
 			}
-			else
+			else if (player)
 			{
-				IPlayer* player = playerFromRakIndex[pkt->playerIndex];
-				if (!player)
+				// It usually shouldn't even go through this part,
+				// Because RakNetLegacyNetwork::OnPeerConnect will handle it before this stage
+				if (hasUnprocessedPreConnectPackets[pkt->playerIndex])
 				{
-					// Here we collect custom packets sent before player is fully initialized
-					preConnectPackets[pkt->playerIndex].push_back(pkt);
-					hasUnprocessedPreConnectPackets[pkt->playerIndex] = true;
-					mustDeallocatePacket = false;
+					handlePreConnectPacketData(pkt->playerIndex);
+					hasUnprocessedPreConnectPackets[pkt->playerIndex] = false;
 				}
-				else if (player)
-				{
-					// It usually shouldn't even go through this part,
-					// Because RakNetLegacyNetwork::OnPeerConnect will handle it before this stage
-					if (hasUnprocessedPreConnectPackets[pkt->playerIndex])
+
+				// Call event handlers for packet receive
+				ProfileScope scope(profiler, getProfileSection(false, type));
+				const bool res = inEventDispatcher.stopAtFalse([&player, type, &bs](NetworkInEventHandler* handler)
 					{
-						handlePreConnectPacketData(pkt->playerIndex);
-						hasUnprocessedPreConnectPackets[pkt->playerIndex] = false;
-					}
+						bs.SetReadOffset(8); // Ignore packet ID
+						return handler->onReceivePacket(*player, type, bs);
+					});
 
-					// Call event handlers for packet receive
-					const bool res = inEventDispatcher.stopAtFalse([&player, type, &bs](NetworkInEventHandler* handler)
+				if (res)
+				{
+					packetInEventDispatcher.stopAtFalse(type, [&player, &bs](SingleNetworkInEventHandler* handler)
 						{
 							bs.SetReadOffset(8); // Ignore packet ID
-							return handler->onReceivePacket(*player, type, bs);
+							return handler->onReceive(*player, bs);
 						});
-
-					if (res)
-					{
-						packetInEventDispatcher.stopAtFalse(type, [&player, &bs](SingleNetworkInEventHandler* handler)
-							{
-								bs.SetReadOffset(8); // Ignore packet ID
-								return handler->onReceive(*player, bs);
-							});
-					}
 				}
 			}
 		}
+	}
 
-		if (mustDeallocatePacket)
-		{
-			rakNetServer.DeallocatePacket(pkt);
-		}
+	if (mustDeallocatePacket)
+	{
+		rakNetServer.DeallocatePacket(pkt);
 	}
+}
+
+void RakNetLegacyNetwork::onTick(Microseconds elapsed, TimePoint now)
+{
+	for (RakNet::Packet* pkt = rakNetServer.Receive(); pkt; pkt = rakNetServer.Receive())
+	{
+		handlePacket(pkt);
+	}
+
+	query.update(now);
 
 	if (now - lastCookieSeed > cookieSeedTime)
 	{
@@ -9,6 +9,7 @@
 #pragma once
 
 #include "Query/query.hpp"
+#include <Impl/ban_index_impl.hpp>
 #include <Impl/network_impl.hpp>
 #include <bitstream.hpp>
 #include <core.hpp>
@@ -43,6 +44,15 @@ private:
 	Milliseconds cookieSeedTime;
 	TimePoint lastCookieSeed;
 
+	ITickProfilerExtension* profiler = nullptr;
+	StaticArray<int, 256> packetProfileSections;
+	StaticArray<int, 256> rpcProfileSections;
+
+	/// Get the profiler section timing the handlers of a packet or RPC, -1 when not profiling
+	int getProfileSection(bool rpc, uint8_t id);
+	/// Handle a packet received from RakNet and free it
+	void handlePacket(RakNet::Packet* pkt);
+
 public:
 	inline void setQueryConsole(IConsoleComponent* console)
 	{
@@ -184,6 +194,60 @@ public:
 		return rakNetServer.Send((const char*)bs.GetData(), bs.GetNumberOfBytesUsed(), RakNet::HIGH_PRIORITY, reliability, channel, rid, false);
 	}
 
+	bool sendPacketToMany(Span<IPlayer* const> peers, Span<uint8_t> data, int channel, bool dispatchEvents) override
+	{
+		// Don't use constructor because it takes bytes; we want bits
+		NetworkBitStream bs;
+		bs.SetData(data.data());
+		bs.SetWriteOffset(data.size());
+		bs.SetReadOffset(0);
+
+		uint8_t type;
+		if (!bs.readUINT8(type))
+		{
+			dispatchEvents = false;
+		}
+
+		// Every recipient gets the same encoded buffer
+		const char* bytes = (const char*)bs.GetData();
+		const int length = bs.GetNumberOfBytesUsed();
+		const RakNet::PacketReliability reliability = (channel == OrderingChannel_Reliable) ? RakNet::RELIABLE : ((channel == OrderingChannel_Unordered) ? RakNet::UNRELIABLE : RakNet::UNRELIABLE_SEQUENCED);
+		for (IPlayer* peer : peers)
+		{
+			const PeerNetworkData& netData = peer->getNetworkData();
+			if (netData.network != this)
+			{
+				continue;
+			}
+
+			if (dispatchEvents)
+			{
+				if (!outEventDispatcher.stopAtFalse([peer, type, &bs](NetworkOutEventHandler* handler)
+						{
+							bs.SetReadOffset(8); // Ignore packet ID
+							return handler->onSendPacket(peer, type, bs);
+						}))
+				{
+					continue;
+				}
+
+				if (!packetOutEventDispatcher.stopAtFalse(type, [peer, &bs](SingleNetworkOutEventHandler* handler)
+						{
+							bs.SetReadOffset(8); // Ignore packet ID
+							return handler->onSend(peer, bs);
+						}))
+				{
+					continue;
+				}
+			}
+
+			const PeerNetworkData::NetworkID& nid = netData.networkID;
+			const RakNet::PlayerID rid { unsigned(nid.address.v4), nid.port };
+			rakNetServer.Send(bytes, length, RakNet::HIGH_PRIORITY, reliability, channel, rid, false);
+		}
+		return true;
+	}
+
 	bool broadcastRPC(int id, Span<uint8_t> data, int channel, const IPlayer* exceptPeer, bool dispatchEvents) override
 	{
 		if (id == INVALID_PACKET_ID)
@@ -294,24 +358,24 @@ public:
 
 	void onPlayerScoreChange(IPlayer& player, int score) override
 	{
-		query.buildPlayerDependentBuffers();
+		query.markPlayersChanged();
 	}
 
 	void onPlayerNameChange(IPlayer& player, StringView oldName) override
 	{
-		query.buildPlayerDependentBuffers();
+		query.markPlayersChanged();
 	}
 
 	void update() override;
 
 	void onPlayerConnect(IPlayer& player) override
 	{
-		query.buildPlayerDependentBuffers();
+		query.markPlayersChanged();
 	}
 
 	void onPlayerDisconnect(IPlayer& player, PeerDisconnectReason reason) override
 	{
-		query.buildPlayerDependentBuffers(&player);
+		query.markPlayersChanged();
 	}
 
 	bool addRule(StringView rule, StringView value) override
@@ -322,7 +386,7 @@ public:
 		}
 
 		query.setRuleValue<true>(String(rule), String(value));
-		query.buildRulesBuffer();
+		query.markRulesChanged();
 		return true;
 	}
 
@@ -334,7 +398,7 @@ public:
 		}
 
 		query.removeRule(rule);
-		query.buildRulesBuffer();
+		query.markRulesChanged();
 		return true;
 	}
 
@@ -357,8 +421,8 @@ public:
 
 	void handlePreConnectPacketData(int playerIndex);
 
-	/// Synchronize players after banning an IP, kicking any that match the banned IP
-	void synchronizeBans();
+	/// Synchronize players after banning an IP or range, kicking any that match the ban
+	void synchronizeBans(const BanEntry& entry);
 
 	NetworkStats getStatistics(IPlayer* player = nullptr) override;
 
@@ -114,6 +114,7 @@ public:
 		this->core = core;
 		players = &core->getPlayers();
 		players->getPlayerConnectDispatcher().addEventHandler(this);
+		players->registerExtensionSlot(IPlayerMenuData::ExtensionIID);
 		players->getPoolEventDispatcher().addEventHandler(this);
 		NetCode::RPC::OnPlayerSelectedMenuRow::addEventHandler(*core, &playerSelectedMenuRowEventHandler);
 		NetCode::RPC::OnPlayerExitedMenu::addEventHandler(*core, &playerExitedMenuEventHandler);
@@ -17,6 +17,17 @@ Object::~Object()
 
 void Object::destream()
 {
+	if (objects_.isStreamingObjects())
+	{
+		// Copied as streaming out removes the player from the set
+		const DynamicArray<IPlayer*> streamed(streamedFor_.entries().begin(), streamedFor_.entries().end());
+		for (IPlayer* player : streamed)
+		{
+			streamOutForPlayer(*player);
+		}
+		return;
+	}
+
 	for (IPlayer* player : objects_.getPlayers().entries())
 	{
 		destroyForPlayer(*player);
@@ -25,12 +36,59 @@ void Object::destream()
 
 void Object::restream()
 {
-	for (IPlayer* player : objects_.getPlayers().entries())
+	const FlatPtrHashSet<IPlayer>& players = objects_.isStreamingObjects() ? streamedFor_.entries() : objects_.getPlayers().entries();
+	for (IPlayer* player : players)
 	{
 		createObjectForClient(*player);
 	}
 }
 
+void Object::streamInForPlayer(IPlayer& player)
+{
+	const int pid = player.getID();
+	if (streamedFor_.valid(pid))
+	{
+		return;
+	}
+
+	streamedFor_.add(pid, player);
+	objects_.getStreamIndex().streamedIn(player, poolID);
+	createForPlayer(player);
+}
+
+void Object::streamOutForPlayer(IPlayer& player)
+{
+	const int pid = player.getID();
+	if (!streamedFor_.valid(pid))
+	{
+		return;
+	}
+
+	streamedFor_.remove(pid, player);
+	destroyForPlayer(player);
+}
+
+template <class Packet>
+void Object::broadcastToCreated(const Packet& packet)
+{
+	if (objects_.isStreamingObjects())
+	{
+		PacketHelper::broadcastToSome(packet, streamedFor_.entries());
+	}
+	else
+	{
+		PacketHelper::broadcast(packet, objects_.getPlayers());
+	}
+}
+
+void Object::updateStreamIndex()
+{
+	if (objects_.isStreamingObjects())
+	{
+		objects_.getStreamIndex().update(*this, isLocated());
+	}
+}
+
 void Object::move(const ObjectMoveData& data)
 {
 	if (isMoving())
@@ -39,7 +97,8 @@ void Object::move(const ObjectMoveData& data)
 	}
 
 	addToProcessed();
-	PacketHelper::broadcast(moveRPC(data), objects_.getPlayers());
+	updateStreamIndex();
+	broadcastToCreated(moveRPC(data));
 }
 
 void Object::addToProcessed()
@@ -67,8 +126,9 @@ void Object::eraseFromProcessed(bool force)
 
 void Object::stop()
 {
-	PacketHelper::broadcast(stopMove(), objects_.getPlayers());
+	broadcastToCreated(stopMove());
 	eraseFromProcessed(false /* force */);
+	updateStreamIndex();
 }
 
 bool Object::advance(Microseconds elapsed, TimePoint now)
@@ -120,6 +180,7 @@ bool Object::advance(Microseconds elapsed, TimePoint now)
 	if (res)
 	{
 		eraseFromProcessed(false /* force */);
+		updateStreamIndex();
 	}
 	return res;
 }
@@ -131,7 +192,8 @@ void Object::setPosition(Vector3 position)
 	NetCode::RPC::SetObjectPosition setObjectPositionRPC;
 	setObjectPositionRPC.ObjectID = poolID;
 	setObjectPositionRPC.Position = position;
-	PacketHelper::broadcast(setObjectPositionRPC, objects_.getPlayers());
+	broadcastToCreated(setObjectPositionRPC);
+	updateStreamIndex();
 }
 
 void Object::setRotation(GTAQuat rotation)
@@ -141,7 +203,7 @@ void Object::setRotation(GTAQuat rotation)
 	NetCode::RPC::SetObjectRotation setObjectRotationRPC;
 	setObjectRotationRPC.ObjectID = poolID;
 	setObjectRotationRPC.Rotation = rotation.ToEuler();
-	PacketHelper::broadcast(setObjectRotationRPC, objects_.getPlayers());
+	broadcastToCreated(setObjectRotationRPC);
 }
 
 void Object::attachToPlayer(IPlayer& player, Vector3 offset, Vector3 rotation)
@@ -153,15 +215,30 @@ void Object::attachToPlayer(IPlayer& player, Vector3 offset, Vector3 rotation)
 	attachObjectToPlayerRPC.PlayerID = id;
 	attachObjectToPlayerRPC.Offset = offset;
 	attachObjectToPlayerRPC.Rotation = rotation;
-	PacketHelper::broadcastToStreamed(attachObjectToPlayerRPC, player);
+	if (objects_.isStreamingObjects())
+	{
+		for (IPlayer* other : streamedFor_.entries())
+		{
+			if (player.isStreamedInForPlayer(*other))
+			{
+				PacketHelper::send(attachObjectToPlayerRPC, *other);
+			}
+		}
+	}
+	else
+	{
+		PacketHelper::broadcastToStreamed(attachObjectToPlayerRPC, player);
+	}
 
 	objects_.getAttachedToPlayers().insert(this);
+	updateStreamIndex();
 }
 
 void Object::resetAttachment()
 {
 	objects_.getAttachedToPlayers().erase(this);
 	this->BaseObject<IObject>::resetAttachment();
+	updateStreamIndex();
 	restream();
 }
 
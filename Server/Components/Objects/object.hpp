@@ -59,6 +59,12 @@ public:
 		return attachmentData_;
 	}
 
+	/// Get the approximate size of the object's CreateObject RPC
+	size_t getCreateObjectSize()
+	{
+		return NetCode::RPC::CreateObject(materials_, materialsCount_, false).expectedSize();
+	}
+
 	const ObjectMoveData& getMovingData() const override
 	{
 		return moveData_;
@@ -325,8 +331,18 @@ private:
 	StaticArray<TimePoint, PLAYER_POOL_SIZE> delayedProcessingTime_;
 	ObjectComponent& objects_;
 
+	/// Players the object is created for when the object streamer is enabled, otherwise it's created for everyone
+	UniqueIDArray<IPlayer, PLAYER_POOL_SIZE> streamedFor_;
+
 	void restream();
 
+	/// Send a packet to the players the object is created for
+	template <class Packet>
+	void broadcastToCreated(const Packet& packet);
+
+	/// Move the object in the component's stream index after its position or attachment changed
+	void updateStreamIndex();
+
 	void addToProcessed();
 	void eraseFromProcessed(bool force);
 
@@ -355,6 +371,31 @@ public:
 		destroyObjectForClient(player);
 	}
 
+	bool isStreamedInForPlayer(const IPlayer& player) const
+	{
+		return streamedFor_.valid(player.getID());
+	}
+
+	void streamInForPlayer(IPlayer& player);
+
+	void streamOutForPlayer(IPlayer& player);
+
+	/// Forget a disconnecting player without sending them anything
+	void removeFor(int pid, IPlayer& player)
+	{
+		if (streamedFor_.valid(pid))
+		{
+			streamedFor_.remove(pid, player);
+		}
+		delayedProcessing_.reset(pid);
+	}
+
+	/// Whether the object has a position of its own to be streamed by, moving objects are re-indexed when they arrive
+	bool isLocated() const
+	{
+		return !isMoving() && getAttachmentData().type == ObjectAttachmentData::Type::None;
+	}
+
 	Object(ObjectComponent& objects, int modelID, Vector3 position, Vector3 rotation, float drawDist, bool cameraCollision)
 		: BaseObject(modelID, position, rotation, drawDist, cameraCollision)
 		, objects_(objects)
@@ -410,12 +451,14 @@ public:
 	virtual void attachToObject(IObject& object, Vector3 offset, Vector3 rotation, bool syncRotation) override
 	{
 		setAttachmentData(ObjectAttachmentData::Type::Object, static_cast<Object&>(object).poolID, offset, rotation, syncRotation);
+		updateStreamIndex();
 		restream();
 	}
 
 	void attachToVehicle(IVehicle& vehicle, Vector3 offset, Vector3 rotation) override
 	{
 		setAttachmentData(ObjectAttachmentData::Type::Vehicle, vehicle.getID(), offset, rotation, true);
+		updateStreamIndex();
 		restream();
 	}
 
@@ -9,11 +9,12 @@
 #pragma once
 
 #include "object.hpp"
+#include <Impl/spatial_index_impl.hpp>
 #include <Server/Components/Vehicles/vehicles.hpp>
 #include <Server/Components/CustomModels/custommodels.hpp>
 #include <netcode.hpp>
 
-class ObjectComponent final : public IObjectsComponent, public CoreEventHandler, public PlayerConnectEventHandler, public PlayerStreamEventHandler, public PlayerSpawnEventHandler, public PoolEventHandler<IPlayer>, public PlayerModelsEventHandler
+class ObjectComponent final : public IObjectsComponent, public CoreEventHandler, public PlayerConnectEventHandler, public PlayerStreamEventHandler, public PlayerSpawnEventHandler, public PoolEventHandler<IPlayer>, public PlayerModelsEventHandler, public PlayerUpdateEventHandler
 {
 private:
 	ICore* core = nullptr;
@@ -28,8 +29,30 @@ private:
 	bool defCameraCollision = true;
 
 	ICustomModelsComponent* models = nullptr;
+	IVehiclesComponent* vehicles = nullptr;
 	bool compatModeEnabled = false;
 	bool* groupPlayerObjects = nullptr;
+	int* objectCreationBudget = nullptr;
+
+	/// Players with global objects waiting to be created for them
+	FlatPtrHashSet<PlayerObjectData> creatingGlobalObjects;
+
+	/// Whether global objects are only created for players near them, read once as it can't change with objects created
+	bool streamObjects = false;
+	float objectStreamRadius = 0.0f;
+	StreamConfigHelper streamConfigHelper;
+	PoolStreamIndex<Object> streamIndex;
+
+	/// Create the global objects for a player, queueing them to be created over the next ticks if there's a creation budget
+	void createGlobalObjects(PlayerObjectData& data);
+
+	/// Create a player's queued global objects until the budget is spent, nearest to their spawn first
+	/// Returns true once all of them have been created
+	bool createQueuedGlobalObjects(PlayerObjectData& data, size_t budget);
+
+	/// Get the position of what an attached object hangs off, following attached objects to the root of the chain
+	/// Returns false if anything in the chain doesn't exist, e.g. the parent object was destroyed
+	bool locateAttachment(const Object& object, Vector3& position);
 
 	struct PlayerSelectObjectEventHandler : public SingleNetworkInEventHandler
 	{
@@ -243,6 +266,7 @@ public:
 		players->getPlayerSpawnDispatcher().addEventHandler(this, EventPriority::EventPriority_FairlyHigh + 1 /* want this to be called before Pawn */);
 		players->getPlayerStreamDispatcher().addEventHandler(this, EventPriority::EventPriority_FairlyLow - 1 /* want this to be called after Pawn but before Core */);
 		players->getPlayerConnectDispatcher().addEventHandler(this, EventPriority::EventPriority_FairlyLow - 1 /* want this to be called after Pawn but before Core */);
+		players->registerExtensionSlot(IPlayerObjectData::ExtensionIID);
 		players->getPoolEventDispatcher().addEventHandler(this);
 		NetCode::RPC::OnPlayerSelectObject::addEventHandler(*core, &playerSelectObjectEventHandler);
 		NetCode::RPC::OnPlayerEditObject::addEventHandler(*core, &playerEditObjectEventHandler);
@@ -251,11 +275,23 @@ public:
 		bool* artwork = core->getConfig().getBool("artwork.enable");
 		compatModeEnabled = (!artwork || !*artwork || (*artwork && *core->getConfig().getBool("network.allow_037_clients")));
 		groupPlayerObjects = core->getConfig().getBool("game.group_player_objects");
+		objectCreationBudget = core->getConfig().getInt("network.object_creation_budget");
+
+		bool* useStreamer = core->getConfig().getBool("network.use_object_streamer");
+		float* streamRadius = core->getConfig().getFloat("network.object_stream_radius");
+		streamObjects = useStreamer && *useStreamer;
+		objectStreamRadius = streamRadius ? *streamRadius : 0.0f;
+		streamConfigHelper = StreamConfigHelper(core->getConfig());
+		if (streamObjects)
+		{
+			players->getPlayerUpdateDispatcher().addEventHandler(this);
+		}
 	}
 
 	void onInit(IComponentList* components) override
 	{
 		models = components->queryComponent<ICustomModelsComponent>();
+		vehicles = components->queryComponent<IVehiclesComponent>();
 
 		if (models)
 		{
@@ -269,6 +305,10 @@ public:
 		{
 			models = nullptr;
 		}
+		else if (component == vehicles)
+		{
+			vehicles = nullptr;
+		}
 	}
 
 	~ObjectComponent()
@@ -290,6 +330,10 @@ public:
 			players->getPlayerStreamDispatcher().removeEventHandler(this);
 			players->getPlayerSpawnDispatcher().removeEventHandler(this);
 			players->getPoolEventDispatcher().removeEventHandler(this);
+			if (streamObjects)
+			{
+				players->getPlayerUpdateDispatcher().removeEventHandler(this);
+			}
 			NetCode::RPC::OnPlayerSelectObject::removeEventHandler(*core, &playerSelectObjectEventHandler);
 			NetCode::RPC::OnPlayerEditObject::removeEventHandler(*core, &playerEditObjectEventHandler);
 			NetCode::RPC::OnPlayerEditAttachedObject::removeEventHandler(*core, &playerEditAttachedObjectEventHandler);
@@ -352,6 +396,13 @@ public:
 		}
 
 		Object* obj = storage.get(objid);
+		if (streamObjects)
+		{
+			// Created for players near it on their next stream update
+			streamIndex.onPoolEntryCreated(*obj);
+			return obj;
+		}
+
 		for (IPlayer* player : players->entries())
 		{
 			obj->createForPlayer(*player);
@@ -385,12 +436,26 @@ public:
 		if (obj)
 		{
 			obj->destream();
+			if (streamObjects)
+			{
+				streamIndex.onPoolEntryDestroyed(*obj);
+			}
 			storage.release(index, false);
 			processedObjects.erase(obj);
 			attachedToPlayer.erase(obj);
+			unqueueGlobalObject(index);
 		}
 	}
 
+	/// Stop a global object from being created for the players it's queued for, the ID may be reused by an object which is created for them straight away
+	void unqueueGlobalObject(int index);
+
+	/// Stop creating global objects for a player
+	void stopCreatingGlobalObjects(PlayerObjectData& data)
+	{
+		creatingGlobalObjects.erase(&data);
+	}
+
 	void lock(int index) override
 	{
 		storage.lock(index);
@@ -451,11 +516,27 @@ public:
 
 	void onTick(Microseconds elapsed, TimePoint now) override;
 
+	bool onPlayerUpdate(IPlayer& player, TimePoint now) override;
+
+	bool isStreamingObjects() const
+	{
+		return streamObjects;
+	}
+
+	PoolStreamIndex<Object>& getStreamIndex()
+	{
+		return streamIndex;
+	}
+
 	void reset() override
 	{
 		// Destroy all stored entity instances.
 		processedPlayerObjects.clear();
 		processedObjects.clear();
+		for (IObject* object : storage)
+		{
+			streamIndex.onPoolEntryDestroyed(*static_cast<Object*>(object));
+		}
 		storage.clear();
 		isPlayerObject.fill(0);
 		defCameraCollision = true;
@@ -485,6 +566,11 @@ private:
 	bool inObjectEdit_;
 	bool streamedGlobalObjects_;
 
+	/// Global objects waiting to be created for the player, nearest to their spawn last once sorted
+	DynamicArray<int> queuedGlobalObjects_;
+	StaticBitset<OBJECT_POOL_SIZE> queuedGlobalObjectIDs_;
+	bool queuedGlobalObjectsSorted_ = false;
+
 public:
 	// TODO: const.
 	inline IPlayer& getPlayer()
@@ -642,6 +728,8 @@ public:
 		inObjectEdit_ = false;
 		inObjectSelection_ = false;
 		streamedGlobalObjects_ = false;
+		clearQueuedGlobalObjects();
+		component_.stopCreatingGlobalObjects(*this);
 		slotsOccupied_.reset();
 		storage.clear();
 		attachedToPlayer_.clear();
@@ -764,6 +852,72 @@ public:
 		streamedGlobalObjects_ = value;
 	}
 
+	void queueGlobalObject(int id)
+	{
+		queuedGlobalObjects_.push_back(id);
+		queuedGlobalObjectIDs_.set(id);
+		queuedGlobalObjectsSorted_ = false;
+	}
+
+	/// Put back an object popped from the queue, it stays the next one to be created
+	void requeueGlobalObject(int id)
+	{
+		queuedGlobalObjects_.push_back(id);
+		queuedGlobalObjectIDs_.set(id);
+	}
+
+	void unqueueGlobalObject(int id)
+	{
+		queuedGlobalObjectIDs_.reset(id);
+	}
+
+	void clearQueuedGlobalObjects()
+	{
+		queuedGlobalObjects_.clear();
+		queuedGlobalObjectIDs_.reset();
+	}
+
+	/// Get the next queued global object to create and remove it from the queue, -1 if there are none left
+	int popQueuedGlobalObject()
+	{
+		while (!queuedGlobalObjects_.empty())
+		{
+			const int id = queuedGlobalObjects_.back();
+			queuedGlobalObjects_.pop_back();
+			if (queuedGlobalObjectIDs_.test(id))
+			{
+				queuedGlobalObjectIDs_.reset(id);
+				return id;
+			}
+		}
+		return -1;
+	}
+
+	/// Sort the queued global objects by distance from a position, call before popping them
+	template <class GetPosition>
+	void sortQueuedGlobalObjects(Vector3 from, GetPosition getPosition)
+	{
+		if (queuedGlobalObjectsSorted_)
+		{
+			return;
+		}
+		queuedGlobalObjectsSorted_ = true;
+
+		DynamicArray<Pair<float, int>> distances;
+		distances.reserve(queuedGlobalObjects_.size());
+		for (int id : queuedGlobalObjects_)
+		{
+			const Vector3 offset = getPosition(id) - from;
+			distances.emplace_back(glm::dot(offset, offset), id);
+		}
+		// Furthest first so the nearest is popped from the back
+		std::sort(distances.begin(), distances.end(), std::greater<Pair<float, int>>());
+		for (size_t i = 0; i != distances.size(); ++i)
+		{
+			queuedGlobalObjects_[i] = distances[i].second;
+		}
+	}
+
 	ObjectComponent& getComponent()
 	{
 		return component_;
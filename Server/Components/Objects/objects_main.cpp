@@ -7,6 +7,8 @@
  */
 
 #include "objects_impl.hpp"
+#include <Server/Components/Classes/classes.hpp>
+#include <limits>
 
 void ObjectComponent::onTick(Microseconds elapsed, TimePoint now)
 {
@@ -29,6 +31,215 @@ void ObjectComponent::onTick(Microseconds elapsed, TimePoint now)
 			eventDispatcher.dispatch(&ObjectEventHandler::onPlayerObjectMoved, obj->getObjects().getPlayer(), *obj);
 		}
 	}
+
+	if (!creatingGlobalObjects.empty())
+	{
+		const size_t budget = objectCreationBudget && *objectCreationBudget > 0 ? *objectCreationBudget : SIZE_MAX;
+		DynamicArray<IPlayer*> created;
+		for (auto it = creatingGlobalObjects.begin(); it != creatingGlobalObjects.end();)
+		{
+			PlayerObjectData* data = *it;
+			if (createQueuedGlobalObjects(*data, budget))
+			{
+				it = creatingGlobalObjects.erase(it);
+				created.push_back(&data->getPlayer());
+			}
+			else
+			{
+				++it;
+			}
+		}
+
+		// Dispatched afterwards as handlers may kick players, which removes them from the set
+		for (IPlayer* player : created)
+		{
+			eventDispatcher.dispatch(&ObjectEventHandler::onPlayerGlobalObjectsCreated, *player);
+		}
+	}
+}
+
+bool ObjectComponent::onPlayerUpdate(IPlayer& player, TimePoint now)
+{
+	const int pid = player.getID();
+	if (!streamConfigHelper.shouldStream(pid, now))
+	{
+		return true;
+	}
+
+	// Nothing is created before the player is ready for global objects, e.g. while downloading models
+	PlayerObjectData* data = queryExtension<PlayerObjectData>(player);
+	if (!data || !data->getStreamedGlobalObjects())
+	{
+		return true;
+	}
+
+	const Vector3 pos = player.getPosition();
+	const float maxDistSqr = objectStreamRadius * objectStreamRadius;
+	const bool spawned = player.getState() != PlayerState_None;
+	streamIndex.forEachCandidate(
+		storage, player, pos, 0, objectStreamRadius, [&](Object& object)
+		{
+			// Attached objects are streamed by the position of the root of their chain, those with a missing parent aren't streamed in
+			Vector3 located;
+			const bool resolved = locateAttachment(object, located);
+			const Vector3 offset = located - pos;
+			const float distSqr = glm::dot(offset, offset);
+			const bool isStreamedIn = object.isStreamedInForPlayer(player);
+			bool shouldBeStreamedIn = resolved && spawned && distSqr < maxDistSqr;
+
+			// The client attaches to the parent by its ID, so it goes first and the child follows on the next update
+			const ObjectAttachmentData& attachment = object.getAttachmentData();
+			if (shouldBeStreamedIn && !isStreamedIn && attachment.type == ObjectAttachmentData::Type::Object)
+			{
+				Object* parent = storage.get(attachment.ID);
+				shouldBeStreamedIn = parent && parent->isStreamedInForPlayer(player);
+			}
+
+			if (!isStreamedIn && shouldBeStreamedIn)
+			{
+				streamIndex.queueStreamIn(object, distSqr);
+			}
+			else if (isStreamedIn && !shouldBeStreamedIn)
+			{
+				object.streamOutForPlayer(player);
+			}
+		},
+		[this](Object& object)
+		{
+			// Unresolved chains are never near anyone
+			Vector3 located;
+			return locateAttachment(object, located) ? located : Vector3(std::numeric_limits<float>::infinity());
+		});
+
+	const bool waiting = streamIndex.streamInNearest(storage, streamConfigHelper.getStreamInBudget(), [&player](Object& object)
+		{
+			object.streamInForPlayer(player);
+		});
+	if (waiting)
+	{
+		streamConfigHelper.requestStream(pid);
+	}
+	return true;
+}
+
+bool ObjectComponent::locateAttachment(const Object& object, Vector3& position)
+{
+	const Object* root = &object;
+	for (int depth = 0; root->getAttachmentData().type == ObjectAttachmentData::Type::Object; ++depth)
+	{
+		// Objects attached to each other in a loop have no root
+		if (depth == OBJECT_POOL_SIZE)
+		{
+			return false;
+		}
+		root = storage.get(root->getAttachmentData().ID);
+		if (!root)
+		{
+			return false;
+		}
+	}
+
+	const ObjectAttachmentData& attachment = root->getAttachmentData();
+	switch (attachment.type)
+	{
+	case ObjectAttachmentData::Type::Vehicle:
+	{
+		IVehicle* vehicle = vehicles ? vehicles->get(attachment.ID) : nullptr;
+		if (!vehicle)
+		{
+			return false;
+		}
+		position = vehicle->getPosition();
+		return true;
+	}
+	case ObjectAttachmentData::Type::Player:
+	{
+		IPlayer* player = players->get(attachment.ID);
+		if (!player)
+		{
+			return false;
+		}
+		position = player->getPosition();
+		return true;
+	}
+	default:
+		position = root->getPosition();
+		return true;
+	}
+}
+
+void ObjectComponent::createGlobalObjects(PlayerObjectData& data)
+{
+	data.setStreamedGlobalObjects(true);
+	data.clearQueuedGlobalObjects();
+
+	// The streamer creates the objects near the player as they move around
+	if (streamObjects)
+	{
+		streamConfigHelper.requestStream(data.getPlayer().getID());
+		eventDispatcher.dispatch(&ObjectEventHandler::onPlayerGlobalObjectsCreated, data.getPlayer());
+		return;
+	}
+
+	// Without a budget create them all at once like SA:MP
+	if (!objectCreationBudget || *objectCreationBudget <= 0)
+	{
+		for (IObject* o : storage)
+		{
+			Object* obj = static_cast<Object*>(o);
+			obj->createForPlayer(data.getPlayer());
+		}
+		eventDispatcher.dispatch(&ObjectEventHandler::onPlayerGlobalObjectsCreated, data.getPlayer());
+		return;
+	}
+
+	// Sorted on the first tick, after scripts had the chance to set the spawn position on connect
+	for (IObject* o : storage)
+	{
+		data.queueGlobalObject(o->getID());
+	}
+	creatingGlobalObjects.insert(&data);
+}
+
+bool ObjectComponent::createQueuedGlobalObjects(PlayerObjectData& data, size_t budget)
+{
+	IPlayer& player = data.getPlayer();
+	IPlayerClassData* classData = queryExtension<IPlayerClassData>(player);
+	const Vector3 spawn = classData ? classData->getClass().spawn : player.getPosition();
+	data.sortQueuedGlobalObjects(spawn, [this](int id)
+		{
+			Object* obj = storage.get(id);
+			return obj ? obj->getPosition() : Vector3(0.0f, 0.0f, 0.0f);
+		});
+
+	size_t spent = 0;
+	for (int id = data.popQueuedGlobalObject(); id != -1; id = data.popQueuedGlobalObject())
+	{
+		Object* obj = storage.get(id);
+		if (!obj)
+		{
+			continue;
+		}
+
+		// At least one object per tick so an object bigger than the budget still gets created
+		const size_t size = obj->getCreateObjectSize();
+		if (spent != 0 && spent + size > budget)
+		{
+			data.requeueGlobalObject(id);
+			return false;
+		}
+		spent += size;
+		obj->createForPlayer(player);
+	}
+	return true;
+}
+
+void ObjectComponent::unqueueGlobalObject(int index)
+{
+	for (PlayerObjectData* data : creatingGlobalObjects)
+	{
+		data->unqueueGlobalObject(index);
+	}
 }
 
 void ObjectComponent::onPlayerConnect(IPlayer& player)
@@ -42,12 +253,7 @@ void ObjectComponent::onPlayerConnect(IPlayer& player)
 	auto playerData = reinterpret_cast<PlayerObjectData*>(queryExtension<IPlayerObjectData>(player));
 	if (playerData)
 	{
-		playerData->setStreamedGlobalObjects(true);
-		for (IObject* o : storage)
-		{
-			Object* obj = static_cast<Object*>(o);
-			obj->createForPlayer(player);
-		}
+		createGlobalObjects(*playerData);
 	}
 }
 
@@ -65,12 +271,7 @@ void ObjectComponent::onPlayerFinishedDownloading(IPlayer& player)
 		return;
 	}
 
-	player_data->setStreamedGlobalObjects(true);
-	for (IObject* o : storage)
-	{
-		Object* obj = static_cast<Object*>(o);
-		obj->createForPlayer(player);
-	}
+	createGlobalObjects(*player_data);
 }
 
 void ObjectComponent::onPlayerStreamIn(IPlayer& player, IPlayer& forPlayer)
@@ -78,6 +279,11 @@ void ObjectComponent::onPlayerStreamIn(IPlayer& player, IPlayer& forPlayer)
 	const int pid = player.getID();
 	for (Object* object : attachedToPlayer)
 	{
+		if (streamObjects && !object->isStreamedInForPlayer(forPlayer))
+		{
+			continue;
+		}
+
 		const ObjectAttachmentData& attachment = object->getAttachmentData();
 		if (attachment.type == ObjectAttachmentData::Type::Player && attachment.ID == pid)
 		{
@@ -138,7 +344,22 @@ void ObjectComponent::onPlayerStreamOut(IPlayer& player, IPlayer& forPlayer)
 
 void ObjectComponent::onPoolEntryDestroyed(IPlayer& player)
 {
+	PlayerObjectData* data = queryExtension<PlayerObjectData>(player);
+	if (data)
+	{
+		creatingGlobalObjects.erase(data);
+	}
+
 	const int pid = player.getID();
+	if (streamObjects)
+	{
+		for (IObject* object : storage)
+		{
+			static_cast<Object*>(object)->removeFor(pid, player);
+		}
+		streamIndex.removePlayer(player);
+	}
+
 	for (IObject* obj : attachedToPlayer)
 	{
 		if (obj->getAttachmentData().ID == pid)
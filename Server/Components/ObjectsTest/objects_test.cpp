@@ -0,0 +1,296 @@
+/*
+ *  This Source Code Form is subject to the terms of the Mozilla Public License,
+ *  v. 2.0. If a copy of the MPL was not distributed with this file, You can
+ *  obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ *  The original code is copyright (c) 2022, open.mp team and contributors.
+ */
+
+#include <Server/Components/Classes/classes.hpp>
+#include <Server/Components/Objects/objects.hpp>
+#include <netcode.hpp>
+#include <random>
+#include <sdk.hpp>
+
+using namespace Impl;
+
+/// Global objects created by the test, scattered around the map
+const int testObjectCount(400);
+
+/// Every this many objects gets a material text, making their creation bigger
+const int testMaterialTextEvery(10);
+
+/// What one player was sent of the test's global objects since they connected
+struct PlayerObjectCreation
+{
+	/// Test objects in the order they were created for the player
+	DynamicArray<int> order;
+
+	/// Test objects created for the player
+	FlatHashSet<int> created;
+
+	/// Per tick, the size hints of the test objects created for the player
+	FlatHashMap<int, size_t> spent;
+
+	/// Per tick, how many test objects were created for the player
+	FlatHashMap<int, int> count;
+
+	/// Where the objects are created from, the player's spawn when the first one was created
+	Vector3 spawn;
+
+	/// Set once the objects component said all global objects were created for the player
+	bool done = false;
+};
+
+/// Checks global objects are created for joining players over several ticks: each test object exactly once,
+/// nearest to the player's spawn first, within network.object_creation_budget per tick unless a single object is over it,
+/// and onPlayerGlobalObjectsCreated dispatched once after the last one
+/// The checks need players, they run for every player who connects
+struct ObjectsTestComponent final : public IComponent, public CoreEventHandler, public PlayerConnectEventHandler, public ObjectEventHandler, public SingleNetworkOutEventHandler, public NoCopy
+{
+	/// Core
+	ICore* core = nullptr;
+
+	/// Objects component
+	IObjectsComponent* objects = nullptr;
+
+	/// Test objects by ID, with the positions they were created at
+	FlatHashMap<int, Vector3> testObjects;
+
+	/// What each connected player was sent
+	FlatHashMap<int, PlayerObjectCreation> players;
+
+	/// Ticks since the server started, the objects created for a player are counted per tick
+	int ticks = 0;
+
+	/// Gets the component UID
+	/// @returns Component UID
+	UID getUID() override
+	{
+		return 0x6b2e94d0c7a3f158;
+	}
+
+	/// Gets the component name
+	/// @returns Component name
+	StringView componentName() const override
+	{
+		return "Objects test";
+	}
+
+	/// Gets the component type
+	/// @returns Component type
+	ComponentType componentType() const override
+	{
+		return ComponentType::Other;
+	}
+
+	/// Gets the component version
+	/// @return Component version
+	SemanticVersion componentVersion() const override
+	{
+		return SemanticVersion(OMP_VERSION_MAJOR, OMP_VERSION_MINOR, OMP_VERSION_PATCH, BUILD_NUMBER);
+	}
+
+	/// Called for every component after components have been loaded
+	/// @param c Core
+	void onLoad(ICore* c) override
+	{
+		core = c;
+	}
+
+	/// Called when all components have been initialised
+	/// @param components Component list to query
+	void onInit(IComponentList* components) override
+	{
+		objects = components->queryComponent<IObjectsComponent>();
+	}
+
+	/// Creates the global objects, one of them bigger than the creation budget, and starts watching what players are sent
+	void onReady() override
+	{
+		if (!objects)
+		{
+			core->printLn("[ERROR] Objects test: the objects component isn't loaded.");
+			return;
+		}
+
+		IConfig& config = core->getConfig();
+		const bool* streamer = config.getBool("network.use_object_streamer");
+		const int* budget = config.getInt("network.object_creation_budget");
+		if ((streamer && *streamer) || !budget || *budget <= 0)
+		{
+			core->printLn("Objects test: global objects are streamed or created at once, set network.object_creation_budget and disable network.use_object_streamer to check their pacing");
+			return;
+		}
+
+		std::mt19937 random(1);
+		auto coordinate = [&random]()
+		{
+			return float(random() % 4000) - 2000.0f;
+		};
+		for (int i = 0; i < testObjectCount; ++i)
+		{
+			IObject* object = objects->create(1000 + i, Vector3(coordinate(), coordinate(), 10.0f), Vector3(0.0f, 0.0f, 0.0f), 300.0f);
+			if (!object)
+			{
+				check(false, "Couldn't create a global object.");
+				return;
+			}
+			if (i % testMaterialTextEvery == 0)
+			{
+				object->setMaterialText(0, String(random() % 200, 'x'), ObjectMaterialSize_256x128, "Arial", 24, false, Colour::White(), Colour::None(), ObjectMaterialTextAlign_Center);
+			}
+			testObjects.emplace(object->getID(), object->getPosition());
+		}
+
+		IObject* big = objects->create(999, Vector3(0.0f, 0.0f, 10.0f), Vector3(0.0f, 0.0f, 0.0f), 300.0f);
+		if (big)
+		{
+			for (int i = 0; i < MAX_OBJECT_MATERIAL_SLOTS; ++i)
+			{
+				big->setMaterialText(i, String(250, 'y'), ObjectMaterialSize_256x128, "Arial", 24, false, Colour::White(), Colour::None(), ObjectMaterialTextAlign_Center);
+			}
+			check(createObjectSize(*big) > size_t(*budget), "The big object isn't over the creation budget.");
+			testObjects.emplace(big->getID(), big->getPosition());
+		}
+
+		core->getEventDispatcher().addEventHandler(this);
+		core->getPlayers().getPlayerConnectDispatcher().addEventHandler(this);
+		objects->getEventDispatcher().addEventHandler(this);
+		for (INetwork* network : core->getNetworks())
+		{
+			network->getPerRPCOutEventDispatcher().addEventHandler(this, NetCode::RPC::CreateObject::PacketID);
+		}
+		core->printLn("Objects test: %zu global objects created, connect to check they're created for you over several ticks", testObjects.size());
+	}
+
+	/// Counts a failed check
+	/// @param condition Checked condition
+	/// @param description What was checked
+	void check(bool condition, const char* description)
+	{
+		if (!condition)
+		{
+			core->printLn("[ERROR] Objects test: %s", description);
+		}
+	}
+
+	/// Gets the size hint of an object's creation, the one the objects component spends its budget with
+	static size_t createObjectSize(IObject& object)
+	{
+		size_t size = 64;
+		for (int i = 0; i < MAX_OBJECT_MATERIAL_SLOTS; ++i)
+		{
+			const ObjectMaterialData* material;
+			if (object.getMaterialData(i, material) && material->used)
+			{
+				size += NetCode::RPC::getMaterialSizeHint(*material);
+			}
+		}
+		return size;
+	}
+
+	/// Records the test objects created for players
+	bool onSend(IPlayer* peer, NetworkBitStream& bs) override
+	{
+		uint16_t id;
+		if (!peer || !bs.readUINT16(id) || testObjects.find(id) == testObjects.end())
+		{
+			return true;
+		}
+
+		PlayerObjectCreation& creation = players[peer->getID()];
+		if (creation.done)
+		{
+			return true;
+		}
+		if (creation.order.empty())
+		{
+			IPlayerClassData* classData = queryExtension<IPlayerClassData>(*peer);
+			creation.spawn = classData ? classData->getClass().spawn : peer->getPosition();
+		}
+
+		check(creation.created.insert(id).second, "A global object was created twice for a player.");
+		creation.order.push_back(id);
+		IObject* object = objects->get(id);
+		creation.spent[ticks] += object ? createObjectSize(*object) : 0;
+		++creation.count[ticks];
+		return true;
+	}
+
+	/// Checks everything the player was sent once the objects component says it's done
+	void onPlayerGlobalObjectsCreated(IPlayer& player) override
+	{
+		PlayerObjectCreation& creation = players[player.getID()];
+		check(!creation.done, "All global objects were said to be created twice for a player.");
+		creation.done = true;
+		check(creation.created.size() == testObjects.size(), "Not every global object was created for a player.");
+
+		int outOfOrder = 0;
+		float last = 0.0f;
+		for (int id : creation.order)
+		{
+			const Vector3 offset = testObjects[id] - creation.spawn;
+			const float distance = glm::dot(offset, offset);
+			outOfOrder += distance < last;
+			last = distance;
+		}
+		check(outOfOrder == 0, "Global objects weren't created nearest to the player's spawn first.");
+
+		const int* budget = core->getConfig().getInt("network.object_creation_budget");
+		for (const auto& spent : creation.spent)
+		{
+			check(spent.second <= size_t(*budget) || creation.count[spent.first] == 1, "The global objects created for a player in one tick were over the creation budget.");
+		}
+
+		core->printLn("Objects test: %zu global objects created for player %d over %zu ticks", creation.order.size(), player.getID(), creation.spent.size());
+	}
+
+	/// Counts the ticks
+	void onTick(Microseconds elapsed, TimePoint now) override
+	{
+		++ticks;
+	}
+
+	/// Forgets what a player who left was sent
+	void onPlayerDisconnect(IPlayer& player, PeerDisconnectReason reason) override
+	{
+		players.erase(player.getID());
+	}
+
+	/// Called when another component is about to be freed
+	/// @param component The component being freed
+	void onFree(IComponent* component) override
+	{
+		if (component == objects)
+		{
+			objects = nullptr;
+			testObjects.clear();
+		}
+	}
+
+	/// Frees this component, it isn't allocated
+	void free() override
+	{
+		for (INetwork* network : core->getNetworks())
+		{
+			network->getPerRPCOutEventDispatcher().removeEventHandler(this, NetCode::RPC::CreateObject::PacketID);
+		}
+		if (objects)
+		{
+			objects->getEventDispatcher().removeEventHandler(this);
+		}
+		core->getPlayers().getPlayerConnectDispatcher().removeEventHandler(this);
+		core->getEventDispatcher().removeEventHandler(this);
+	}
+
+	void reset() override
+	{
+		players.clear();
+	}
+} objectsTestComponent;
+
+COMPONENT_ENTRY_POINT()
+{
+	return &objectsTestComponent;
+}
@@ -0,0 +1,83 @@
+/*
+ *  This Source Code Form is subject to the terms of the Mozilla Public License,
+ *  v. 2.0. If a copy of the MPL was not distributed with this file, You can
+ *  obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ *  The original code is copyright (c) 2022, open.mp team and contributors.
+ */
+
+#pragma once
+
+#include "../Script/Script.hpp"
+
+/// The callbacks the server calls in scripts, registered once so every script caches their publics by ID
+namespace PawnCallbacks
+{
+inline const PawnCallback OnActorStreamIn("OnActorStreamIn");
+inline const PawnCallback OnActorStreamOut("OnActorStreamOut");
+inline const PawnCallback OnClientCheckResponse("OnClientCheckResponse");
+inline const PawnCallback OnDialogResponse("OnDialogResponse");
+inline const PawnCallback OnEnterExitModShop("OnEnterExitModShop");
+inline const PawnCallback OnGameModeExit("OnGameModeExit");
+inline const PawnCallback OnGameModeInit("OnGameModeInit");
+inline const PawnCallback OnIncomingConnection("OnIncomingConnection");
+inline const PawnCallback OnObjectMoved("OnObjectMoved");
+inline const PawnCallback OnPlayerClickGangZone("OnPlayerClickGangZone");
+inline const PawnCallback OnPlayerClickMap("OnPlayerClickMap");
+inline const PawnCallback OnPlayerClickPlayer("OnPlayerClickPlayer");
+inline const PawnCallback OnPlayerClickPlayerGangZone("OnPlayerClickPlayerGangZone");
+inline const PawnCallback OnPlayerClickPlayerTextDraw("OnPlayerClickPlayerTextDraw");
+inline const PawnCallback OnPlayerClickTextDraw("OnPlayerClickTextDraw");
+inline const PawnCallback OnPlayerCommandText("OnPlayerCommandText");
+inline const PawnCallback OnPlayerConnect("OnPlayerConnect");
+inline const PawnCallback OnPlayerDeath("OnPlayerDeath");
+inline const PawnCallback OnPlayerDisconnect("OnPlayerDisconnect");
+inline const PawnCallback OnPlayerEditAttachedObject("OnPlayerEditAttachedObject");
+inline const PawnCallback OnPlayerEditObject("OnPlayerEditObject");
+inline const PawnCallback OnPlayerEnterCheckpoint("OnPlayerEnterCheckpoint");
+inline const PawnCallback OnPlayerEnterGangZone("OnPlayerEnterGangZone");
+inline const PawnCallback OnPlayerEnterPlayerGangZone("OnPlayerEnterPlayerGangZone");
+inline const PawnCallback OnPlayerEnterRaceCheckpoint("OnPlayerEnterRaceCheckpoint");
+inline const PawnCallback OnPlayerEnterVehicle("OnPlayerEnterVehicle");
+inline const PawnCallback OnPlayerExitVehicle("OnPlayerExitVehicle");
+inline const PawnCallback OnPlayerExitedMenu("OnPlayerExitedMenu");
+inline const PawnCallback OnPlayerFinishedDownloading("OnPlayerFinishedDownloading");
+inline const PawnCallback OnPlayerGiveDamage("OnPlayerGiveDamage");
+inline const PawnCallback OnPlayerGiveDamageActor("OnPlayerGiveDamageActor");
+inline const PawnCallback OnPlayerGlobalObjectsCreated("OnPlayerGlobalObjectsCreated");
+inline const PawnCallback OnPlayerInteriorChange("OnPlayerInteriorChange");
+inline const PawnCallback OnPlayerKeyStateChange("OnPlayerKeyStateChange");
+inline const PawnCallback OnPlayerLeaveCheckpoint("OnPlayerLeaveCheckpoint");
+inline const PawnCallback OnPlayerLeaveGangZone("OnPlayerLeaveGangZone");
+inline const PawnCallback OnPlayerLeavePlayerGangZone("OnPlayerLeavePlayerGangZone");
+inline const PawnCallback OnPlayerLeaveRaceCheckpoint("OnPlayerLeaveRaceCheckpoint");
+inline const PawnCallback OnPlayerObjectMoved("OnPlayerObjectMoved");
+inline const PawnCallback OnPlayerPickUpPickup("OnPlayerPickUpPickup");
+inline const PawnCallback OnPlayerPickUpPlayerPickup("OnPlayerPickUpPlayerPickup");
+inline const PawnCallback OnPlayerRequestClass("OnPlayerRequestClass");
+inline const PawnCallback OnPlayerRequestDownload("OnPlayerRequestDownload");
+inline const PawnCallback OnPlayerRequestSpawn("OnPlayerRequestSpawn");
+inline const PawnCallback OnPlayerSelectObject("OnPlayerSelectObject");
+inline const PawnCallback OnPlayerSelectedMenuRow("OnPlayerSelectedMenuRow");
+inline const PawnCallback OnPlayerSpawn("OnPlayerSpawn");
+inline const PawnCallback OnPlayerStateChange("OnPlayerStateChange");
+inline const PawnCallback OnPlayerStreamIn("OnPlayerStreamIn");
+inline const PawnCallback OnPlayerStreamOut("OnPlayerStreamOut");
+inline const PawnCallback OnPlayerTakeDamage("OnPlayerTakeDamage");
+inline const PawnCallback OnPlayerText("OnPlayerText");
+inline const PawnCallback OnPlayerUpdate("OnPlayerUpdate");
+inline const PawnCallback OnPlayerWeaponShot("OnPlayerWeaponShot");
+inline const PawnCallback OnRconCommand("OnRconCommand");
+inline const PawnCallback OnRconLoginAttempt("OnRconLoginAttempt");
+inline const PawnCallback OnTrailerUpdate("OnTrailerUpdate");
+inline const PawnCallback OnUnoccupiedVehicleUpdate("OnUnoccupiedVehicleUpdate");
+inline const PawnCallback OnVehicleDamageStatusUpdate("OnVehicleDamageStatusUpdate");
+inline const PawnCallback OnVehicleDeath("OnVehicleDeath");
+inline const PawnCallback OnVehicleMod("OnVehicleMod");
+inline const PawnCallback OnVehiclePaintjob("OnVehiclePaintjob");
+inline const PawnCallback OnVehicleRespray("OnVehicleRespray");
+inline const PawnCallback OnVehicleSirenStateChange("OnVehicleSirenStateChange");
+inline const PawnCallback OnVehicleSpawn("OnVehicleSpawn");
+inline const PawnCallback OnVehicleStreamIn("OnVehicleStreamIn");
+inline const PawnCallback OnVehicleStreamOut("OnVehicleStreamOut");
+}
@@ -59,7 +59,7 @@ PawnManager::~PawnManager()
 	if (mainScript_)
 	{
 		mainScript_->Call("OnGameModeExit", DefaultReturnValue_False);
-		CallInSides("OnGameModeExit", DefaultReturnValue_False);
+		CallInSides(PawnCallbacks::OnGameModeExit, DefaultReturnValue_False);
 		PawnTimerImpl::Get()->killTimers(mainScript_->GetAMX());
 		pluginManager.AmxUnload(mainScript_->GetAMX());
 		eventDispatcher.dispatch(&PawnEventHandler::onAmxUnload, *mainScript_);
@@ -481,7 +481,7 @@ void PawnManager::openAMX(PawnScript& script, bool isEntryScript)
 	if (isEntryScript)
 	{
 		script.Call("OnGameModeInit", DefaultReturnValue_False);
-		CallInSides("OnGameModeInit", DefaultReturnValue_False);
+		CallInSides(PawnCallbacks::OnGameModeInit, DefaultReturnValue_False);
 
 		// We're calling reloadAll after mode initialisation because we want to send
 		// updated settings to clients in PlayerInit RPC (such as available classes count)
@@ -531,6 +531,7 @@ void PawnManager::openAMX(PawnScript& script, bool isEntryScript)
 
 	// Assume that all initialisation and header mangling is now complete, and that it is safe to
 	// cache public pointers.
+	script.CacheCallbacks();
 
 	// Call `OnPlayerConnect` (can be after caching).
 	for (auto p : players->entries())
@@ -630,7 +631,7 @@ is `2`.
 	if (isEntryScript)
 	{
 		script.Call("OnGameModeExit", DefaultReturnValue_False);
-		CallInSides("OnGameModeExit", DefaultReturnValue_False);
+		CallInSides(PawnCallbacks::OnGameModeExit, DefaultReturnValue_False);
 	}
 	else
 	{
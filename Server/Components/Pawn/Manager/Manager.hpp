@@ -43,6 +43,7 @@
 #include "../PluginManager/PluginManager.hpp"
 #include "../Script/Script.hpp"
 #include "../Singleton.hpp"
+#include "Callbacks.hpp"
 
 using namespace Impl;
 
@@ -132,41 +133,41 @@ public:
 	}
 
 	template <typename... T>
-	cell CallAllInSidesFirst(char const* name, DefaultReturnValue defaultRetValue, T... args)
+	cell CallAllInSidesFirst(PawnCallback const& callback, DefaultReturnValue defaultRetValue, T... args)
 	{
 		cell ret = static_cast<cell>(defaultRetValue);
 
 		for (IPawnScript* cur : scripts_)
 		{
-			ret = cur->Call(name, defaultRetValue, args...);
+			ret = static_cast<PawnScript*>(cur)->CallCached(callback, defaultRetValue, args...);
 		}
 		if (mainScript_)
 		{
-			ret = mainScript_->Call(name, defaultRetValue, args...);
+			ret = mainScript_->CallCached(callback, defaultRetValue, args...);
 		}
 
 		return ret;
 	}
 
 	template <typename... T>
-	cell CallAllInEntryFirst(char const* name, DefaultReturnValue defaultRetValue, T... args)
+	cell CallAllInEntryFirst(PawnCallback const& callback, DefaultReturnValue defaultRetValue, T... args)
 	{
 		cell ret = static_cast<cell>(defaultRetValue);
 
 		if (mainScript_)
 		{
-			ret = mainScript_->Call(name, defaultRetValue, args...);
+			ret = mainScript_->CallCached(callback, defaultRetValue, args...);
 		}
 		for (IPawnScript* cur : scripts_)
 		{
-			ret = cur->Call(name, defaultRetValue, args...);
+			ret = static_cast<PawnScript*>(cur)->CallCached(callback, defaultRetValue, args...);
 		}
 
 		return ret;
 	}
 
 	template <typename... T>
-	cell CallInSidesWhile0(char const* name, T... args)
+	cell CallInSidesWhile0(PawnCallback const& callback, T... args)
 	{
 		cell
 			ret
@@ -174,7 +175,7 @@ public:
 
 		for (IPawnScript* cur : scripts_)
 		{
-			ret = cur->Call(name, DefaultReturnValue_False, args...);
+			ret = static_cast<PawnScript*>(cur)->CallCached(callback, DefaultReturnValue_False, args...);
 			if (ret)
 			{
 				break;
@@ -185,7 +186,7 @@ public:
 	}
 
 	template <typename... T>
-	cell CallInSidesWhile1(char const* name, T... args)
+	cell CallInSidesWhile1(PawnCallback const& callback, T... args)
 	{
 		cell
 			ret
@@ -193,7 +194,7 @@ public:
 
 		for (IPawnScript* cur : scripts_)
 		{
-			ret = cur->Call(name, DefaultReturnValue_True, args...);
+			ret = static_cast<PawnScript*>(cur)->CallCached(callback, DefaultReturnValue_True, args...);
 			if (!ret)
 			{
 				break;
@@ -204,44 +205,44 @@ public:
 	}
 
 	template <typename... T>
-	cell CallInSides(char const* name, DefaultReturnValue defaultRetValue, T... args)
+	cell CallInSides(PawnCallback const& callback, DefaultReturnValue defaultRetValue, T... args)
 	{
 		cell ret = static_cast<cell>(defaultRetValue);
 
 		for (IPawnScript* cur : scripts_)
 		{
-			ret = cur->Call(name, defaultRetValue, args...);
+			ret = static_cast<PawnScript*>(cur)->CallCached(callback, defaultRetValue, args...);
 		}
 
 		return ret;
 	}
 
 	template <typename... T>
-	cell CallInEntry(char const* name, DefaultReturnValue defaultRetValue, T... args)
+	cell CallInEntry(PawnCallback const& callback, DefaultReturnValue defaultRetValue, T... args)
 	{
 		cell ret = static_cast<cell>(defaultRetValue);
 
 		if (mainScript_)
 		{
-			ret = mainScript_->Call(name, defaultRetValue, args...);
+			ret = mainScript_->CallCached(callback, defaultRetValue, args...);
 		}
 
 		return ret;
 	}
 
 	template <typename... T>
-	cell CallAll(char const* name, T... args)
+	cell CallAll(PawnCallback const& callback, T... args)
 	{
 		cell
 			ret
 			= 0;
 		if (mainScript_)
 		{
-			ret = mainScript_->Call(name, DefaultReturnValue_False, args...);
+			ret = mainScript_->CallCached(callback, DefaultReturnValue_False, args...);
 		}
 		for (IPawnScript* cur : scripts_)
 		{
-			ret = cur->Call(name, DefaultReturnValue_False, args...);
+			ret = static_cast<PawnScript*>(cur)->CallCached(callback, DefaultReturnValue_False, args...);
 		}
 		return ret;
 	}
@@ -264,20 +265,20 @@ public:
 	}
 
 	template <typename... T>
-	cell CallWhile0(char const* name, T... args)
+	cell CallWhile0(PawnCallback const& callback, T... args)
 	{
 		cell
 			ret
 			= 0;
 		if (mainScript_)
 		{
-			ret = mainScript_->Call(name, DefaultReturnValue_False, args...);
+			ret = mainScript_->CallCached(callback, DefaultReturnValue_False, args...);
 			if (ret)
 				return ret;
 		}
 		for (IPawnScript* cur : scripts_)
 		{
-			ret = cur->Call(name, DefaultReturnValue_False, args...);
+			ret = static_cast<PawnScript*>(cur)->CallCached(callback, DefaultReturnValue_False, args...);
 			if (ret)
 				return ret;
 		}
@@ -304,19 +305,19 @@ public:
 	}
 
 	template <typename... T>
-	cell CallWhile1(char const* name, T... args)
+	cell CallWhile1(PawnCallback const& callback, T... args)
 	{
 		cell ret = static_cast<cell>(DefaultReturnValue_True);
 
 		if (mainScript_)
 		{
-			ret = mainScript_->Call(name, DefaultReturnValue_True, args...);
+			ret = mainScript_->CallCached(callback, DefaultReturnValue_True, args...);
 			if (!ret)
 				return ret;
 		}
 		for (IPawnScript* cur : scripts_)
 		{
-			ret = cur->Call(name, DefaultReturnValue_True, args...);
+			ret = static_cast<PawnScript*>(cur)->CallCached(callback, DefaultReturnValue_True, args...);
 			if (!ret)
 				return ret;
 		}
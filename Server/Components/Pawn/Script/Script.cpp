@@ -59,6 +59,10 @@ void PawnScript::tryLoad(std::string const& path)
 		aux_FreeProgram(&amx_);
 		cache.erase(&amx_);
 	}
+	// Whatever was cached belongs to the previous program, including callbacks it didn't have
+	cache_.publics.clear();
+	cache_.callbacks.clear();
+	cache_.inited = false;
 	loaded_ = false;
 	if (path == "")
 	{
@@ -116,6 +120,41 @@ PawnScript::~PawnScript()
 	tryLoad("");
 }
 
+void PawnScript::CacheCallbacks()
+{
+	// Headers may still be rewritten during initialisation so don't cache anything yet
+	if (!cache_.inited)
+	{
+		return;
+	}
+	const DynamicArray<PawnCallback const*>& callbacks = PawnCallback::registry();
+	cache_.callbacks.assign(callbacks.size(), Unresolved);
+	for (PawnCallback const* callback : callbacks)
+	{
+		int idx;
+		FindCallback(*callback, &idx);
+	}
+}
+
+int PawnScript::FindCallback(PawnCallback const& callback, int* index)
+{
+	if (!cache_.inited || size_t(callback.id) >= cache_.callbacks.size())
+	{
+		return FindPublic(callback.name, index);
+	}
+
+	int& cached = cache_.callbacks[callback.id];
+	if (cached == Unresolved)
+	{
+		// Goes through amx_FindPublic so plugins hooking it still see the lookup
+		int found;
+		cached = FindPublic(callback.name, &found) == AMX_ERR_NONE ? found : INT_MAX;
+	}
+
+	*index = cached;
+	return cached == INT_MAX ? AMX_ERR_NOTFOUND : AMX_ERR_NONE;
+}
+
 int AMXAPI amx_NumPublics(AMX* amx, int* number)
 {
 	AMX_HEADER* hdr = (AMX_HEADER*)amx->base;
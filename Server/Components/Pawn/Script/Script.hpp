@@ -25,11 +25,33 @@
 
 using namespace Impl;
 
+/// A callback the server calls in scripts, given an ID when it's registered so each script can cache its public index by it
+struct PawnCallback : public NoCopy
+{
+	char const* const name;
+	int const id;
+
+	explicit PawnCallback(char const* name)
+		: name(name)
+		, id(int(registry().size()))
+	{
+		registry().push_back(this);
+	}
+
+	/// All the registered callbacks, by ID
+	static DynamicArray<PawnCallback const*>& registry()
+	{
+		static DynamicArray<PawnCallback const*> callbacks;
+		return callbacks;
+	}
+};
+
 /// A struct for different AMX caches
 struct AMXCache
 {
 	int inited = false; ///< True when the AMX should be used
 	FlatHashMap<String, int> publics; ///< A cache of AMX publics
+	DynamicArray<int> callbacks; ///< Public indices by callback ID, INT_MAX when missing or Unresolved when not looked up yet
 };
 
 class PawnScript : public IPawnScript
@@ -106,6 +128,28 @@ public:
 
 	using IPawnScript::Register;
 
+	/// The cached index of a callback which hasn't been looked up yet
+	constexpr static const int Unresolved = INT_MIN;
+
+	/// Look up every registered callback's public, call once the script is initialised
+	void CacheCallbacks();
+
+	/// Find a callback's public, from the cached index once the script is initialised
+	int FindCallback(PawnCallback const& callback, int* index);
+
+	/// Call a callback's public, scripts without the public are skipped without searching for it
+	template <typename... T>
+	cell CallCached(PawnCallback const& callback, DefaultReturnValue defaultRetValue, T... args)
+	{
+		int idx;
+		cell ret = defaultRetValue;
+		if (!FindCallback(callback, &idx))
+		{
+			Call(ret, idx, args...);
+		}
+		return ret;
+	}
+
 	void tryLoad(std::string const& path);
 
 private:
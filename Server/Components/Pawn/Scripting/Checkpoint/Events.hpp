@@ -15,21 +15,21 @@ struct CheckpointEvents : public PlayerCheckpointEventHandler, public Singleton<
 {
 	void onPlayerEnterCheckpoint(IPlayer& player) override
 	{
-		PawnManager::Get()->CallAllInSidesFirst("OnPlayerEnterCheckpoint", DefaultReturnValue_True, player.getID());
+		PawnManager::Get()->CallAllInSidesFirst(PawnCallbacks::OnPlayerEnterCheckpoint, DefaultReturnValue_True, player.getID());
 	}
 
 	void onPlayerLeaveCheckpoint(IPlayer& player) override
 	{
-		PawnManager::Get()->CallAllInSidesFirst("OnPlayerLeaveCheckpoint", DefaultReturnValue_True, player.getID());
+		PawnManager::Get()->CallAllInSidesFirst(PawnCallbacks::OnPlayerLeaveCheckpoint, DefaultReturnValue_True, player.getID());
 	}
 
 	void onPlayerEnterRaceCheckpoint(IPlayer& player) override
 	{
-		PawnManager::Get()->CallAllInSidesFirst("OnPlayerEnterRaceCheckpoint", DefaultReturnValue_True, player.getID());
+		PawnManager::Get()->CallAllInSidesFirst(PawnCallbacks::OnPlayerEnterRaceCheckpoint, DefaultReturnValue_True, player.getID());
 	}
 
 	void onPlayerLeaveRaceCheckpoint(IPlayer& player) override
 	{
-		PawnManager::Get()->CallAllInSidesFirst("OnPlayerLeaveRaceCheckpoint", DefaultReturnValue_True, player.getID());
+		PawnManager::Get()->CallAllInSidesFirst(PawnCallbacks::OnPlayerLeaveRaceCheckpoint, DefaultReturnValue_True, player.getID());
 	}
 };
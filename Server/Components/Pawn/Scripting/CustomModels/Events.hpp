@@ -15,14 +15,14 @@ struct CustomModelsEvents : public PlayerModelsEventHandler, public Singleton<Cu
 {
 	virtual void onPlayerFinishedDownloading(IPlayer& player) override
 	{
-		PawnManager::Get()->CallAllInSidesFirst("OnPlayerFinishedDownloading", DefaultReturnValue_True, player.getID(), player.getVirtualWorld());
+		PawnManager::Get()->CallAllInSidesFirst(PawnCallbacks::OnPlayerFinishedDownloading, DefaultReturnValue_True, player.getID(), player.getVirtualWorld());
 	}
 	virtual bool onPlayerRequestDownload(IPlayer& player, ModelDownloadType type, uint32_t checksum) override
 	{
-		cell ret = PawnManager::Get()->CallInSidesWhile1("OnPlayerRequestDownload", player.getID(), static_cast<uint8_t>(type), checksum);
+		cell ret = PawnManager::Get()->CallInSidesWhile1(PawnCallbacks::OnPlayerRequestDownload, player.getID(), static_cast<uint8_t>(type), checksum);
 		if (ret)
 		{
-			ret = PawnManager::Get()->CallInEntry("OnPlayerRequestDownload", DefaultReturnValue_True, player.getID(), static_cast<uint8_t>(type), checksum);
+			ret = PawnManager::Get()->CallInEntry(PawnCallbacks::OnPlayerRequestDownload, DefaultReturnValue_True, player.getID(), static_cast<uint8_t>(type), checksum);
 		}
 		return !!ret;
 	}
@@ -11,6 +11,47 @@
 #include <ghc/filesystem.hpp>
 #include "../../format.hpp"
 
+struct PawnDatabaseQueryHandler final : DatabaseQueryHandler
+{
+	String callback;
+	AMX* amx;
+
+	PawnDatabaseQueryHandler(StringView callback, AMX* amx)
+		: callback(callback)
+		, amx(amx)
+	{
+	}
+
+	void onDatabaseQueryExecuted(IDatabaseConnection& connection, IDatabaseResultSet* resultSet) override
+	{
+		// Check if the script is still loaded.
+		auto& amx_map = PawnManager::Get()->amxToScript_;
+		auto script_itr = amx_map.find(amx);
+		if (script_itr != amx_map.end())
+		{
+			// The result is freed once the callback returns.
+			script_itr->second->Call(callback, DefaultReturnValue_True, connection.getID(), resultSet ? resultSet->getID() : 0);
+		}
+		delete this;
+	}
+
+	void onDatabaseQueryCancelled(IDatabaseConnection& connection) override
+	{
+		delete this;
+	}
+};
+
+static bool doDBQueryAsync(IDatabaseConnection& db, StringView callback, StringView query, AMX* amx)
+{
+	PawnDatabaseQueryHandler* handler = new PawnDatabaseQueryHandler(callback, amx);
+	if (!db.executeQueryAsync(query, Span<const DatabaseParameter>(), handler))
+	{
+		delete handler;
+		return false;
+	}
+	return true;
+}
+
 static int getFlags(cell* params)
 {
 	// Get the flags.
@@ -115,6 +156,12 @@ SCRIPT_API(db_query, int(IDatabaseConnection& db, cell const* format))
 	return database_result_set ? database_result_set->getID() : 0;
 }
 
+SCRIPT_API(db_query_async, bool(IDatabaseConnection& db, std::string const& callback, cell const* format))
+{
+	AmxStringFormatter query(format, GetAMX(), GetParams(), 3);
+	return doDBQueryAsync(db, callback, query, GetAMX());
+}
+
 SCRIPT_API(db_free_result, bool(IDatabaseResultSet& result))
 {
 	return PawnManager::Get()->databases->freeResultSet(result);
@@ -229,6 +276,12 @@ SCRIPT_API(DB_ExecuteQuery, int(IDatabaseConnection& db, cell const* format))
 	return database_result_set ? database_result_set->getID() : 0;
 }
 
+SCRIPT_API(DB_ExecuteQueryAsync, bool(IDatabaseConnection& db, std::string const& callback, cell const* format))
+{
+	AmxStringFormatter query(format, GetAMX(), GetParams(), 3);
+	return doDBQueryAsync(db, callback, query, GetAMX());
+}
+
 SCRIPT_API(DB_FreeResultSet, bool(IDatabaseResultSet& result))
 {
 	return PawnManager::Get()->databases->freeResultSet(result);
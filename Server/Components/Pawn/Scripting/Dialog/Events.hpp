@@ -15,7 +15,7 @@ struct DialogEvents : public PlayerDialogEventHandler, public Singleton<DialogEv
 {
 	void onDialogResponse(IPlayer& player, int dialogId, DialogResponse response, int listItem, StringView inputText) override
 	{
-		PawnManager::Get()->CallInSidesWhile0("OnDialogResponse", player.getID(), dialogId, int(response), listItem, inputText);
-		PawnManager::Get()->CallInEntry("OnDialogResponse", DefaultReturnValue_False, player.getID(), dialogId, int(response), listItem, inputText);
+		PawnManager::Get()->CallInSidesWhile0(PawnCallbacks::OnDialogResponse, player.getID(), dialogId, int(response), listItem, inputText);
+		PawnManager::Get()->CallInEntry(PawnCallbacks::OnDialogResponse, DefaultReturnValue_False, player.getID(), dialogId, int(response), listItem, inputText);
 	}
 };
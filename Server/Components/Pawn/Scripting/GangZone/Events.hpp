@@ -18,11 +18,11 @@ struct GangZoneEvents : public GangZoneEventHandler, public Singleton<GangZoneEv
 		auto pawn = PawnManager::Get();
 		if (zone.getLegacyPlayer() == nullptr)
 		{
-			pawn->CallAllInEntryFirst("OnPlayerEnterGangZone", DefaultReturnValue_True, player.getID(), pawn->gangzones->toLegacyID(zone.getID()));
+			pawn->CallAllInEntryFirst(PawnCallbacks::OnPlayerEnterGangZone, DefaultReturnValue_True, player.getID(), pawn->gangzones->toLegacyID(zone.getID()));
 		}
 		else if (auto data = queryExtension<IPlayerGangZoneData>(player))
 		{
-			pawn->CallAllInEntryFirst("OnPlayerEnterPlayerGangZone", DefaultReturnValue_True, player.getID(), data->toLegacyID(zone.getID()));
+			pawn->CallAllInEntryFirst(PawnCallbacks::OnPlayerEnterPlayerGangZone, DefaultReturnValue_True, player.getID(), data->toLegacyID(zone.getID()));
 		}
 	}
 
@@ -31,11 +31,11 @@ struct GangZoneEvents : public GangZoneEventHandler, public Singleton<GangZoneEv
 		auto pawn = PawnManager::Get();
 		if (zone.getLegacyPlayer() == nullptr)
 		{
-			pawn->CallAllInEntryFirst("OnPlayerLeaveGangZone", DefaultReturnValue_True, player.getID(), pawn->gangzones->toLegacyID(zone.getID()));
+			pawn->CallAllInEntryFirst(PawnCallbacks::OnPlayerLeaveGangZone, DefaultReturnValue_True, player.getID(), pawn->gangzones->toLegacyID(zone.getID()));
 		}
 		else if (auto data = queryExtension<IPlayerGangZoneData>(player))
 		{
-			pawn->CallAllInEntryFirst("OnPlayerLeavePlayerGangZone", DefaultReturnValue_True, player.getID(), data->toLegacyID(zone.getID()));
+			pawn->CallAllInEntryFirst(PawnCallbacks::OnPlayerLeavePlayerGangZone, DefaultReturnValue_True, player.getID(), data->toLegacyID(zone.getID()));
 		}
 	}
 
@@ -44,11 +44,11 @@ struct GangZoneEvents : public GangZoneEventHandler, public Singleton<GangZoneEv
 		auto pawn = PawnManager::Get();
 		if (zone.getLegacyPlayer() == nullptr)
 		{
-			pawn->CallAllInEntryFirst("OnPlayerClickGangZone", DefaultReturnValue_True, player.getID(), pawn->gangzones->toLegacyID(zone.getID()));
+			pawn->CallAllInEntryFirst(PawnCallbacks::OnPlayerClickGangZone, DefaultReturnValue_True, player.getID(), pawn->gangzones->toLegacyID(zone.getID()));
 		}
 		else if (auto data = queryExtension<IPlayerGangZoneData>(player))
 		{
-			pawn->CallAllInEntryFirst("OnPlayerClickPlayerGangZone", DefaultReturnValue_True, player.getID(), data->toLegacyID(zone.getID()));
+			pawn->CallAllInEntryFirst(PawnCallbacks::OnPlayerClickPlayerGangZone, DefaultReturnValue_True, player.getID(), data->toLegacyID(zone.getID()));
 		}
 	}
 };
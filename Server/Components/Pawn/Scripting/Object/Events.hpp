@@ -15,25 +15,30 @@ struct ObjectEvents : public ObjectEventHandler, public Singleton<ObjectEvents>
 {
 	void onMoved(IObject& object) override
 	{
-		PawnManager::Get()->CallAllInSidesFirst("OnObjectMoved", DefaultReturnValue_True, object.getID());
+		PawnManager::Get()->CallAllInSidesFirst(PawnCallbacks::OnObjectMoved, DefaultReturnValue_True, object.getID());
 	}
 
 	void onPlayerObjectMoved(IPlayer& player, IPlayerObject& object) override
 	{
-		PawnManager::Get()->CallAllInSidesFirst("OnPlayerObjectMoved", DefaultReturnValue_True, player.getID(), object.getID());
+		PawnManager::Get()->CallAllInSidesFirst(PawnCallbacks::OnPlayerObjectMoved, DefaultReturnValue_True, player.getID(), object.getID());
+	}
+
+	void onPlayerGlobalObjectsCreated(IPlayer& player) override
+	{
+		PawnManager::Get()->CallAllInSidesFirst(PawnCallbacks::OnPlayerGlobalObjectsCreated, DefaultReturnValue_True, player.getID());
 	}
 
 	void onObjectEdited(IPlayer& player, IObject& object, ObjectEditResponse response, Vector3 offset, Vector3 rotation) override
 	{
 		cell ret = PawnManager::Get()->CallInSidesWhile0(
-			"OnPlayerEditObject",
+			PawnCallbacks::OnPlayerEditObject,
 			player.getID(), 0, object.getID(), int(response),
 			offset.x, offset.y, offset.z,
 			rotation.x, rotation.y, rotation.z);
 		if (!ret)
 		{
 			PawnManager::Get()->CallInEntry(
-				"OnPlayerEditObject",
+				PawnCallbacks::OnPlayerEditObject,
 				DefaultReturnValue_True,
 				player.getID(), 0, object.getID(), int(response),
 				offset.x, offset.y, offset.z,
@@ -44,14 +49,14 @@ struct ObjectEvents : public ObjectEventHandler, public Singleton<ObjectEvents>
 	void onPlayerObjectEdited(IPlayer& player, IPlayerObject& object, ObjectEditResponse response, Vector3 offset, Vector3 rotation) override
 	{
 		cell ret = PawnManager::Get()->CallInSidesWhile0(
-			"OnPlayerEditObject",
+			PawnCallbacks::OnPlayerEditObject,
 			player.getID(), 1, object.getID(), int(response),
 			offset.x, offset.y, offset.z,
 			rotation.x, rotation.y, rotation.z);
 		if (!ret)
 		{
 			PawnManager::Get()->CallInEntry(
-				"OnPlayerEditObject",
+				PawnCallbacks::OnPlayerEditObject,
 				DefaultReturnValue_True,
 				player.getID(), 1, object.getID(), int(response),
 				offset.x, offset.y, offset.z,
@@ -62,7 +67,7 @@ struct ObjectEvents : public ObjectEventHandler, public Singleton<ObjectEvents>
 	void onPlayerAttachedObjectEdited(IPlayer& player, int index, bool saved, const ObjectAttachmentSlotData& data) override
 	{
 		cell ret = PawnManager::Get()->CallInSidesWhile0(
-			"OnPlayerEditAttachedObject",
+			PawnCallbacks::OnPlayerEditAttachedObject,
 			player.getID(), saved, index, data.model, data.bone,
 			data.offset.x, data.offset.y, data.offset.z,
 			data.rotation.x, data.rotation.y, data.rotation.z,
@@ -70,7 +75,7 @@ struct ObjectEvents : public ObjectEventHandler, public Singleton<ObjectEvents>
 		if (!ret)
 		{
 			PawnManager::Get()->CallInEntry(
-				"OnPlayerEditAttachedObject",
+				PawnCallbacks::OnPlayerEditAttachedObject,
 				DefaultReturnValue_True,
 				player.getID(), saved, index, data.model, data.bone,
 				data.offset.x, data.offset.y, data.offset.z,
@@ -82,13 +87,13 @@ struct ObjectEvents : public ObjectEventHandler, public Singleton<ObjectEvents>
 	void onObjectSelected(IPlayer& player, IObject& object, int model, Vector3 position) override
 	{
 		cell ret = PawnManager::Get()->CallInSidesWhile0(
-			"OnPlayerSelectObject",
+			PawnCallbacks::OnPlayerSelectObject,
 			player.getID(), 1, object.getID(), model,
 			position.x, position.y, position.z);
 		if (!ret)
 		{
 			PawnManager::Get()->CallInEntry(
-				"OnPlayerSelectObject",
+				PawnCallbacks::OnPlayerSelectObject,
 				DefaultReturnValue_True,
 				player.getID(), 1, object.getID(), model,
 				position.x, position.y, position.z);
@@ -98,13 +103,13 @@ struct ObjectEvents : public ObjectEventHandler, public Singleton<ObjectEvents>
 	void onPlayerObjectSelected(IPlayer& player, IPlayerObject& object, int model, Vector3 position) override
 	{
 		cell ret = PawnManager::Get()->CallInSidesWhile0(
-			"OnPlayerSelectObject",
+			PawnCallbacks::OnPlayerSelectObject,
 			player.getID(), 2, object.getID(), model,
 			position.x, position.y, position.z);
 		if (!ret)
 		{
 			PawnManager::Get()->CallInEntry(
-				"OnPlayerSelectObject",
+				PawnCallbacks::OnPlayerSelectObject,
 				DefaultReturnValue_True,
 				player.getID(), 2, object.getID(), model,
 				position.x, position.y, position.z);
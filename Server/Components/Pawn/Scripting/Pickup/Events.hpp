@@ -18,11 +18,11 @@ struct PickupEvents : public PickupEventHandler, public Singleton<PickupEvents>
 		auto pawn = PawnManager::Get();
 		if (pickup.getLegacyPlayer() == nullptr)
 		{
-			pawn->CallAllInEntryFirst("OnPlayerPickUpPickup", DefaultReturnValue_True, player.getID(), pawn->pickups->toLegacyID(pickup.getID()));
+			pawn->CallAllInEntryFirst(PawnCallbacks::OnPlayerPickUpPickup, DefaultReturnValue_True, player.getID(), pawn->pickups->toLegacyID(pickup.getID()));
 		}
 		else if (auto data = queryExtension<IPlayerPickupData>(player))
 		{
-			pawn->CallAllInEntryFirst("OnPlayerPickUpPlayerPickup", DefaultReturnValue_True, player.getID(), data->toLegacyID(pickup.getID()));
+			pawn->CallAllInEntryFirst(PawnCallbacks::OnPlayerPickUpPlayerPickup, DefaultReturnValue_True, player.getID(), data->toLegacyID(pickup.getID()));
 		}
 	}
 };
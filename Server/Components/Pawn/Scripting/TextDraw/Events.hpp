@@ -15,10 +15,10 @@ struct TextDrawEvents : public TextDrawEventHandler, public Singleton<TextDrawEv
 {
 	virtual bool onPlayerCancelTextDrawSelection(IPlayer& player) override
 	{
-		cell ret = PawnManager::Get()->CallInSidesWhile0("OnPlayerClickTextDraw", player.getID(), INVALID_TEXTDRAW);
+		cell ret = PawnManager::Get()->CallInSidesWhile0(PawnCallbacks::OnPlayerClickTextDraw, player.getID(), INVALID_TEXTDRAW);
 		if (!ret)
 		{
-			PawnManager::Get()->CallInEntry("OnPlayerClickTextDraw", DefaultReturnValue_False, player.getID(), INVALID_TEXTDRAW);
+			PawnManager::Get()->CallInEntry(PawnCallbacks::OnPlayerClickTextDraw, DefaultReturnValue_False, player.getID(), INVALID_TEXTDRAW);
 		}
 		// TODO: New callback?
 		return true;
@@ -26,10 +26,10 @@ struct TextDrawEvents : public TextDrawEventHandler, public Singleton<TextDrawEv
 
 	virtual bool onPlayerCancelPlayerTextDrawSelection(IPlayer& player) override
 	{
-		cell ret = PawnManager::Get()->CallInSidesWhile0("OnPlayerClickPlayerTextDraw", player.getID(), INVALID_TEXTDRAW);
+		cell ret = PawnManager::Get()->CallInSidesWhile0(PawnCallbacks::OnPlayerClickPlayerTextDraw, player.getID(), INVALID_TEXTDRAW);
 		if (!ret)
 		{
-			PawnManager::Get()->CallInEntry("OnPlayerClickPlayerTextDraw", DefaultReturnValue_False, player.getID(), INVALID_TEXTDRAW);
+			PawnManager::Get()->CallInEntry(PawnCallbacks::OnPlayerClickPlayerTextDraw, DefaultReturnValue_False, player.getID(), INVALID_TEXTDRAW);
 		}
 		// TODO: New callback?
 		return true;
@@ -37,19 +37,19 @@ struct TextDrawEvents : public TextDrawEventHandler, public Singleton<TextDrawEv
 
 	void onPlayerClickTextDraw(IPlayer& player, ITextDraw& td) override
 	{
-		cell ret = PawnManager::Get()->CallInSidesWhile0("OnPlayerClickTextDraw", player.getID(), td.getID());
+		cell ret = PawnManager::Get()->CallInSidesWhile0(PawnCallbacks::OnPlayerClickTextDraw, player.getID(), td.getID());
 		if (!ret)
 		{
-			PawnManager::Get()->CallInEntry("OnPlayerClickTextDraw", DefaultReturnValue_False, player.getID(), td.getID());
+			PawnManager::Get()->CallInEntry(PawnCallbacks::OnPlayerClickTextDraw, DefaultReturnValue_False, player.getID(), td.getID());
 		}
 	}
 
 	void onPlayerClickPlayerTextDraw(IPlayer& player, IPlayerTextDraw& td) override
 	{
-		cell ret = PawnManager::Get()->CallInSidesWhile0("OnPlayerClickPlayerTextDraw", player.getID(), td.getID());
+		cell ret = PawnManager::Get()->CallInSidesWhile0(PawnCallbacks::OnPlayerClickPlayerTextDraw, player.getID(), td.getID());
 		if (!ret)
 		{
-			PawnManager::Get()->CallInEntry("OnPlayerClickPlayerTextDraw", DefaultReturnValue_False, player.getID(), td.getID());
+			PawnManager::Get()->CallInEntry(PawnCallbacks::OnPlayerClickPlayerTextDraw, DefaultReturnValue_False, player.getID(), td.getID());
 		}
 	}
 };
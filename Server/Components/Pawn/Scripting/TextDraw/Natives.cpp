@@ -135,20 +135,14 @@ SCRIPT_API(TextDrawHideForPlayer, bool(IPlayer& player, ITextDraw& textdraw))
 SCRIPT_API(TextDrawShowForAll, bool(ITextDraw& textdraw))
 {
 	IPlayerPool* pool = PawnManager::Get()->players;
-	for (IPlayer* player : pool->entries())
-	{
-		textdraw.showForPlayer(*player);
-	}
+	textdraw.showForPlayers(pool->entries());
 	return true;
 }
 
 SCRIPT_API(TextDrawHideForAll, bool(ITextDraw& textdraw))
 {
 	IPlayerPool* pool = PawnManager::Get()->players;
-	for (IPlayer* player : pool->entries())
-	{
-		textdraw.hideForPlayer(*player);
-	}
+	textdraw.hideForPlayers(pool->entries());
 	return true;
 }
 
@@ -15,85 +15,85 @@ struct VehicleEvents : public VehicleEventHandler, public Singleton<VehicleEvent
 {
 	void onVehicleStreamIn(IVehicle& vehicle, IPlayer& player) override
 	{
-		PawnManager::Get()->CallAllInSidesFirst("OnVehicleStreamIn", DefaultReturnValue_True, vehicle.getID(), player.getID());
+		PawnManager::Get()->CallAllInSidesFirst(PawnCallbacks::OnVehicleStreamIn, DefaultReturnValue_True, vehicle.getID(), player.getID());
 	}
 
 	void onVehicleStreamOut(IVehicle& vehicle, IPlayer& player) override
 	{
-		PawnManager::Get()->CallAllInSidesFirst("OnVehicleStreamOut", DefaultReturnValue_True, vehicle.getID(), player.getID());
+		PawnManager::Get()->CallAllInSidesFirst(PawnCallbacks::OnVehicleStreamOut, DefaultReturnValue_True, vehicle.getID(), player.getID());
 	}
 
 	void onVehicleDeath(IVehicle& vehicle, IPlayer& player) override
 	{
-		PawnManager::Get()->CallAllInSidesFirst("OnVehicleDeath", DefaultReturnValue_True, vehicle.getID(), player.getID());
+		PawnManager::Get()->CallAllInSidesFirst(PawnCallbacks::OnVehicleDeath, DefaultReturnValue_True, vehicle.getID(), player.getID());
 	}
 
 	void onPlayerEnterVehicle(IPlayer& player, IVehicle& vehicle, bool passenger) override
 	{
-		PawnManager::Get()->CallAllInSidesFirst("OnPlayerEnterVehicle", DefaultReturnValue_True, player.getID(), vehicle.getID(), passenger);
+		PawnManager::Get()->CallAllInSidesFirst(PawnCallbacks::OnPlayerEnterVehicle, DefaultReturnValue_True, player.getID(), vehicle.getID(), passenger);
 	}
 
 	void onPlayerExitVehicle(IPlayer& player, IVehicle& vehicle) override
 	{
-		PawnManager::Get()->CallAllInSidesFirst("OnPlayerExitVehicle", DefaultReturnValue_True, player.getID(), vehicle.getID());
+		PawnManager::Get()->CallAllInSidesFirst(PawnCallbacks::OnPlayerExitVehicle, DefaultReturnValue_True, player.getID(), vehicle.getID());
 	}
 
 	void onVehicleDamageStatusUpdate(IVehicle& vehicle, IPlayer& player) override
 	{
-		PawnManager::Get()->CallInSidesWhile0("OnVehicleDamageStatusUpdate", vehicle.getID(), player.getID());
-		PawnManager::Get()->CallInEntry("OnVehicleDamageStatusUpdate", DefaultReturnValue_False, vehicle.getID(), player.getID());
+		PawnManager::Get()->CallInSidesWhile0(PawnCallbacks::OnVehicleDamageStatusUpdate, vehicle.getID(), player.getID());
+		PawnManager::Get()->CallInEntry(PawnCallbacks::OnVehicleDamageStatusUpdate, DefaultReturnValue_False, vehicle.getID(), player.getID());
 	}
 
 	bool onVehiclePaintJob(IPlayer& player, IVehicle& vehicle, int paintJob) override
 	{
-		cell ret = PawnManager::Get()->CallInEntry("OnVehiclePaintjob", DefaultReturnValue_True, player.getID(), vehicle.getID(), paintJob);
+		cell ret = PawnManager::Get()->CallInEntry(PawnCallbacks::OnVehiclePaintjob, DefaultReturnValue_True, player.getID(), vehicle.getID(), paintJob);
 		if (ret)
 		{
-			ret = PawnManager::Get()->CallInSidesWhile1("OnVehiclePaintjob", player.getID(), vehicle.getID(), paintJob);
+			ret = PawnManager::Get()->CallInSidesWhile1(PawnCallbacks::OnVehiclePaintjob, player.getID(), vehicle.getID(), paintJob);
 		}
 		return !!ret;
 	}
 
 	bool onVehicleMod(IPlayer& player, IVehicle& vehicle, int component) override
 	{
-		cell ret = PawnManager::Get()->CallInEntry("OnVehicleMod", DefaultReturnValue_True, player.getID(), vehicle.getID(), component);
-		cell side_ret = PawnManager::Get()->CallInSidesWhile1("OnVehicleMod", player.getID(), vehicle.getID(), component);
+		cell ret = PawnManager::Get()->CallInEntry(PawnCallbacks::OnVehicleMod, DefaultReturnValue_True, player.getID(), vehicle.getID(), component);
+		cell side_ret = PawnManager::Get()->CallInSidesWhile1(PawnCallbacks::OnVehicleMod, player.getID(), vehicle.getID(), component);
 		return side_ret && ret;
 	}
 
 	bool onVehicleRespray(IPlayer& player, IVehicle& vehicle, int colour1, int colour2) override
 	{
-		cell ret = PawnManager::Get()->CallInEntry("OnVehicleRespray", DefaultReturnValue_True, player.getID(), vehicle.getID(), colour1, colour2);
+		cell ret = PawnManager::Get()->CallInEntry(PawnCallbacks::OnVehicleRespray, DefaultReturnValue_True, player.getID(), vehicle.getID(), colour1, colour2);
 		if (ret)
 		{
-			ret = PawnManager::Get()->CallInSidesWhile1("OnVehicleRespray", player.getID(), vehicle.getID(), colour1, colour2);
+			ret = PawnManager::Get()->CallInSidesWhile1(PawnCallbacks::OnVehicleRespray, player.getID(), vehicle.getID(), colour1, colour2);
 		}
 		return !!ret;
 	}
 
 	void onEnterExitModShop(IPlayer& player, bool enterexit, int interiorID) override
 	{
-		PawnManager::Get()->CallInSidesWhile1("OnEnterExitModShop", player.getID(), enterexit, interiorID);
-		PawnManager::Get()->CallInEntry("OnEnterExitModShop", DefaultReturnValue_True, player.getID(), enterexit, interiorID);
+		PawnManager::Get()->CallInSidesWhile1(PawnCallbacks::OnEnterExitModShop, player.getID(), enterexit, interiorID);
+		PawnManager::Get()->CallInEntry(PawnCallbacks::OnEnterExitModShop, DefaultReturnValue_True, player.getID(), enterexit, interiorID);
 	}
 
 	void onVehicleSpawn(IVehicle& vehicle) override
 	{
-		PawnManager::Get()->CallInSidesWhile1("OnVehicleSpawn", vehicle.getID());
-		PawnManager::Get()->CallInEntry("OnVehicleSpawn", DefaultReturnValue_True, vehicle.getID());
+		PawnManager::Get()->CallInSidesWhile1(PawnCallbacks::OnVehicleSpawn, vehicle.getID());
+		PawnManager::Get()->CallInEntry(PawnCallbacks::OnVehicleSpawn, DefaultReturnValue_True, vehicle.getID());
 	}
 
 	bool onUnoccupiedVehicleUpdate(IVehicle& vehicle, IPlayer& player, UnoccupiedVehicleUpdate const updateData) override
 	{
 		cell ret = PawnManager::Get()->CallInSidesWhile1(
-			"OnUnoccupiedVehicleUpdate",
+			PawnCallbacks::OnUnoccupiedVehicleUpdate,
 			vehicle.getID(), player.getID(), updateData.seat,
 			updateData.position.x, updateData.position.y, updateData.position.z,
 			updateData.velocity.x, updateData.velocity.y, updateData.velocity.z);
 		if (ret)
 		{
 			ret = PawnManager::Get()->CallInEntry(
-				"OnUnoccupiedVehicleUpdate",
+				PawnCallbacks::OnUnoccupiedVehicleUpdate,
 				DefaultReturnValue_True,
 				vehicle.getID(), player.getID(), updateData.seat,
 				updateData.position.x, updateData.position.y, updateData.position.z,
@@ -104,20 +104,20 @@ struct VehicleEvents : public VehicleEventHandler, public Singleton<VehicleEvent
 
 	bool onTrailerUpdate(IPlayer& player, IVehicle& trailer) override
 	{
-		cell ret = PawnManager::Get()->CallInSides("OnTrailerUpdate", DefaultReturnValue_True, player.getID(), trailer.getID());
+		cell ret = PawnManager::Get()->CallInSides(PawnCallbacks::OnTrailerUpdate, DefaultReturnValue_True, player.getID(), trailer.getID());
 		if (ret)
 		{
-			ret = PawnManager::Get()->CallInEntry("OnTrailerUpdate", DefaultReturnValue_True, player.getID(), trailer.getID());
+			ret = PawnManager::Get()->CallInEntry(PawnCallbacks::OnTrailerUpdate, DefaultReturnValue_True, player.getID(), trailer.getID());
 		}
 		return !!ret;
 	}
 
 	bool onVehicleSirenStateChange(IPlayer& player, IVehicle& vehicle, uint8_t sirenState) override
 	{
-		cell ret = PawnManager::Get()->CallInSides("OnVehicleSirenStateChange", DefaultReturnValue_False, player.getID(), vehicle.getID(), sirenState);
+		cell ret = PawnManager::Get()->CallInSides(PawnCallbacks::OnVehicleSirenStateChange, DefaultReturnValue_False, player.getID(), vehicle.getID(), sirenState);
 		if (!ret)
 		{
-			ret = PawnManager::Get()->CallInEntry("OnVehicleSirenStateChange", DefaultReturnValue_True, player.getID(), vehicle.getID(), sirenState);
+			ret = PawnManager::Get()->CallInEntry(PawnCallbacks::OnVehicleSirenStateChange, DefaultReturnValue_True, player.getID(), vehicle.getID(), sirenState);
 		}
 		return !!ret;
 	}
@@ -7,6 +7,7 @@
  */
 
 #include <Impl/pool_impl.hpp>
+#include <Impl/spatial_index_impl.hpp>
 #include <Server/Components/Pickups/pickups.hpp>
 #include <netcode.hpp>
 #include <sdk.hpp>
@@ -24,6 +25,7 @@ private:
 	PickupType type;
 	bool isStatic_;
 	IPlayer* legacyPerPlayer_ = nullptr;
+	PoolStreamIndex<IPickup>& streamIndex_;
 
 	void restream()
 	{
@@ -87,12 +89,13 @@ public:
 		return isStatic_;
 	}
 
-	Pickup(int modelId, PickupType type, Vector3 pos, uint32_t virtualWorld, bool isStatic)
+	Pickup(PoolStreamIndex<IPickup>& streamIndex, int modelId, PickupType type, Vector3 pos, uint32_t virtualWorld, bool isStatic)
 		: virtualWorld(virtualWorld)
 		, modelId(modelId)
 		, pos(pos)
 		, type(type)
 		, isStatic_(isStatic)
+		, streamIndex_(streamIndex)
 	{
 	}
 
@@ -104,6 +107,7 @@ public:
 	void streamInForPlayer(IPlayer& player) override
 	{
 		streamedFor_.add(player.getID(), player);
+		streamIndex_.streamedIn(player, poolID);
 		streamInForClient(player);
 	}
 
@@ -156,6 +160,7 @@ public:
 	void setVirtualWorld(int vw) override
 	{
 		virtualWorld = vw;
+		streamIndex_.update(*this);
 		restream();
 	}
 
@@ -172,11 +177,13 @@ public:
 	void setPositionNoUpdate(Vector3 position) override
 	{
 		pos = position;
+		streamIndex_.update(*this);
 	}
 
 	void setPosition(Vector3 position) override
 	{
 		pos = position;
+		streamIndex_.update(*this);
 		restream();
 	}
 
@@ -99,6 +99,8 @@ private:
 	constexpr static const size_t Lower = 1;
 	constexpr static const size_t Upper = PICKUP_POOL_SIZE * (PLAYER_POOL_SIZE + 1) + Lower;
 
+	/// Declared before the storage so it outlives the entries it indexes
+	PoolStreamIndex<IPickup> streamIndex;
 	MarkedDynamicPoolStorage<Pickup, IPickup, Lower, Upper> storage;
 	DefaultEventDispatcher<PickupEventHandler> eventDispatcher;
 	IPlayerPool* players = nullptr;
@@ -161,6 +163,7 @@ public:
 	PickupsComponent()
 		: playerPickUpPickupEventHandler(*this)
 	{
+		storage.getEventDispatcher().addEventHandler(&streamIndex);
 	}
 
 	void onLoad(ICore* core) override
@@ -169,6 +172,7 @@ public:
 		players = &core->getPlayers();
 		players->getPlayerUpdateDispatcher().addEventHandler(this);
 		players->getPlayerConnectDispatcher().addEventHandler(this);
+		players->registerExtensionSlot(IPlayerPickupData::ExtensionIID);
 		players->getPoolEventDispatcher().addEventHandler(this);
 		NetCode::RPC::OnPlayerPickUpPickup::addEventHandler(*core, &playerPickUpPickupEventHandler);
 		streamConfigHelper = StreamConfigHelper(core->getConfig());
@@ -192,7 +196,7 @@ public:
 
 	IPickup* create(int modelId, PickupType type, Vector3 pos, uint32_t virtualWorld, bool isStatic) override
 	{
-		return storage.emplace(modelId, type, pos, virtualWorld, isStatic);
+		return storage.emplace(streamIndex, modelId, type, pos, virtualWorld, isStatic);
 	}
 
 	void onPoolEntryDestroyed(IPlayer& player) override
@@ -212,6 +216,7 @@ public:
 				pickup->setPickupHiddenForPlayer(player, false);
 			}
 		}
+		streamIndex.removePlayer(player);
 	}
 
 	void free() override
@@ -286,23 +291,33 @@ public:
 			{
 				return true;
 			}
-			Vector3 pos = player.getPosition();
-			for (IPickup* p : storage)
-			{
-				Pickup* pickup = static_cast<Pickup*>(p);
-
-				const Vector3 dist3D = pickup->getPosition() - pos;
-				const bool shouldBeStreamedIn = !pickup->isPickupHiddenForPlayer(player) && (player.getVirtualWorld() == pickup->getVirtualWorld() || pickup->getVirtualWorld() == -1) && glm::dot(dist3D, dist3D) < maxDist;
-
-				const bool isStreamedIn = pickup->isStreamedInForPlayer(player);
-				if (!isStreamedIn && shouldBeStreamedIn)
+			const Vector3 pos = player.getPosition();
+			const int vw = player.getVirtualWorld();
+			streamIndex.forEachCandidate(storage, player, pos, vw, streamConfigHelper.getDistance(), [&](IPickup& p)
 				{
-					pickup->streamInForPlayer(player);
-				}
-				else if (isStreamedIn && !shouldBeStreamedIn)
-				{
-					pickup->streamOutForPlayer(player);
-				}
+					Pickup& pickup = static_cast<Pickup&>(p);
+
+					const Vector3 dist3D = pickup.getPosition() - pos;
+					const float distSqr = glm::dot(dist3D, dist3D);
+					const bool shouldBeStreamedIn = !pickup.isPickupHiddenForPlayer(player) && (vw == pickup.getVirtualWorld() || pickup.getVirtualWorld() == -1) && distSqr < maxDist;
+
+					const bool isStreamedIn = pickup.isStreamedInForPlayer(player);
+					if (!isStreamedIn && shouldBeStreamedIn)
+					{
+						streamIndex.queueStreamIn(pickup, distSqr);
+					}
+					else if (isStreamedIn && !shouldBeStreamedIn)
+					{
+						pickup.streamOutForPlayer(player);
+					}
+				});
+
+			if (streamIndex.streamInNearest(storage, streamConfigHelper.getStreamInBudget(), [&player](IPickup& pickup)
+					{
+						pickup.streamInForPlayer(player);
+					}))
+			{
+				streamConfigHelper.requestStream(player.getID());
 			}
 		}
 
@@ -0,0 +1,264 @@
+/*
+ *  This Source Code Form is subject to the terms of the Mozilla Public License,
+ *  v. 2.0. If a copy of the MPL was not distributed with this file, You can
+ *  obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ *  The original code is copyright (c) 2022, open.mp team and contributors.
+ */
+
+#include <Impl/pool_impl.hpp>
+#include <random>
+#include <sdk.hpp>
+
+using namespace Impl;
+
+/// Number of IDs in the benchmarked pools, the size of the object pool
+constexpr size_t benchmarkPoolSize(2000);
+
+/// Fractions of the pool left in use when measuring the loops
+const float benchmarkPoolFill[] = { 0.01f, 0.1f, 0.5f, 1.0f };
+
+/// How many times each loop is timed
+const int benchmarkRepeats(2000);
+
+/// An entry of the benchmarked pools
+struct IPoolBenchmarkEntry : public IIDProvider
+{
+	virtual int getValue() const = 0;
+};
+
+struct PoolBenchmarkEntry final : public IPoolBenchmarkEntry, public PoolIDProvider
+{
+	int value;
+
+	PoolBenchmarkEntry(int value)
+		: value(value)
+	{
+	}
+
+	int getID() const override
+	{
+		return poolID;
+	}
+
+	int getValue() const override
+	{
+		return value;
+	}
+};
+
+/// Checks PoolIDSet's word skipping against a bit by bit walk and measures looping over and claiming IDs in marked pools
+struct PoolBenchmarkComponent final : public IComponent, public NoCopy
+{
+	using Set = PoolIDSet<benchmarkPoolSize>;
+	using Storage = MarkedPoolStorage<PoolBenchmarkEntry, IPoolBenchmarkEntry, 0, benchmarkPoolSize>;
+	using DynamicStorage = MarkedDynamicPoolStorage<PoolBenchmarkEntry, IPoolBenchmarkEntry, 0, benchmarkPoolSize>;
+
+	/// Core
+	ICore* core = nullptr;
+
+	/// Random IDs, seeded so every run measures the same pools
+	std::mt19937 random { 0x5eed };
+
+	/// Gets the component UID
+	/// @returns Component UID
+	UID getUID() override
+	{
+		return 0x2b8e6a41d0f9c573;
+	}
+
+	/// Gets the component name
+	/// @returns Component name
+	StringView componentName() const override
+	{
+		return "Pool benchmark";
+	}
+
+	/// Gets the component type
+	/// @returns Component type
+	ComponentType componentType() const override
+	{
+		return ComponentType::Other;
+	}
+
+	/// Gets the component version
+	/// @return Component version
+	SemanticVersion componentVersion() const override
+	{
+		return SemanticVersion(OMP_VERSION_MAJOR, OMP_VERSION_MINOR, OMP_VERSION_PATCH, BUILD_NUMBER);
+	}
+
+	/// Called for every component after components have been loaded
+	/// @param c Core
+	void onLoad(ICore* c) override
+	{
+		core = c;
+	}
+
+	/// Runs the checks and the benchmark, none of it touches the server's own pools
+	void onReady() override
+	{
+		const int errors = checkIDSet();
+		if (errors)
+		{
+			core->printLn("[ERROR] Pool benchmark: PoolIDSet disagreed with a bit by bit walk %d times.", errors);
+		}
+		else
+		{
+			core->printLn("Pool benchmark: PoolIDSet agrees with a bit by bit walk");
+		}
+
+		for (const float fill : benchmarkPoolFill)
+		{
+			benchmarkLoops<Storage>("static", fill);
+			benchmarkLoops<DynamicStorage>("dynamic", fill);
+		}
+		benchmarkClaims();
+	}
+
+	/// Fill a set with each ID in it with a chance of fill
+	void fillSet(Set& set, float fill)
+	{
+		std::bernoulli_distribution used(fill);
+		set.reset();
+		for (int i = 0; i < int(benchmarkPoolSize); ++i)
+		{
+			if (used(random))
+			{
+				set.set(i);
+			}
+		}
+	}
+
+	/// Compare next and nextFree from every ID against testing every bit, returns the number of mismatches
+	int checkIDSet()
+	{
+		int errors = 0;
+		Set set;
+		for (const float fill : { 0.0f, 0.001f, 0.5f, 0.999f, 1.0f })
+		{
+			fillSet(set, fill);
+			for (int from = -1; from <= int(benchmarkPoolSize); ++from)
+			{
+				int next = -1;
+				int nextFree = -1;
+				for (int i = std::max(from, 0); i < int(benchmarkPoolSize); ++i)
+				{
+					if (next == -1 && set.test(i))
+					{
+						next = i;
+					}
+					if (nextFree == -1 && !set.test(i))
+					{
+						nextFree = i;
+					}
+				}
+				errors += set.next(from) != next;
+				errors += set.nextFree(from) != nextFree;
+			}
+		}
+		return errors;
+	}
+
+	/// Time looping over a pool with some of its IDs in use through its iterators and through its entries set
+	template <class PoolStorage>
+	void benchmarkLoops(const char* type, float fill)
+	{
+		PoolStorage storage;
+		for (int i = 0; i < int(benchmarkPoolSize); ++i)
+		{
+			storage.emplace(i);
+		}
+		std::bernoulli_distribution keep(fill);
+		for (int i = 0; i < int(benchmarkPoolSize); ++i)
+		{
+			if (!keep(random))
+			{
+				storage.release(i, false);
+			}
+		}
+
+		// Sum the values so the loops can't be optimised away
+		int64_t iteratorSum = 0;
+		const TimePoint iteratorStart = Time::now();
+		for (int repeat = 0; repeat < benchmarkRepeats; ++repeat)
+		{
+			for (IPoolBenchmarkEntry* entry : storage)
+			{
+				iteratorSum += entry->getValue();
+			}
+		}
+		const Microseconds iteratorTime = duration_cast<Microseconds>(Time::now() - iteratorStart);
+
+		int64_t entriesSum = 0;
+		const TimePoint entriesStart = Time::now();
+		for (int repeat = 0; repeat < benchmarkRepeats; ++repeat)
+		{
+			for (IPoolBenchmarkEntry* entry : storage._entries())
+			{
+				entriesSum += entry->getValue();
+			}
+		}
+		const Microseconds entriesTime = duration_cast<Microseconds>(Time::now() - entriesStart);
+
+		core->printLn("Pool benchmark: %s pool %zu/%zu used, iterators %.3fus and entries set %.3fus per loop", type, storage._entries().size(), benchmarkPoolSize, iteratorTime.count() / float(benchmarkRepeats), entriesTime.count() / float(benchmarkRepeats));
+		if (iteratorSum != entriesSum)
+		{
+			core->printLn("[ERROR] Pool benchmark: the iterators visited different entries than the entries set.");
+		}
+	}
+
+	/// Time finding free IDs in a nearly full pool, the case where scanning bit by bit was slowest
+	void benchmarkClaims()
+	{
+		Storage storage;
+		for (int i = 0; i < int(benchmarkPoolSize); ++i)
+		{
+			storage.emplace(i);
+		}
+
+		// Free a few IDs near the top and keep claiming and releasing them from the bottom of the pool
+		const int freeIDs[] = { int(benchmarkPoolSize) - 100, int(benchmarkPoolSize) - 50, int(benchmarkPoolSize) - 1 };
+		for (const int id : freeIDs)
+		{
+			storage.release(id, false);
+		}
+
+		int errors = 0;
+		const TimePoint start = Time::now();
+		for (int repeat = 0; repeat < benchmarkRepeats; ++repeat)
+		{
+			for (const int id : freeIDs)
+			{
+				errors += storage.findFreeIndex(0) != id;
+				storage.claimHint(id, repeat);
+			}
+			for (const int id : freeIDs)
+			{
+				storage.release(id, false);
+			}
+		}
+		const Microseconds time = duration_cast<Microseconds>(Time::now() - start);
+
+		core->printLn("Pool benchmark: %.3fus to find a free ID near the top of a full pool", time.count() / float(benchmarkRepeats * 3));
+		if (errors)
+		{
+			core->printLn("[ERROR] Pool benchmark: the wrong free ID was found %d times.", errors);
+		}
+	}
+
+	/// Frees this component, it isn't allocated
+	void free() override
+	{
+	}
+
+	void reset() override
+	{
+		// Nothing to reset here.
+	}
+} poolBenchmarkComponent;
+
+COMPONENT_ENTRY_POINT()
+{
+	return &poolBenchmarkComponent;
+}
@@ -0,0 +1,321 @@
+/*
+ *  This Source Code Form is subject to the terms of the Mozilla Public License,
+ *  v. 2.0. If a copy of the MPL was not distributed with this file, You can
+ *  obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ *  The original code is copyright (c) 2022, open.mp team and contributors.
+ */
+
+#include <atomic>
+#include <cstring>
+#include <sdk.hpp>
+#include <thread>
+
+#if OMP_BUILD_PLATFORM == OMP_UNIX
+#include <sys/socket.h>
+#include <unistd.h>
+#endif
+
+using namespace Impl;
+
+/// Size of a query without its payload: "SAMP", the server's address and port and the query type
+constexpr size_t queryHeaderSize(11);
+
+/// How long to wait for the server to answer its first query
+const Seconds queryStartTimeout(10);
+
+/// How long a query is waited for before it's counted as unanswered
+const Milliseconds queryReceiveTimeout(250);
+
+/// How long the throughput is measured for
+const Seconds queryThroughputDuration(3);
+
+/// Queries sent before waiting for their responses when measuring the throughput
+const int queryThroughputWindow(32);
+
+/// Measures how many legacy queries the server answers per second from its published responses, and checks their rate limit
+/// Queries are sent to the server's own port from a background thread, like a server browser would, and the results are printed on the main thread
+struct QueryBenchmarkComponent final : public IComponent, public CoreEventHandler, public NoCopy
+{
+#if OMP_BUILD_PLATFORM == OMP_WINDOWS
+	using Socket = SOCKET;
+	static constexpr Socket InvalidSocket = INVALID_SOCKET;
+#else
+	using Socket = int;
+	static constexpr Socket InvalidSocket = -1;
+#endif
+
+	/// Core
+	ICore* core = nullptr;
+
+	/// Thread sending the queries
+	std::thread thread;
+
+	/// Cleared to stop the thread early
+	std::atomic_bool running = false;
+
+	/// Set by the thread once the results can be printed
+	std::atomic_bool finished = false;
+
+	/// Socket the queries are sent from
+	Socket sock = InvalidSocket;
+
+	/// Address of the server
+	sockaddr_in server {};
+
+	/// The server's network.query_rate_limit
+	int rateLimit = 0;
+
+	/// Results, written by the thread before setting finished
+	String error;
+	int burstSent = 0;
+	int burstAnswered = 0;
+	int throughputSent = 0;
+	int throughputAnswered = 0;
+	Microseconds throughputTime { 0 };
+
+	/// Gets the component UID
+	/// @returns Component UID
+	UID getUID() override
+	{
+		return 0x6d1b4f0e92a7c35e;
+	}
+
+	/// Gets the component name
+	/// @returns Component name
+	StringView componentName() const override
+	{
+		return "Query benchmark";
+	}
+
+	/// Gets the component type
+	/// @returns Component type
+	ComponentType componentType() const override
+	{
+		return ComponentType::Other;
+	}
+
+	/// Gets the component version
+	/// @return Component version
+	SemanticVersion componentVersion() const override
+	{
+		return SemanticVersion(OMP_VERSION_MAJOR, OMP_VERSION_MINOR, OMP_VERSION_PATCH, BUILD_NUMBER);
+	}
+
+	/// Called for every component after components have been loaded
+	/// Should be used for storing the core interface, registering player/core event handlers
+	/// Should NOT be used for interacting with other components as they might not have been initialised yet
+	/// @param c Core
+	void onLoad(ICore* c) override
+	{
+		core = c;
+		core->getEventDispatcher().addEventHandler(this);
+	}
+
+	/// Called when all components are ready, starts sending queries to the server
+	void onReady() override
+	{
+		IConfig& config = core->getConfig();
+		const bool* enableQuery = config.getBool("enable_query");
+		if (enableQuery && !*enableQuery)
+		{
+			core->printLn("Query benchmark: queries are disabled, set enable_query to run it");
+			return;
+		}
+
+		const int* limit = config.getInt("network.query_rate_limit");
+		rateLimit = limit ? *limit : 0;
+
+		StringView bind = config.getString("network.bind");
+		server.sin_family = AF_INET;
+		server.sin_port = htons(static_cast<uint16_t>(*config.getInt("network.port")));
+		server.sin_addr.s_addr = inet_addr(bind.empty() ? "127.0.0.1" : String(bind).c_str());
+
+		sock = socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP);
+		if (sock == InvalidSocket)
+		{
+			core->printLn("[ERROR] Query benchmark: failed to create a socket.");
+			return;
+		}
+		setReceiveTimeout(queryReceiveTimeout);
+
+		running = true;
+		thread = std::thread(&QueryBenchmarkComponent::run, this);
+	}
+
+	/// Prints the results once the thread has finished
+	void onTick(Microseconds elapsed, TimePoint now) override
+	{
+		if (!finished)
+		{
+			return;
+		}
+		finished = false;
+		thread.join();
+		closeSocket();
+
+		if (!error.empty())
+		{
+			core->printLn("[ERROR] Query benchmark: %s", error.c_str());
+			return;
+		}
+
+		if (rateLimit > 0)
+		{
+			core->printLn("Query benchmark: %d of a burst of %d queries answered with network.query_rate_limit %d", burstAnswered, burstSent, rateLimit);
+			if (burstAnswered < rateLimit || burstAnswered >= burstSent)
+			{
+				core->printLn("[ERROR] Query benchmark: expected the burst to be cut off after about %d queries.", rateLimit);
+			}
+			core->printLn("Query benchmark: set network.query_rate_limit to 0 to measure the throughput");
+			return;
+		}
+
+		const double seconds(throughputTime.count() / 1000000.0);
+		core->printLn("Query benchmark: %d of %d queries answered in %.3f seconds, %.0f queries per second", throughputAnswered, throughputSent, seconds, seconds > 0.0 ? throughputAnswered / seconds : 0.0);
+		if (throughputAnswered != throughputSent)
+		{
+			core->printLn("[ERROR] Query benchmark: %d queries weren't answered.", throughputSent - throughputAnswered);
+		}
+	}
+
+	/// Sends the queries, runs on the benchmark thread
+	void run()
+	{
+		// The responses are published on the first tick after the network starts
+		const TimePoint start(Time::now());
+		bool answered(false);
+		while (running && !answered && Time::now() - start < queryStartTimeout)
+		{
+			answered = sendQuery('i') && receiveResponse('i');
+		}
+		if (!answered)
+		{
+			error = "the server didn't answer a query.";
+			finished = true;
+			return;
+		}
+
+		if (rateLimit > 0)
+		{
+			measureRateLimit();
+		}
+		else
+		{
+			measureThroughput();
+		}
+		finished = true;
+	}
+
+	/// Sends twice the rate limit at once after the bucket has refilled, only about as many as the limit should be answered
+	void measureRateLimit()
+	{
+		std::this_thread::sleep_for(Milliseconds(1100));
+		for (burstSent = 0; burstSent < rateLimit * 2; burstSent++)
+		{
+			sendQuery('i');
+		}
+		while (running && receiveResponse('i'))
+		{
+			++burstAnswered;
+		}
+	}
+
+	/// Keeps a window of server info and rules queries in flight, sending the next one as each response arrives
+	void measureThroughput()
+	{
+		const char types[] = { 'i', 'r' };
+		const TimePoint start(Time::now());
+		for (; throughputSent < queryThroughputWindow; throughputSent++)
+		{
+			sendQuery(types[throughputSent % 2]);
+		}
+		while (running && throughputAnswered < throughputSent)
+		{
+			if (!receiveResponse(0))
+			{
+				break;
+			}
+			++throughputAnswered;
+			if (Time::now() - start < queryThroughputDuration)
+			{
+				sendQuery(types[throughputSent++ % 2]);
+			}
+		}
+		throughputTime = duration_cast<Microseconds>(Time::now() - start);
+	}
+
+	/// Sends a query of a type
+	bool sendQuery(char type)
+	{
+		char query[queryHeaderSize] = { 'S', 'A', 'M', 'P' };
+		memcpy(&query[4], &server.sin_addr.s_addr, sizeof(uint32_t));
+		query[8] = static_cast<char>(ntohs(server.sin_port) & 0xFF);
+		query[9] = static_cast<char>(ntohs(server.sin_port) >> 8);
+		query[10] = type;
+		return sendto(sock, query, sizeof(query), 0, reinterpret_cast<const sockaddr*>(&server), sizeof(server)) == sizeof(query);
+	}
+
+	/// Waits for a response, of a type unless it's 0
+	bool receiveResponse(char type)
+	{
+		char response[2048];
+		for (;;)
+		{
+			const int length(recv(sock, response, sizeof(response), 0));
+			if (length < static_cast<int>(queryHeaderSize) || memcmp(response, "SAMP", 4) != 0)
+			{
+				return false;
+			}
+			if (type == 0 || response[10] == type)
+			{
+				return true;
+			}
+		}
+	}
+
+	void setReceiveTimeout(Milliseconds timeout)
+	{
+#if OMP_BUILD_PLATFORM == OMP_WINDOWS
+		DWORD value(static_cast<DWORD>(timeout.count()));
+#else
+		timeval value { static_cast<time_t>(timeout.count() / 1000), static_cast<suseconds_t>((timeout.count() % 1000) * 1000) };
+#endif
+		setsockopt(sock, SOL_SOCKET, SO_RCVTIMEO, reinterpret_cast<const char*>(&value), sizeof(value));
+	}
+
+	void closeSocket()
+	{
+		if (sock != InvalidSocket)
+		{
+#if OMP_BUILD_PLATFORM == OMP_WINDOWS
+			closesocket(sock);
+#else
+			close(sock);
+#endif
+			sock = InvalidSocket;
+		}
+	}
+
+	/// Stops the thread, the network is still running when components are freed
+	void free() override
+	{
+		running = false;
+		if (thread.joinable())
+		{
+			thread.join();
+		}
+		closeSocket();
+		core->getEventDispatcher().removeEventHandler(this);
+	}
+
+	void reset() override
+	{
+		// Nothing to reset here.
+	}
+} queryBenchmarkComponent;
+
+COMPONENT_ENTRY_POINT()
+{
+	return &queryBenchmarkComponent;
+}
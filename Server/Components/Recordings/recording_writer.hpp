@@ -0,0 +1,149 @@
+/*
+ *  This Source Code Form is subject to the terms of the Mozilla Public License,
+ *  v. 2.0. If a copy of the MPL was not distributed with this file, You can
+ *  obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ *  The original code is copyright (c) 2022, open.mp team and contributors.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <types.hpp>
+
+using namespace Impl;
+
+/// An operation on a recording file, done in the order they're pushed
+struct RecordingCommand
+{
+	enum class Type
+	{
+		Open, ///< Truncate or create the file at path, then write data
+		Write, ///< Write data
+		Close ///< Flush and close the file
+	};
+
+	Type type;
+	std::shared_ptr<std::ofstream> file;
+	String path;
+	DynamicArray<char> data;
+};
+
+/// Writes recording files from a background thread so recording never waits on the disk
+/// Files are opened, written and closed by the same thread so a file can be recorded again right after it's closed
+class RecordingWriter final : public NoCopy
+{
+public:
+	/// Queued bytes above which written data is dropped, opening and closing files is never dropped
+	static constexpr size_t MaxQueuedBytes = 8 * 1024 * 1024;
+
+	~RecordingWriter()
+	{
+		stop();
+	}
+
+	void start()
+	{
+		if (!running_)
+		{
+			running_ = true;
+			thread_ = std::thread(&RecordingWriter::run, this);
+		}
+	}
+
+	/// Write everything queued and stop the thread, commands pushed afterwards are done by the caller
+	void stop()
+	{
+		if (thread_.joinable())
+		{
+			{
+				std::scoped_lock lock(mutex_);
+				running_ = false;
+			}
+			wake_.notify_all();
+			thread_.join();
+		}
+	}
+
+	/// Returns false if the data was dropped because the writer couldn't keep up
+	bool push(RecordingCommand&& command)
+	{
+		if (!running_)
+		{
+			execute(command);
+			return true;
+		}
+
+		{
+			std::scoped_lock lock(mutex_);
+			if (command.type == RecordingCommand::Type::Write && queuedBytes_ >= MaxQueuedBytes)
+			{
+				return false;
+			}
+			queuedBytes_ += command.data.size();
+			queue_.emplace_back(std::move(command));
+		}
+		wake_.notify_one();
+		return true;
+	}
+
+private:
+	static void execute(RecordingCommand& command)
+	{
+		std::ofstream& file = *command.file;
+		switch (command.type)
+		{
+		case RecordingCommand::Type::Open:
+			file.open(command.path, std::ios_base::out | std::ios_base::binary);
+			[[fallthrough]];
+		case RecordingCommand::Type::Write:
+			if (file.good() && !command.data.empty())
+			{
+				file.write(command.data.data(), command.data.size());
+			}
+			break;
+		case RecordingCommand::Type::Close:
+			file.close();
+			break;
+		}
+	}
+
+	void run()
+	{
+		DynamicArray<RecordingCommand> batch;
+		for (;;)
+		{
+			{
+				std::unique_lock lock(mutex_);
+				wake_.wait(lock, [this]()
+					{
+						return !queue_.empty() || !running_;
+					});
+				if (queue_.empty() && !running_)
+				{
+					break;
+				}
+				batch.swap(queue_);
+				queuedBytes_ = 0;
+			}
+
+			for (RecordingCommand& command : batch)
+			{
+				execute(command);
+			}
+			batch.clear();
+		}
+	}
+
+	std::thread thread_;
+	std::atomic_bool running_ = false;
+	std::mutex mutex_;
+	std::condition_variable wake_;
+	DynamicArray<RecordingCommand> queue_;
+	size_t queuedBytes_ = 0;
+};
@@ -11,18 +11,146 @@
 #include <netcode.hpp>
 #include <ghc/filesystem.hpp>
 
+#include "recording_writer.hpp"
+
 class PlayerRecordingData final : public IPlayerRecordingData
 {
 private:
+	/// Buffered records are handed to the writer once they reach this size or are older than FlushInterval
+	static constexpr size_t BlockSize = 16 * 1024;
+	static constexpr Seconds FlushInterval = Seconds(1);
+
+	ICore& core_;
+	std::shared_ptr<RecordingWriter> writer_;
 	PlayerRecordingType type_ = PlayerRecordingType_None;
 	TimePoint start_ = TimePoint();
-	std::ofstream file_;
+	TimePoint bufferStart_ = TimePoint(); ///< When the first buffered record was added
+	std::shared_ptr<std::ofstream> file_;
+	DynamicArray<char> buffer_;
+	size_t dropped_ = 0;
 
 	friend class RecordingsComponent;
 
+	/// Append the bytes of a value to the record buffer
+	template <typename T>
+	void put(const T& value, size_t size = sizeof(T))
+	{
+		const char* bytes = reinterpret_cast<const char*>(&value);
+		buffer_.insert(buffer_.end(), bytes, bytes + size);
+	}
+
+	/// Start a record with the time since the recording started
+	void beginRecord(size_t size)
+	{
+		const TimePoint now = Time::now();
+		if (buffer_.empty())
+		{
+			bufferStart_ = now;
+		}
+		buffer_.reserve(buffer_.size() + size);
+		const uint32_t timeSinceRecordStart = duration_cast<Milliseconds>(now - start_).count();
+		put(timeSinceRecordStart);
+	}
+
+	/// Hand the buffered records to the writer if the block is full or has waited long enough
+	void endRecord()
+	{
+		if (buffer_.size() >= BlockSize || Time::now() - bufferStart_ >= FlushInterval)
+		{
+			flush();
+		}
+	}
+
+	void flush()
+	{
+		if (buffer_.empty())
+		{
+			return;
+		}
+		const size_t size = buffer_.size();
+		if (!writer_->push(RecordingCommand { RecordingCommand::Type::Write, file_, String(), std::move(buffer_) }))
+		{
+			dropped_ += size;
+		}
+		buffer_ = DynamicArray<char>();
+		buffer_.reserve(BlockSize);
+	}
+
 public:
+	/// The size of an on foot record, including its time
+	static constexpr size_t OnFootRecordSize = 72;
+
+	/// The size of a driver record, including its time
+	static constexpr size_t DriverRecordSize = 67;
+
+	PlayerRecordingData(ICore& core, std::shared_ptr<RecordingWriter> writer)
+		: core_(core)
+		, writer_(std::move(writer))
+	{
+	}
+
+	~PlayerRecordingData()
+	{
+		stop();
+	}
+
+	bool recording(PlayerRecordingType type) const
+	{
+		return type_ == type && file_ != nullptr;
+	}
+
+	void writeOnFoot(const NetCode::Packet::PlayerFootSync& footSync)
+	{
+		beginRecord(OnFootRecordSize);
+
+		uint8_t health = static_cast<uint8_t>(footSync.HealthArmour.x);
+		uint8_t armour = static_cast<uint8_t>(footSync.HealthArmour.y);
+		put(footSync.LeftRight);
+		put(footSync.UpDown);
+		put(footSync.Keys);
+		put(footSync.Position, sizeof(float) * 3);
+		put(footSync.Rotation, sizeof(float) * 4);
+		put(health);
+		put(armour);
+		put(footSync.WeaponAdditionalKey);
+		put(footSync.SpecialAction);
+		put(footSync.Velocity, sizeof(float) * 3);
+		put(footSync.SurfingData.offset, sizeof(float) * 3);
+		put(footSync.SurfingData.ID, sizeof(uint16_t));
+		put(footSync.AnimationID);
+		put(footSync.AnimationFlags);
+
+		endRecord();
+	}
+
+	void writeDriver(const NetCode::Packet::PlayerVehicleSync& vehicleSync)
+	{
+		beginRecord(DriverRecordSize);
+
+		uint8_t playerHealth = static_cast<uint8_t>(vehicleSync.PlayerHealthArmour.x);
+		uint8_t playerArmour = static_cast<uint8_t>(vehicleSync.PlayerHealthArmour.y);
+		put(vehicleSync.VehicleID);
+		put(vehicleSync.LeftRight);
+		put(vehicleSync.UpDown);
+		put(vehicleSync.Keys);
+		put(vehicleSync.Rotation, sizeof(float) * 4);
+		put(vehicleSync.Position, sizeof(float) * 3);
+		put(vehicleSync.Velocity, sizeof(float) * 3);
+		put(vehicleSync.Health);
+		put(playerHealth);
+		put(playerArmour);
+		put(vehicleSync.AdditionalKeyWeapon);
+		put(vehicleSync.Siren);
+		put(vehicleSync.LandingGear);
+		put(vehicleSync.TrailerID);
+		put(vehicleSync.HydraThrustAngle, sizeof(uint32_t));
+
+		endRecord();
+	}
+
 	void start(PlayerRecordingType type, StringView file) override
 	{
+		stop();
 		type_ = type;
 		start_ = Time::now();
 
@@ -32,15 +160,17 @@ public:
 			ghc::filesystem::create_directory(scriptfilesPath);
 		}
 		auto filePath = scriptfilesPath / ghc::filesystem::path(std::string(file) + ".rec");
-		file_.open(filePath.string(), std::ios_base::out | std::ios_base::binary);
 
-		// Write recording header
-		if (file_.good())
-		{
-			uint32_t version = 1000;
-			file_.write(reinterpret_cast<const char*>(&version), sizeof(uint32_t));
-			file_.write(reinterpret_cast<const char*>(&type_), sizeof(uint32_t));
-		}
+		// Write recording header, the file is opened by the writer
+		RecordingCommand open { RecordingCommand::Type::Open, std::make_shared<std::ofstream>(), filePath.string(), {} };
+		file_ = open.file;
+		buffer_.reserve(BlockSize);
+		uint32_t version = 1000;
+		put(version);
+		put(type_, sizeof(uint32_t));
+		open.data = std::move(buffer_);
+		buffer_ = DynamicArray<char>();
+		writer_->push(std::move(open));
 
 		// To view/edit the recorded data as a CSV, see https://github.com/WoutProvost/samp-rec-to-csv
 
@@ -54,9 +184,19 @@ public:
 
 	void stop() override
 	{
+		if (file_)
+		{
+			flush();
+			writer_->push(RecordingCommand { RecordingCommand::Type::Close, std::move(file_), String(), {} });
+			file_ = nullptr;
+			if (dropped_)
+			{
+				core_.logLn(LogLevel::Warning, "Dropped %zu bytes of recorded data, the recording writer couldn't keep up.", dropped_);
+				dropped_ = 0;
+			}
+		}
 		type_ = PlayerRecordingType_None;
 		start_ = TimePoint();
-		file_.close();
 	}
 
 	void freeExtension() override
@@ -75,6 +215,9 @@ class RecordingsComponent final : public IRecordingsComponent, public PlayerConn
 private:
 	ICore* core = nullptr;
 
+	/// Shared with the player extensions, which may outlive the component
+	std::shared_ptr<RecordingWriter> writer = std::make_shared<RecordingWriter>();
+
 	struct OnFootRecordingHandler : public SingleNetworkInEventHandler
 	{
 		RecordingsComponent& self;
@@ -98,27 +241,9 @@ private:
 			}
 
 			// Write on foot recording data
-			if (data->type_ == PlayerRecordingType_OnFoot && data->file_.good())
+			if (data->recording(PlayerRecordingType_OnFoot))
 			{
-				const uint32_t timeSinceRecordStart = duration_cast<Milliseconds>(Time::now() - data->start_).count();
-				data->file_.write(reinterpret_cast<const char*>(&timeSinceRecordStart), sizeof(uint32_t));
-
-				uint8_t health = static_cast<uint8_t>(footSync.HealthArmour.x);
-				uint8_t armour = static_cast<uint8_t>(footSync.HealthArmour.y);
-				data->file_.write(reinterpret_cast<const char*>(&footSync.LeftRight), sizeof(uint16_t));
-				data->file_.write(reinterpret_cast<const char*>(&footSync.UpDown), sizeof(uint16_t));
-				data->file_.write(reinterpret_cast<const char*>(&footSync.Keys), sizeof(uint16_t));
-				data->file_.write(reinterpret_cast<const char*>(&footSync.Position), sizeof(float) * 3);
-				data->file_.write(reinterpret_cast<const char*>(&footSync.Rotation), sizeof(float) * 4);
-				data->file_.write(reinterpret_cast<const char*>(&health), sizeof(uint8_t));
-				data->file_.write(reinterpret_cast<const char*>(&armour), sizeof(uint8_t));
-				data->file_.write(reinterpret_cast<const char*>(&footSync.WeaponAdditionalKey), sizeof(uint8_t));
-				data->file_.write(reinterpret_cast<const char*>(&footSync.SpecialAction), sizeof(uint8_t));
-				data->file_.write(reinterpret_cast<const char*>(&footSync.Velocity), sizeof(float) * 3);
-				data->file_.write(reinterpret_cast<const char*>(&footSync.SurfingData.offset), sizeof(float) * 3);
-				data->file_.write(reinterpret_cast<const char*>(&footSync.SurfingData.ID), sizeof(uint16_t));
-				data->file_.write(reinterpret_cast<const char*>(&footSync.AnimationID), sizeof(uint16_t));
-				data->file_.write(reinterpret_cast<const char*>(&footSync.AnimationFlags), sizeof(uint16_t));
+				data->writeOnFoot(footSync);
 			}
 
 			return true;
@@ -148,28 +273,9 @@ private:
 			}
 
 			// Write driver recording data
-			if (data->type_ == PlayerRecordingType_Driver && data->file_.good())
+			if (data->recording(PlayerRecordingType_Driver))
 			{
-				const uint32_t timeSinceRecordStart = duration_cast<Milliseconds>(Time::now() - data->start_).count();
-				data->file_.write(reinterpret_cast<const char*>(&timeSinceRecordStart), sizeof(uint32_t));
-
-				uint8_t playerHealth = static_cast<uint8_t>(vehicleSync.PlayerHealthArmour.x);
-				uint8_t playerArmour = static_cast<uint8_t>(vehicleSync.PlayerHealthArmour.y);
-				data->file_.write(reinterpret_cast<const char*>(&vehicleSync.VehicleID), sizeof(uint16_t));
-				data->file_.write(reinterpret_cast<const char*>(&vehicleSync.LeftRight), sizeof(uint16_t));
-				data->file_.write(reinterpret_cast<const char*>(&vehicleSync.UpDown), sizeof(uint16_t));
-				data->file_.write(reinterpret_cast<const char*>(&vehicleSync.Keys), sizeof(uint16_t));
-				data->file_.write(reinterpret_cast<const char*>(&vehicleSync.Rotation), sizeof(float) * 4);
-				data->file_.write(reinterpret_cast<const char*>(&vehicleSync.Position), sizeof(float) * 3);
-				data->file_.write(reinterpret_cast<const char*>(&vehicleSync.Velocity), sizeof(float) * 3);
-				data->file_.write(reinterpret_cast<const char*>(&vehicleSync.Health), sizeof(float));
-				data->file_.write(reinterpret_cast<const char*>(&playerHealth), sizeof(uint8_t));
-				data->file_.write(reinterpret_cast<const char*>(&playerArmour), sizeof(uint8_t));
-				data->file_.write(reinterpret_cast<const char*>(&vehicleSync.AdditionalKeyWeapon), sizeof(uint8_t));
-				data->file_.write(reinterpret_cast<const char*>(&vehicleSync.Siren), sizeof(uint8_t));
-				data->file_.write(reinterpret_cast<const char*>(&vehicleSync.LandingGear), sizeof(uint8_t));
-				data->file_.write(reinterpret_cast<const char*>(&vehicleSync.TrailerID), sizeof(uint16_t));
-				data->file_.write(reinterpret_cast<const char*>(&vehicleSync.HydraThrustAngle), sizeof(uint32_t));
+				data->writeDriver(vehicleSync);
 			}
 
 			return true;
@@ -179,7 +285,7 @@ private:
 public:
 	void onPlayerConnect(IPlayer& player) override
 	{
-		player.addExtension(new PlayerRecordingData(), true);
+		player.addExtension(new PlayerRecordingData(*core, writer), true);
 	}
 
 	StringView componentName() const override
@@ -201,7 +307,9 @@ public:
 	void onLoad(ICore* c) override
 	{
 		core = c;
+		writer->start();
 		core->getPlayers().getPlayerConnectDispatcher().addEventHandler(this);
+		core->getPlayers().registerExtensionSlot(IPlayerRecordingData::ExtensionIID);
 		NetCode::Packet::PlayerFootSync::addEventHandler(*core, &onFootRecordingHandler);
 		NetCode::Packet::PlayerVehicleSync::addEventHandler(*core, &driverRecordingHandler);
 	}
@@ -234,6 +342,7 @@ public:
 			NetCode::Packet::PlayerFootSync::removeEventHandler(*core, &onFootRecordingHandler);
 			NetCode::Packet::PlayerVehicleSync::removeEventHandler(*core, &driverRecordingHandler);
 		}
+		writer->stop();
 	}
 };
 
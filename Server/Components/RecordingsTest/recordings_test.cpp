@@ -0,0 +1,245 @@
+/*
+ *  This Source Code Form is subject to the terms of the Mozilla Public License,
+ *  v. 2.0. If a copy of the MPL was not distributed with this file, You can
+ *  obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ *  The original code is copyright (c) 2022, open.mp team and contributors.
+ */
+
+#include "../Recordings/recording_writer.hpp"
+#include <ghc/filesystem.hpp>
+#include <sdk.hpp>
+
+#if OMP_BUILD_PLATFORM == OMP_UNIX
+#include <sys/stat.h>
+#endif
+
+using namespace Impl;
+
+/// Directory the recording files are written to, removed once the checks are done
+const char* testRecordingsDirectory("recordings_test/");
+
+/// Blocks written to each recording, enough for the writer to batch them
+const int testRecordingBlocks(1000);
+
+/// Size of the blocks written when flooding the writer, the queue limit is reached after a few of them
+constexpr size_t testFloodBlockSize(64 * 1024);
+
+/// Blocks written when flooding the writer, about sixteen times the queue limit
+const int testFloodBlocks(2000);
+
+/// Checks the recording writer opens, writes and closes files in order from its thread, drops data when it falls behind
+/// and does the work on the caller's thread once stopped
+struct RecordingsTestComponent final : public IComponent, public NoCopy
+{
+	/// Core
+	ICore* core = nullptr;
+
+	/// Failed checks
+	int errors = 0;
+
+	/// Gets the component UID
+	/// @returns Component UID
+	UID getUID() override
+	{
+		return 0x3f6c0b8e94a1d275;
+	}
+
+	/// Gets the component name
+	/// @returns Component name
+	StringView componentName() const override
+	{
+		return "Recordings test";
+	}
+
+	/// Gets the component type
+	/// @returns Component type
+	ComponentType componentType() const override
+	{
+		return ComponentType::Other;
+	}
+
+	/// Gets the component version
+	/// @return Component version
+	SemanticVersion componentVersion() const override
+	{
+		return SemanticVersion(OMP_VERSION_MAJOR, OMP_VERSION_MINOR, OMP_VERSION_PATCH, BUILD_NUMBER);
+	}
+
+	/// Called for every component after components have been loaded
+	/// @param c Core
+	void onLoad(ICore* c) override
+	{
+		core = c;
+	}
+
+	/// Runs the checks with a writer of its own, the recordings component's writer isn't touched
+	void onReady() override
+	{
+		std::error_code ec;
+		ghc::filesystem::remove_all(testRecordingsDirectory, ec);
+		ghc::filesystem::create_directories(testRecordingsDirectory, ec);
+		if (ec)
+		{
+			check(false, "Couldn't create the test directory.");
+			return;
+		}
+
+		testOrder();
+		testFlood();
+		testStopped();
+		ghc::filesystem::remove_all(testRecordingsDirectory, ec);
+
+		if (errors)
+		{
+			core->printLn("[ERROR] Recordings test: %d checks failed.", errors);
+		}
+		else
+		{
+			core->printLn("Recordings test passed");
+		}
+	}
+
+	/// Counts a failed check
+	/// @param condition Checked condition
+	/// @param description What was checked
+	void check(bool condition, const char* description)
+	{
+		if (!condition)
+		{
+			core->printLn("[ERROR] Recordings test: %s", description);
+			++errors;
+		}
+	}
+
+	/// Gets the path of a test recording
+	static String recordingPath(StringView name)
+	{
+		return String(testRecordingsDirectory) + String(name) + ".rec";
+	}
+
+	/// Reads a whole file
+	static String readFile(const String& path)
+	{
+		std::ifstream file(path, std::ios_base::in | std::ios_base::binary);
+		return String((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+	}
+
+	/// Gets a block of recorded data, different for every index
+	static DynamicArray<char> recordBlock(int index)
+	{
+		const String text = "record " + std::to_string(index) + ";";
+		return DynamicArray<char>(text.begin(), text.end());
+	}
+
+	/// Records blocks to a file, then records to the same file again straight after closing it
+	void testOrder()
+	{
+		RecordingWriter writer;
+		writer.start();
+
+		String expected;
+		auto file = std::make_shared<std::ofstream>();
+		writer.push(RecordingCommand { RecordingCommand::Type::Open, file, recordingPath("order"), { 'h', ';' } });
+		expected = "h;";
+		for (int i = 0; i < testRecordingBlocks; ++i)
+		{
+			DynamicArray<char> block = recordBlock(i);
+			expected.append(block.data(), block.size());
+			check(writer.push(RecordingCommand { RecordingCommand::Type::Write, file, String(), std::move(block) }), "Writing a block was dropped below the queue limit.");
+		}
+		writer.push(RecordingCommand { RecordingCommand::Type::Close, file, String(), {} });
+
+		// Opening the file again truncates it, the writer must have closed it first
+		auto again = std::make_shared<std::ofstream>();
+		writer.push(RecordingCommand { RecordingCommand::Type::Open, again, recordingPath("again"), { 'a' } });
+		writer.push(RecordingCommand { RecordingCommand::Type::Close, again, String(), {} });
+		again = std::make_shared<std::ofstream>();
+		writer.push(RecordingCommand { RecordingCommand::Type::Open, again, recordingPath("again"), { 'b' } });
+		writer.push(RecordingCommand { RecordingCommand::Type::Write, again, String(), { 'c' } });
+		writer.push(RecordingCommand { RecordingCommand::Type::Close, again, String(), {} });
+		writer.stop();
+
+		const String order = readFile(recordingPath("order"));
+		check(order == expected, "A recording doesn't have its blocks in the order they were written.");
+		check(readFile(recordingPath("again")) == "bc", "Recording to a file straight after closing it didn't replace it.");
+		core->printLn("Recordings test: %d blocks written in order, %zu bytes", testRecordingBlocks, order.size());
+	}
+
+	/// Writes much more than the queue limit to a pipe which is only read after a second, the data past the limit is dropped
+	void testFlood()
+	{
+#if OMP_BUILD_PLATFORM == OMP_UNIX
+		const String path = recordingPath("flood");
+		if (mkfifo(path.c_str(), 0600) != 0)
+		{
+			check(false, "Couldn't create the pipe to flood.");
+			return;
+		}
+
+		String flooded;
+		std::thread reader([&path, &flooded]()
+			{
+				std::ifstream pipe(path, std::ios_base::in | std::ios_base::binary);
+				std::this_thread::sleep_for(Seconds(1));
+				flooded.assign((std::istreambuf_iterator<char>(pipe)), std::istreambuf_iterator<char>());
+			});
+
+		RecordingWriter writer;
+		writer.start();
+		auto file = std::make_shared<std::ofstream>();
+		writer.push(RecordingCommand { RecordingCommand::Type::Open, file, path, {} });
+
+		String expected;
+		size_t dropped = 0;
+		for (int i = 0; i < testFloodBlocks; ++i)
+		{
+			DynamicArray<char> block(testFloodBlockSize, char('a' + i % 26));
+			if (writer.push(RecordingCommand { RecordingCommand::Type::Write, file, String(), block }))
+			{
+				expected.append(block.data(), block.size());
+			}
+			else
+			{
+				dropped += block.size();
+			}
+		}
+		check(writer.push(RecordingCommand { RecordingCommand::Type::Close, file, String(), {} }), "Closing a file was dropped.");
+		writer.stop();
+		reader.join();
+
+		check(dropped != 0, "Nothing was dropped while the writer was blocked.");
+		check(flooded == expected, "The data which wasn't dropped isn't what was written.");
+		core->printLn("Recordings test: %zu bytes written and %zu dropped while the writer was blocked", expected.size(), dropped);
+#endif
+	}
+
+	/// Once stopped, the writer does the work on the caller's thread before returning
+	void testStopped()
+	{
+		RecordingWriter writer;
+		writer.start();
+		writer.stop();
+
+		auto file = std::make_shared<std::ofstream>();
+		writer.push(RecordingCommand { RecordingCommand::Type::Open, file, recordingPath("stopped"), { 'x' } });
+		writer.push(RecordingCommand { RecordingCommand::Type::Write, file, String(), { 'y' } });
+		writer.push(RecordingCommand { RecordingCommand::Type::Close, file, String(), {} });
+		check(readFile(recordingPath("stopped")) == "xy", "A stopped writer didn't write on the caller's thread.");
+	}
+
+	/// Frees this component, it isn't allocated
+	void free() override
+	{
+	}
+
+	void reset() override
+	{
+		// Nothing to reset here.
+	}
+} recordingsTestComponent;
+
+COMPONENT_ENTRY_POINT()
+{
+	return &recordingsTestComponent;
+}
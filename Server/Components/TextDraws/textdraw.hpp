@@ -6,6 +6,7 @@
  *  The original code is copyright (c) 2022, open.mp team and contributors.
  */
 
+#include <Impl/pending_updates_impl.hpp>
 #include <Impl/pool_impl.hpp>
 #include <Server/Components/TextDraws/textdraws.hpp>
 #include <netcode.hpp>
@@ -59,13 +60,13 @@ public:
 	T& setPosition(Vector2 position) override
 	{
 		pos = position;
+		propertyChanged();
 		return *this;
 	}
 
 	void setText(StringView txt) override
 	{
-		text = txt;
-		trimText();
+		changeText(txt);
 	}
 
 	StringView getText() const override
@@ -76,6 +77,7 @@ public:
 	T& setColour(Colour col) override
 	{
 		letterColour = col;
+		propertyChanged();
 		return *this;
 	}
 
@@ -87,6 +89,7 @@ public:
 	T& setLetterSize(Vector2 size) override
 	{
 		letterSize = size;
+		propertyChanged();
 		return *this;
 	}
 
@@ -98,6 +101,7 @@ public:
 	T& setTextSize(Vector2 size) override
 	{
 		textSize = size;
+		propertyChanged();
 		return *this;
 	}
 
@@ -109,6 +113,7 @@ public:
 	T& setAlignment(TextDrawAlignmentTypes align) override
 	{
 		alignment = align;
+		propertyChanged();
 		return *this;
 	}
 
@@ -120,6 +125,7 @@ public:
 	T& useBox(bool use) override
 	{
 		box = use;
+		propertyChanged();
 		return *this;
 	}
 
@@ -131,6 +137,7 @@ public:
 	T& setBoxColour(Colour colour) override
 	{
 		boxColour = colour;
+		propertyChanged();
 		return *this;
 	}
 
@@ -142,6 +149,7 @@ public:
 	T& setShadow(int shadow) override
 	{
 		shadowSize = shadow;
+		propertyChanged();
 		return *this;
 	}
 
@@ -153,6 +161,7 @@ public:
 	T& setOutline(int outline) override
 	{
 		outlineSize = outline;
+		propertyChanged();
 		return *this;
 	}
 
@@ -164,6 +173,7 @@ public:
 	T& setBackgroundColour(Colour colour) override
 	{
 		backgroundColour = colour;
+		propertyChanged();
 		return *this;
 	}
 
@@ -177,9 +187,11 @@ public:
 		if (static_cast<int>(s) >= 16 || static_cast<int>(s) < 0)
 		{
 			style = TextDrawStyle_FontBeckettRegular;
+			propertyChanged();
 			return *this;
 		}
 		style = s;
+		propertyChanged();
 		return *this;
 	}
 
@@ -191,6 +203,7 @@ public:
 	T& setProportional(bool p) override
 	{
 		proportional = p;
+		propertyChanged();
 		return *this;
 	}
 
@@ -202,6 +215,7 @@ public:
 	T& setSelectable(bool select) override
 	{
 		selectable = select;
+		propertyChanged();
 		return *this;
 	}
 
@@ -213,6 +227,7 @@ public:
 	T& setPreviewModel(int model) override
 	{
 		previewModel = model;
+		propertyChanged();
 		return *this;
 	}
 
@@ -224,6 +239,7 @@ public:
 	T& setPreviewRotation(Vector3 rotation) override
 	{
 		previewRotation = rotation;
+		propertyChanged();
 		return *this;
 	}
 
@@ -236,6 +252,7 @@ public:
 	{
 		previewVehicleColours.first = colour1;
 		previewVehicleColours.second = colour2;
+		propertyChanged();
 		return *this;
 	}
 
@@ -247,6 +264,7 @@ public:
 	T& setPreviewZoom(float zoom) override
 	{
 		previewZoom = zoom;
+		propertyChanged();
 		return *this;
 	}
 
@@ -256,7 +274,23 @@ public:
 	}
 
 protected:
-	void showForClient(IPlayer& player, bool isPlayerTextDraw)
+	/// Called after a property sent with the textdraw when it's shown was set
+	virtual void propertyChanged() = 0;
+
+	/// Set the text, returns false if it didn't change so nothing needs to be sent
+	bool changeText(StringView txt)
+	{
+		const String newText = trimmed(txt);
+		if (StringView(newText) == StringView(text))
+		{
+			return false;
+		}
+		text = newText;
+		return true;
+	}
+
+	/// Build the RPC showing the textdraw, it points into the textdraw's text so it must be sent before the text changes
+	NetCode::RPC::PlayerShowTextDraw makeShowRPC(bool isPlayerTextDraw) const
 	{
 		NetCode::RPC::PlayerShowTextDraw playerShowTextDrawRPC;
 		playerShowTextDrawRPC.PlayerTextDraw = isPlayerTextDraw;
@@ -294,30 +328,62 @@ protected:
 		playerShowTextDrawRPC.Color1 = previewVehicleColours.first;
 		playerShowTextDrawRPC.Color2 = previewVehicleColours.second;
 		playerShowTextDrawRPC.Text = StringView(text);
-		PacketHelper::send(playerShowTextDrawRPC, player);
+		return playerShowTextDrawRPC;
 	}
 
-	void hideForClient(IPlayer& player, bool isPlayerTextDraw)
+	NetCode::RPC::PlayerHideTextDraw makeHideRPC(bool isPlayerTextDraw) const
 	{
 		NetCode::RPC::PlayerHideTextDraw playerHideTextDrawRPC;
 		playerHideTextDrawRPC.PlayerTextDraw = isPlayerTextDraw;
 		playerHideTextDrawRPC.TextDrawID = poolID;
-		PacketHelper::send(playerHideTextDrawRPC, player);
+		return playerHideTextDrawRPC;
 	}
 
-	void setTextForClient(IPlayer& player, StringView txt, bool isPlayerTextDraw)
+	NetCode::RPC::PlayerTextDrawSetString makeSetTextRPC(StringView txt, bool isPlayerTextDraw) const
 	{
 		NetCode::RPC::PlayerTextDrawSetString playerTextDrawSetStringRPC;
 		playerTextDrawSetStringRPC.PlayerTextDraw = isPlayerTextDraw;
 		playerTextDrawSetStringRPC.TextDrawID = poolID;
 		playerTextDrawSetStringRPC.Text = txt;
-		PacketHelper::send(playerTextDrawSetStringRPC, player);
+		return playerTextDrawSetStringRPC;
+	}
+
+	void showForClient(IPlayer& player, bool isPlayerTextDraw)
+	{
+		PacketHelper::send(makeShowRPC(isPlayerTextDraw), player);
+	}
+
+	void hideForClient(IPlayer& player, bool isPlayerTextDraw)
+	{
+		PacketHelper::send(makeHideRPC(isPlayerTextDraw), player);
+	}
+
+	void setTextForClient(IPlayer& player, StringView txt, bool isPlayerTextDraw)
+	{
+		PacketHelper::send(makeSetTextRPC(txt, isPlayerTextDraw), player);
+	}
+
+	// The RPCs are encoded once and the same bytes sent to every player
+
+	void showForClients(const FlatPtrHashSet<IPlayer>& players, bool isPlayerTextDraw)
+	{
+		PacketHelper::broadcastToSome(makeShowRPC(isPlayerTextDraw), players);
+	}
+
+	void hideForClients(const FlatPtrHashSet<IPlayer>& players, bool isPlayerTextDraw)
+	{
+		PacketHelper::broadcastToSome(makeHideRPC(isPlayerTextDraw), players);
+	}
+
+	void setTextForClients(const FlatPtrHashSet<IPlayer>& players, StringView txt, bool isPlayerTextDraw)
+	{
+		PacketHelper::broadcastToSome(makeSetTextRPC(txt, isPlayerTextDraw), players);
 	}
 
 	// Remove ending spaces. Set text length to client limit.
-	void trimText()
+	static String trimmed(StringView txt)
 	{
-		String newText(text.data(), text.length());
+		String newText(txt.data(), txt.length());
 
 		if (newText.length() >= MAX_TEXTDRAW_STR_LENGTH)
 		{
@@ -329,7 +395,12 @@ protected:
 			newText.pop_back();
 		}
 
-		text = newText;
+		return newText;
+	}
+
+	void trimText()
+	{
+		text = trimmed(text);
 	}
 };
 
@@ -337,24 +408,81 @@ class TextDraw final : public TextDrawBase<ITextDraw>
 {
 private:
 	UniqueIDArray<IPlayer, PLAYER_POOL_SIZE> shownFor_;
+	PendingUpdates<TextDraw>& pending_;
+	const bool& autoUpdate_;
+
+	/// Players to show the textdraw to again when the pending update is flushed
+	StaticBitset<PLAYER_POOL_SIZE> pendingShow_;
+
+	/// Players given their own text with setTextForPlayer
+	StaticBitset<PLAYER_POOL_SIZE> customText_;
+
+	/// Players with a pending show which are in shownFor_, to send the show to
+	FlatPtrHashSet<IPlayer> flushing_;
 
-	using TextDrawBase<ITextDraw>::TextDrawBase;
+	void propertyChanged() override
+	{
+		if (autoUpdate_)
+		{
+			restream();
+		}
+	}
 
 public:
+	TextDraw(PendingUpdates<TextDraw>& pending, const bool& autoUpdate, Vector2 pos, StringView text, TextDrawStyle style = TextDrawStyle_FontAharoniBold, int previewModel = 0)
+		: TextDrawBase(pos, text, style, previewModel)
+		, pending_(pending)
+		, autoUpdate_(autoUpdate)
+	{
+	}
+
 	void removeFor(int pid, IPlayer& player)
 	{
 		if (shownFor_.valid(pid))
 		{
 			shownFor_.remove(pid, player);
 		}
+		pendingShow_.reset(pid);
+		customText_.reset(pid);
 	}
 
+	/// Show the textdraw again to everyone it's shown for at the end of the tick, once however many times it's called
 	void restream() override
 	{
 		for (IPlayer* player : shownFor_.entries())
 		{
-			showForClient(*player, false);
+			pendingShow_.set(player->getID());
+		}
+		if (pendingShow_.any())
+		{
+			pending_.add(*this);
+		}
+	}
+
+	void flushUpdate()
+	{
+		if (pendingShow_.none())
+		{
+			return;
+		}
+
+		if (pendingShow_.count() == shownFor_.entries().size())
+		{
+			showForClients(shownFor_.entries(), false);
 		}
+		else
+		{
+			for (IPlayer* player : shownFor_.entries())
+			{
+				if (pendingShow_.test(player->getID()))
+				{
+					flushing_.insert(player);
+				}
+			}
+			showForClients(flushing_, false);
+			flushing_.clear();
+		}
+		pendingShow_.reset();
 	}
 
 	bool isShownForPlayer(const IPlayer& player) const override
@@ -364,40 +492,86 @@ public:
 
 	void showForPlayer(IPlayer& player) override
 	{
-		shownFor_.add(player.getID(), player);
+		const int pid = player.getID();
+		shownFor_.add(pid, player);
+		// This show is up to date so there's no need to send another one
+		pendingShow_.reset(pid);
+		customText_.reset(pid);
 		showForClient(player, false);
 	}
 
 	void hideForPlayer(IPlayer& player) override
 	{
-		shownFor_.remove(player.getID(), player);
+		const int pid = player.getID();
+		shownFor_.remove(pid, player);
+		pendingShow_.reset(pid);
+		customText_.reset(pid);
 		hideForClient(player, false);
 	}
 
+	void showForPlayers(const FlatPtrHashSet<IPlayer>& players) override
+	{
+		for (IPlayer* player : players)
+		{
+			const int pid = player->getID();
+			shownFor_.add(pid, *player);
+			pendingShow_.reset(pid);
+			customText_.reset(pid);
+		}
+		showForClients(players, false);
+	}
+
+	void hideForPlayers(const FlatPtrHashSet<IPlayer>& players) override
+	{
+		for (IPlayer* player : players)
+		{
+			const int pid = player->getID();
+			shownFor_.remove(pid, *player);
+			pendingShow_.reset(pid);
+			customText_.reset(pid);
+		}
+		hideForClients(players, false);
+	}
+
 	void setText(StringView txt) override
 	{
-		TextDrawBase<ITextDraw>::setText(txt);
-		for (IPlayer* player : shownFor_.entries())
+		// The same text is only sent again to replace text set for single players
+		if (!changeText(txt) && customText_.none())
+		{
+			return;
+		}
+		customText_.reset();
+
+		// A pending show for everyone sends the new text already
+		if (pendingShow_.count() != shownFor_.entries().size())
 		{
-			setTextForClient(*player, txt, false);
+			setTextForClients(shownFor_.entries(), getText(), false);
 		}
 	}
 
 	void setTextForPlayer(IPlayer& player, StringView txt) override
 	{
+		const int pid = player.getID();
+		// A pending show would send the global text over this one, send it first
+		if (pendingShow_.test(pid))
+		{
+			pendingShow_.reset(pid);
+			showForClient(player, false);
+		}
+		customText_.set(pid);
 		setTextForClient(player, txt, false);
 	}
 
 	~TextDraw()
 	{
+		pending_.remove(*this);
 	}
 
 	void destream()
 	{
-		for (IPlayer* player : shownFor_.entries())
-		{
-			hideForClient(*player, false);
-		}
+		pending_.remove(*this);
+		pendingShow_.reset();
+		hideForClients(shownFor_.entries(), false);
 	}
 };
 
@@ -405,12 +579,25 @@ class PlayerTextDraw final : public TextDrawBase<IPlayerTextDraw>
 {
 private:
 	IPlayer& player;
+	PendingUpdates<PlayerTextDraw>& pending_;
+	const bool& autoUpdate_;
 	bool shown = false;
+	bool pendingShow_ = false;
+
+	void propertyChanged() override
+	{
+		if (autoUpdate_)
+		{
+			restream();
+		}
+	}
 
 public:
-	PlayerTextDraw(IPlayer& player, Vector2 pos, StringView text, TextDrawStyle style = TextDrawStyle_FontAharoniBold, int previewModel = 0)
+	PlayerTextDraw(IPlayer& player, PendingUpdates<PlayerTextDraw>& pending, const bool& autoUpdate, Vector2 pos, StringView text, TextDrawStyle style = TextDrawStyle_FontAharoniBold, int previewModel = 0)
 		: TextDrawBase(pos, text, style, previewModel)
 		, player(player)
+		, pending_(pending)
+		, autoUpdate_(autoUpdate)
 	{
 	}
 
@@ -418,12 +605,14 @@ public:
 	{
 		showForClient(player, true);
 		shown = true;
+		pendingShow_ = false;
 	}
 
 	void hide() override
 	{
 		hideForClient(player, true);
 		shown = false;
+		pendingShow_ = false;
 	}
 
 	bool isShown() const override
@@ -431,29 +620,48 @@ public:
 		return shown;
 	}
 
+	/// Show the textdraw again at the end of the tick, once however many times it's called
 	void restream() override
 	{
 		if (shown)
+		{
+			pendingShow_ = true;
+			pending_.add(*this);
+		}
+	}
+
+	void flushUpdate()
+	{
+		if (shown && pendingShow_)
 		{
 			showForClient(player, true);
 		}
+		pendingShow_ = false;
 	}
 
 	void setText(StringView txt) override
 	{
-		TextDrawBase<IPlayerTextDraw>::setText(txt);
-		if (shown)
+		if (!changeText(txt))
+		{
+			return;
+		}
+
+		// A pending show sends the new text already
+		if (shown && !pendingShow_)
 		{
-			setTextForClient(player, txt, true);
+			setTextForClient(player, getText(), true);
 		}
 	}
 
 	~PlayerTextDraw()
 	{
+		pending_.remove(*this);
 	}
 
 	void destream()
 	{
+		pending_.remove(*this);
+		pendingShow_ = false;
 		if (shown)
 		{
 			hideForClient(player, true);
@@ -16,6 +16,8 @@ class PlayerTextDrawData final : public IPlayerTextDrawData
 {
 private:
 	IPlayer& player;
+	PendingUpdates<PlayerTextDraw>& pending;
+	const bool& autoUpdate;
 	MarkedPoolStorage<PlayerTextDraw, IPlayerTextDraw, 0, PLAYER_TEXTDRAW_POOL_SIZE> storage;
 	bool selecting;
 
@@ -25,8 +27,10 @@ public:
 		selecting = false;
 	}
 
-	PlayerTextDrawData(IPlayer& player)
+	PlayerTextDrawData(IPlayer& player, PendingUpdates<PlayerTextDraw>& pending, const bool& autoUpdate)
 		: player(player)
+		, pending(pending)
+		, autoUpdate(autoUpdate)
 		, selecting(false)
 	{
 	}
@@ -56,12 +60,12 @@ public:
 
 	IPlayerTextDraw* create(Vector2 position, StringView text) override
 	{
-		return storage.emplace(player, position, text);
+		return storage.emplace(player, pending, autoUpdate, position, text);
 	}
 
 	IPlayerTextDraw* create(Vector2 position, int model) override
 	{
-		return storage.emplace(player, position, "_", TextDrawStyle_Preview, model);
+		return storage.emplace(player, pending, autoUpdate, position, "_", TextDrawStyle_Preview, model);
 	}
 
 	void freeExtension() override
@@ -117,10 +121,15 @@ public:
 	}
 };
 
-class TextDrawsComponent final : public ITextDrawsComponent, public PlayerConnectEventHandler, public PoolEventHandler<IPlayer>
+class TextDrawsComponent final : public ITextDrawsComponent, public CoreEventHandler, public PlayerConnectEventHandler, public PoolEventHandler<IPlayer>
 {
 private:
 	ICore* core = nullptr;
+	/// Declared before the storages so they outlive the textdraws waiting in them
+	PendingUpdates<TextDraw> pendingTextDraws;
+	PendingUpdates<PlayerTextDraw> pendingPlayerTextDraws;
+	/// Whether changing a shown textdraw's properties shows it again, otherwise it needs to be shown again like in SA:MP
+	bool autoUpdate = false;
 	MarkedPoolStorage<TextDraw, ITextDraw, 0, GLOBAL_TEXTDRAW_POOL_SIZE> storage;
 	DefaultEventDispatcher<TextDrawEventHandler> dispatcher;
 
@@ -196,9 +205,21 @@ public:
 	void onLoad(ICore* c) override
 	{
 		core = c;
+		// Flushed after the scripts' ticks so the changes they make in a tick are sent together
+		core->getEventDispatcher().addEventHandler(this, EventPriority_Lowest);
 		core->getPlayers().getPlayerConnectDispatcher().addEventHandler(this);
+		core->getPlayers().registerExtensionSlot(IPlayerTextDrawData::ExtensionIID);
 		core->getPlayers().getPoolEventDispatcher().addEventHandler(this);
 		NetCode::RPC::OnPlayerSelectTextDraw::addEventHandler(*core, &playerSelectTextDrawEventHandler);
+
+		bool* autoUpdateConfig = core->getConfig().getBool("game.use_textdraw_auto_update");
+		autoUpdate = autoUpdateConfig && *autoUpdateConfig;
+	}
+
+	void onTick(Microseconds elapsed, TimePoint now) override
+	{
+		pendingTextDraws.flush();
+		pendingPlayerTextDraws.flush();
 	}
 
 	void reset() override
@@ -211,6 +232,7 @@ public:
 	{
 		if (core)
 		{
+			core->getEventDispatcher().removeEventHandler(this);
 			core->getPlayers().getPlayerConnectDispatcher().removeEventHandler(this);
 			core->getPlayers().getPoolEventDispatcher().removeEventHandler(this);
 			NetCode::RPC::OnPlayerSelectTextDraw::removeEventHandler(*core, &playerSelectTextDrawEventHandler);
@@ -219,7 +241,7 @@ public:
 
 	void onPlayerConnect(IPlayer& player) override
 	{
-		player.addExtension(new PlayerTextDrawData(player), true);
+		player.addExtension(new PlayerTextDrawData(player, pendingPlayerTextDraws, autoUpdate), true);
 	}
 
 	void onPoolEntryDestroyed(IPlayer& player) override
@@ -240,12 +262,12 @@ public:
 
 	ITextDraw* create(Vector2 position, StringView text) override
 	{
-		return storage.emplace(position, text);
+		return storage.emplace(pendingTextDraws, autoUpdate, position, text);
 	}
 
 	ITextDraw* create(Vector2 position, int model) override
 	{
-		return storage.emplace(position, "_", TextDrawStyle_Preview, model);
+		return storage.emplace(pendingTextDraws, autoUpdate, position, "_", TextDrawStyle_Preview, model);
 	}
 
 	void free() override
@@ -0,0 +1,387 @@
+/*
+ *  This Source Code Form is subject to the terms of the Mozilla Public License,
+ *  v. 2.0. If a copy of the MPL was not distributed with this file, You can
+ *  obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ *  The original code is copyright (c) 2022, open.mp team and contributors.
+ */
+
+#include <Server/Components/TextDraws/textdraws.hpp>
+#include <netcode.hpp>
+#include <random>
+#include <sdk.hpp>
+
+using namespace Impl;
+
+/// Global textdraws changed by the test
+constexpr int testTextDrawCount(4);
+
+/// Ticks the textdraws are changed for once a player connected
+const int testTicks(3000);
+
+/// Most changes made to the textdraws in one tick
+const int testChangesPerTick(12);
+
+/// Bytes of a show RPC between the textdraw ID and its text, see PlayerShowTextDraw::write
+const int testShowRPCFieldsSize(63);
+
+/// Whether a textdraw is shown and the text it has, for one player
+struct TextDrawState
+{
+	bool shown = false;
+	String text;
+};
+
+/// Checks what players are sent for global textdraws shown, hidden and changed for some or all of them at once:
+/// after every tick, the show, hide and set-string RPCs each player got must add up to what the server has for them
+/// The checks need players, the textdraws are changed for whoever is connected
+struct TextDrawsTestComponent final : public IComponent, public CoreEventHandler, public PlayerConnectEventHandler, public NoCopy
+{
+	/// Handles one of the textdraw RPCs sent to players
+	struct RPCHandler final : public SingleNetworkOutEventHandler
+	{
+		TextDrawsTestComponent& self;
+		const int id;
+
+		RPCHandler(TextDrawsTestComponent& self, int id)
+			: self(self)
+			, id(id)
+		{
+		}
+
+		bool onSend(IPlayer* peer, NetworkBitStream& bs) override
+		{
+			if (peer)
+			{
+				self.receive(*peer, id, bs);
+			}
+			return true;
+		}
+	};
+
+	/// Core
+	ICore* core = nullptr;
+
+	/// TextDraws component
+	ITextDrawsComponent* textdraws = nullptr;
+
+	/// The test textdraws
+	StaticArray<ITextDraw*, testTextDrawCount> testTextDraws {};
+
+	/// Per player, what their client has for each test textdraw according to the RPCs they were sent
+	FlatHashMap<int, StaticArray<TextDrawState, testTextDrawCount>> clients;
+
+	/// Per player, what they should have for each test textdraw
+	FlatHashMap<int, StaticArray<TextDrawState, testTextDrawCount>> expected;
+
+	RPCHandler showHandler { *this, NetCode::RPC::PlayerShowTextDraw::PacketID };
+	RPCHandler hideHandler { *this, NetCode::RPC::PlayerHideTextDraw::PacketID };
+	RPCHandler setStringHandler { *this, NetCode::RPC::PlayerTextDrawSetString::PacketID };
+
+	/// Random changes, seeded so every run makes the same ones
+	std::mt19937 random { 1 };
+
+	/// Ticks the textdraws were changed for
+	int ticks = 0;
+
+	/// Player and textdraw states compared
+	int checks = 0;
+
+	/// Failed checks
+	int errors = 0;
+
+	/// Gets the component UID
+	/// @returns Component UID
+	UID getUID() override
+	{
+		return 0xc4a71e5f20b9d836;
+	}
+
+	/// Gets the component name
+	/// @returns Component name
+	StringView componentName() const override
+	{
+		return "TextDraws test";
+	}
+
+	/// Gets the component type
+	/// @returns Component type
+	ComponentType componentType() const override
+	{
+		return ComponentType::Other;
+	}
+
+	/// Gets the component version
+	/// @return Component version
+	SemanticVersion componentVersion() const override
+	{
+		return SemanticVersion(OMP_VERSION_MAJOR, OMP_VERSION_MINOR, OMP_VERSION_PATCH, BUILD_NUMBER);
+	}
+
+	/// Called for every component after components have been loaded
+	/// @param c Core
+	void onLoad(ICore* c) override
+	{
+		core = c;
+	}
+
+	/// Called when all components have been initialised
+	/// @param components Component list to query
+	void onInit(IComponentList* components) override
+	{
+		textdraws = components->queryComponent<ITextDrawsComponent>();
+	}
+
+	/// Creates the textdraws and starts watching what players are sent
+	void onReady() override
+	{
+		if (!textdraws)
+		{
+			core->printLn("[ERROR] TextDraws test: the textdraws component isn't loaded.");
+			return;
+		}
+
+		for (int i = 0; i < testTextDrawCount; ++i)
+		{
+			testTextDraws[i] = textdraws->create(Vector2(20.0f + 120.0f * i, 420.0f), "start");
+			if (!testTextDraws[i])
+			{
+				core->printLn("[ERROR] TextDraws test: couldn't create a textdraw.");
+				return;
+			}
+		}
+
+		core->getEventDispatcher().addEventHandler(this);
+		core->getPlayers().getPlayerConnectDispatcher().addEventHandler(this);
+		for (INetwork* network : core->getNetworks())
+		{
+			network->getPerRPCOutEventDispatcher().addEventHandler(&showHandler, showHandler.id);
+			network->getPerRPCOutEventDispatcher().addEventHandler(&hideHandler, hideHandler.id);
+			network->getPerRPCOutEventDispatcher().addEventHandler(&setStringHandler, setStringHandler.id);
+		}
+		core->printLn("TextDraws test: connect to check what players are sent for textdraws shown to some or all of them");
+	}
+
+	/// Counts a failed check
+	/// @param condition Checked condition
+	/// @param description What was checked
+	void check(bool condition, const char* description)
+	{
+		if (!condition)
+		{
+			core->printLn("[ERROR] TextDraws test: %s", description);
+			++errors;
+		}
+	}
+
+	/// Gets which test textdraw an RPC is for
+	/// @returns The textdraw's index, or -1 if it isn't a test textdraw
+	int findTextDraw(int id) const
+	{
+		for (int i = 0; i < testTextDrawCount; ++i)
+		{
+			if (testTextDraws[i] && testTextDraws[i]->getID() == id)
+			{
+				return i;
+			}
+		}
+		return -1;
+	}
+
+	/// Applies an RPC sent to a player to what their client has
+	void receive(IPlayer& player, int rpc, NetworkBitStream& bs)
+	{
+		uint16_t id;
+		if (!bs.readUINT16(id))
+		{
+			return;
+		}
+		const int index = findTextDraw(id);
+		if (index == -1)
+		{
+			return;
+		}
+
+		TextDrawState& client = clients[player.getID()][index];
+		HybridString<256> text;
+		if (rpc == NetCode::RPC::PlayerShowTextDraw::PacketID)
+		{
+			bs.IgnoreBits(testShowRPCFieldsSize * 8);
+			if (bs.readDynStr16(text))
+			{
+				client.shown = true;
+				client.text = String(text);
+			}
+		}
+		else if (rpc == NetCode::RPC::PlayerHideTextDraw::PacketID)
+		{
+			client.shown = false;
+		}
+		else if (bs.readDynStr16(text))
+		{
+			client.text = String(text);
+		}
+	}
+
+	/// Compares what each player's client has with what they should have
+	void compare(const DynamicArray<IPlayer*>& players)
+	{
+		for (IPlayer* player : players)
+		{
+			const int pid = player->getID();
+			for (int i = 0; i < testTextDrawCount; ++i)
+			{
+				const TextDrawState& should = expected[pid][i];
+				const TextDrawState& client = clients[pid][i];
+				check(testTextDraws[i]->isShownForPlayer(*player) == should.shown, "A textdraw is shown for a player it shouldn't be, or the other way around.");
+				check(client.shown == should.shown, "A player's client shows a textdraw it shouldn't, or the other way around.");
+				check(!should.shown || client.text == should.text, "A player's client has another text than the textdraw has for them.");
+				++checks;
+			}
+		}
+	}
+
+	/// Makes a random change to a textdraw and records what each player should have afterwards
+	void change(const DynamicArray<IPlayer*>& players)
+	{
+		const int index = random() % testTextDrawCount;
+		ITextDraw& textdraw = *testTextDraws[index];
+		IPlayer& player = *players[random() % players.size()];
+		const int kind = random() % 100;
+		if (kind < 15)
+		{
+			textdraw.showForPlayer(player);
+			expected[player.getID()][index] = { true, String(textdraw.getText()) };
+		}
+		else if (kind < 22)
+		{
+			textdraw.hideForPlayer(player);
+			expected[player.getID()][index].shown = false;
+		}
+		else if (kind < 30)
+		{
+			FlatPtrHashSet<IPlayer> some;
+			for (IPlayer* other : players)
+			{
+				if (random() % 2)
+				{
+					some.insert(other);
+				}
+			}
+			const bool show = random() % 3;
+			show ? textdraw.showForPlayers(some) : textdraw.hideForPlayers(some);
+			for (IPlayer* other : some)
+			{
+				expected[other->getID()][index] = { show, String(textdraw.getText()) };
+			}
+		}
+		else if (kind < 60)
+		{
+			// Often the same text again, like a clock that didn't change
+			textdraw.setText("clock " + std::to_string(random() % 3));
+			for (IPlayer* other : players)
+			{
+				expected[other->getID()][index].text = String(textdraw.getText());
+			}
+		}
+		else if (kind < 75)
+		{
+			if (textdraw.isShownForPlayer(player))
+			{
+				const String text = "mine " + std::to_string(random() % 3);
+				textdraw.setTextForPlayer(player, text);
+				expected[player.getID()][index].text = text;
+			}
+		}
+		else
+		{
+			// Shown again with the global text at the end of the tick
+			textdraw.setColour(Colour(random() % 256, random() % 256, random() % 256, 255));
+			textdraw.restream();
+			for (IPlayer* other : players)
+			{
+				expected[other->getID()][index].text = String(textdraw.getText());
+			}
+		}
+	}
+
+	/// Checks what the players were sent for the last tick's changes, then changes the textdraws again
+	void onTick(Microseconds elapsed, TimePoint now) override
+	{
+		if (ticks == testTicks)
+		{
+			return;
+		}
+
+		const FlatPtrHashSet<IPlayer>& entries = core->getPlayers().entries();
+		if (entries.empty())
+		{
+			return;
+		}
+		const DynamicArray<IPlayer*> players(entries.begin(), entries.end());
+
+		// The textdraws component sends the restreams on its tick, which is done by now whether it runs before or after this one
+		compare(players);
+		if (++ticks == testTicks)
+		{
+			if (errors)
+			{
+				core->printLn("[ERROR] TextDraws test: %d of %d checks failed.", errors, checks);
+			}
+			else
+			{
+				core->printLn("TextDraws test passed, %d checks over %d ticks", checks, testTicks);
+			}
+			return;
+		}
+
+		const int changes = random() % testChangesPerTick;
+		for (int i = 0; i < changes; ++i)
+		{
+			change(players);
+		}
+	}
+
+	/// Forgets what a player who left had, they start over if they connect again
+	void onPlayerDisconnect(IPlayer& player, PeerDisconnectReason reason) override
+	{
+		clients.erase(player.getID());
+		expected.erase(player.getID());
+	}
+
+	/// Called when another component is about to be freed
+	/// @param component The component being freed
+	void onFree(IComponent* component) override
+	{
+		if (component == textdraws)
+		{
+			textdraws = nullptr;
+			testTextDraws.fill(nullptr);
+			ticks = testTicks;
+		}
+	}
+
+	/// Frees this component, it isn't allocated
+	void free() override
+	{
+		for (INetwork* network : core->getNetworks())
+		{
+			network->getPerRPCOutEventDispatcher().removeEventHandler(&showHandler, showHandler.id);
+			network->getPerRPCOutEventDispatcher().removeEventHandler(&hideHandler, hideHandler.id);
+			network->getPerRPCOutEventDispatcher().removeEventHandler(&setStringHandler, setStringHandler.id);
+		}
+		core->getPlayers().getPlayerConnectDispatcher().removeEventHandler(this);
+		core->getEventDispatcher().removeEventHandler(this);
+	}
+
+	void reset() override
+	{
+		clients.clear();
+		expected.clear();
+	}
+} textDrawsTestComponent;
+
+COMPONENT_ENTRY_POINT()
+{
+	return &textDrawsTestComponent;
+}
@@ -6,7 +6,9 @@
  *  The original code is copyright (c) 2022, open.mp team and contributors.
  */
 
+#include <Impl/pending_updates_impl.hpp>
 #include <Impl/pool_impl.hpp>
+#include <Impl/spatial_index_impl.hpp>
 #include <Server/Components/TextLabels/textlabels.hpp>
 #include <Server/Components/Vehicles/vehicles.hpp>
 #include <netcode.hpp>
@@ -63,6 +65,10 @@ public:
 
 	void setText(StringView txt) override
 	{
+		if (txt == StringView(text))
+		{
+			return;
+		}
 		text = txt;
 		restream();
 	}
@@ -138,7 +144,8 @@ public:
 		restream();
 	}
 
-	void streamInForClient(IPlayer& player, bool isPlayerTextLabel)
+	/// Build the RPC showing the label, it points into the label's text so it must be sent before the text changes
+	NetCode::RPC::PlayerShowTextLabel makeShowRPC(bool isPlayerTextLabel) const
 	{
 		NetCode::RPC::PlayerShowTextLabel showTextLabelRPC;
 		showTextLabelRPC.PlayerTextLabel = isPlayerTextLabel;
@@ -150,19 +157,33 @@ public:
 		showTextLabelRPC.PlayerAttachID = attachmentData.playerID;
 		showTextLabelRPC.VehicleAttachID = attachmentData.vehicleID;
 		showTextLabelRPC.Text = StringView(text);
-		PacketHelper::send(showTextLabelRPC, player);
+		return showTextLabelRPC;
 	}
 
-	void streamOutForClient(IPlayer& player, bool isPlayerTextLabel)
+	NetCode::RPC::PlayerHideTextLabel makeHideRPC(bool isPlayerTextLabel) const
 	{
 		NetCode::RPC::PlayerHideTextLabel hideTextLabelRPC;
 		hideTextLabelRPC.PlayerTextLabel = isPlayerTextLabel;
 		hideTextLabelRPC.TextLabelID = poolID;
-		PacketHelper::send(hideTextLabelRPC, player);
+		return hideTextLabelRPC;
+	}
+
+	void streamInForClient(IPlayer& player, bool isPlayerTextLabel)
+	{
+		PacketHelper::send(makeShowRPC(isPlayerTextLabel), player);
+	}
+
+	void streamOutForClient(IPlayer& player, bool isPlayerTextLabel)
+	{
+		PacketHelper::send(makeHideRPC(isPlayerTextLabel), player);
 	}
 
 	void setColourAndText(Colour col, StringView txt) override
 	{
+		if (col.RGBA() == colour.RGBA() && txt == StringView(text))
+		{
+			return;
+		}
 		colour = col;
 		text = txt;
 		restream();
@@ -174,6 +195,8 @@ class TextLabel final : public TextLabelBase<ITextLabel>
 private:
 	int virtualWorld;
 	UniqueIDArray<IPlayer, PLAYER_POOL_SIZE> streamedFor_;
+	PoolStreamIndex<ITextLabel>& streamIndex_;
+	PendingUpdates<TextLabel>& pending_;
 
 public:
 	void removeFor(int pid, IPlayer& player)
@@ -184,21 +207,34 @@ public:
 		}
 	}
 
-	TextLabel(StringView text, Colour colour, Vector3 pos, float drawDist, int vw, bool los)
+	TextLabel(PoolStreamIndex<ITextLabel>& streamIndex, PendingUpdates<TextLabel>& pending, StringView text, Colour colour, Vector3 pos, float drawDist, int vw, bool los)
 		: TextLabelBase(text, colour, pos, drawDist, los)
 		, virtualWorld(vw)
+		, streamIndex_(streamIndex)
+		, pending_(pending)
 	{
 	}
 
+	/// Re-index the label straight away and show it again to the players it's streamed for at the end of the tick
 	void restream() override
 	{
-		for (IPlayer* player : streamedFor_.entries())
+		// Attached labels follow their parent so their position is only an offset
+		const TextLabelAttachmentData& data = getAttachmentData();
+		streamIndex_.update(*this, data.playerID == INVALID_PLAYER_ID && data.vehicleID == INVALID_VEHICLE_ID);
+
+		if (!streamedFor_.entries().empty())
 		{
-			streamOutForClient(*player, false);
-			streamInForClient(*player, false);
+			pending_.add(*this);
 		}
 	}
 
+	void flushUpdate()
+	{
+		// Shown again rather than updated as the client can't change a label it has
+		PacketHelper::broadcastToSome(makeHideRPC(false), streamedFor_.entries());
+		PacketHelper::broadcastToSome(makeShowRPC(false), streamedFor_.entries());
+	}
+
 	bool isStreamedInForPlayer(const IPlayer& player) const override
 	{
 		return streamedFor_.valid(player.getID());
@@ -207,6 +243,7 @@ public:
 	void streamInForPlayer(IPlayer& player) override
 	{
 		streamedFor_.add(player.getID(), player);
+		streamIndex_.streamedIn(player, poolID);
 		streamInForClient(player, false);
 	}
 
@@ -229,14 +266,13 @@ public:
 
 	~TextLabel()
 	{
+		pending_.remove(*this);
 	}
 
 	void destream()
 	{
-		for (IPlayer* player : streamedFor_.entries())
-		{
-			streamOutForClient(*player, false);
-		}
+		pending_.remove(*this);
+		PacketHelper::broadcastToSome(makeHideRPC(false), streamedFor_.entries());
 	}
 };
 
@@ -244,15 +280,23 @@ class PlayerTextLabel final : public TextLabelBase<IPlayerTextLabel>
 {
 private:
 	IPlayer& player;
+	PendingUpdates<PlayerTextLabel>& pending_;
 
 public:
-	PlayerTextLabel(IPlayer& player, StringView text, Colour colour, Vector3 pos, float drawDist, bool testLOS)
+	PlayerTextLabel(IPlayer& player, PendingUpdates<PlayerTextLabel>& pending, StringView text, Colour colour, Vector3 pos, float drawDist, bool testLOS)
 		: TextLabelBase(text, colour, pos, drawDist, testLOS)
 		, player(player)
+		, pending_(pending)
 	{
 	}
 
+	/// Show the label again at the end of the tick, once however many times it's called
 	void restream() override
+	{
+		pending_.add(*this);
+	}
+
+	void flushUpdate()
 	{
 		streamOutForClient(player, true);
 		streamInForClient(player, true);
@@ -269,10 +313,12 @@ public:
 
 	~PlayerTextLabel()
 	{
+		pending_.remove(*this);
 	}
 
 	void destream()
 	{
+		pending_.remove(*this);
 		streamOutForClient(player, true);
 	}
 };
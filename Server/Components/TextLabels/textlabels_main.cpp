@@ -17,17 +17,19 @@ class PlayerTextLabelData final : public IPlayerTextLabelData
 {
 private:
 	IPlayer& player;
+	PendingUpdates<PlayerTextLabel>& pending;
 	MarkedPoolStorage<PlayerTextLabel, IPlayerTextLabel, 0, TEXT_LABEL_POOL_SIZE> storage;
 
 public:
-	PlayerTextLabelData(IPlayer& player)
+	PlayerTextLabelData(IPlayer& player, PendingUpdates<PlayerTextLabel>& pending)
 		: player(player)
+		, pending(pending)
 	{
 	}
 
 	PlayerTextLabel* createInternal(StringView text, Colour colour, Vector3 pos, float drawDist, bool los)
 	{
-		return storage.emplace(player, text, colour, pos, drawDist, los);
+		return storage.emplace(player, pending, text, colour, pos, drawDist, los);
 	}
 
 	IPlayerTextLabel* create(StringView text, Colour colour, Vector3 pos, float drawDist, bool los) override
@@ -112,10 +114,14 @@ public:
 	}
 };
 
-class TextLabelsComponent final : public ITextLabelsComponent, public PlayerConnectEventHandler, public PlayerUpdateEventHandler, public PoolEventHandler<IPlayer>
+class TextLabelsComponent final : public ITextLabelsComponent, public CoreEventHandler, public PlayerConnectEventHandler, public PlayerUpdateEventHandler, public PoolEventHandler<IPlayer>
 {
 private:
 	ICore* core = nullptr;
+	/// Declared before the storage so they outlive the entries they hold
+	PoolStreamIndex<ITextLabel> streamIndex;
+	PendingUpdates<TextLabel> pendingLabels;
+	PendingUpdates<PlayerTextLabel> pendingPlayerLabels;
 	MarkedPoolStorage<TextLabel, ITextLabel, 0, TEXT_LABEL_POOL_SIZE> storage;
 	IVehiclesComponent* vehicles = nullptr;
 	IPlayerPool* players = nullptr;
@@ -132,12 +138,20 @@ public:
 		return SemanticVersion(OMP_VERSION_MAJOR, OMP_VERSION_MINOR, OMP_VERSION_PATCH, BUILD_NUMBER);
 	}
 
+	TextLabelsComponent()
+	{
+		storage.getEventDispatcher().addEventHandler(&streamIndex);
+	}
+
 	void onLoad(ICore* core) override
 	{
 		this->core = core;
 		players = &core->getPlayers();
+		// Flushed after the scripts' ticks so the changes they make in a tick are sent together
+		core->getEventDispatcher().addEventHandler(this, EventPriority_Lowest);
 		players->getPlayerUpdateDispatcher().addEventHandler(this);
 		players->getPlayerConnectDispatcher().addEventHandler(this);
+		players->registerExtensionSlot(IPlayerTextLabelData::ExtensionIID);
 		players->getPoolEventDispatcher().addEventHandler(this);
 		streamConfigHelper = StreamConfigHelper(core->getConfig());
 	}
@@ -151,6 +165,7 @@ public:
 	{
 		if (core)
 		{
+			core->getEventDispatcher().removeEventHandler(this);
 			players->getPlayerUpdateDispatcher().removeEventHandler(this);
 			players->getPlayerConnectDispatcher().removeEventHandler(this);
 			players->getPoolEventDispatcher().removeEventHandler(this);
@@ -159,12 +174,18 @@ public:
 
 	void onPlayerConnect(IPlayer& player) override
 	{
-		player.addExtension(new PlayerTextLabelData(player), true);
+		player.addExtension(new PlayerTextLabelData(player, pendingPlayerLabels), true);
+	}
+
+	void onTick(Microseconds elapsed, TimePoint now) override
+	{
+		pendingLabels.flush();
+		pendingPlayerLabels.flush();
 	}
 
 	ITextLabel* create(StringView text, Colour colour, Vector3 pos, float drawDist, int vw, bool los) override
 	{
-		ITextLabel* created = storage.emplace(text, colour, pos, drawDist, vw, los);
+		ITextLabel* created = storage.emplace(streamIndex, pendingLabels, text, colour, pos, drawDist, vw, los);
 
 		if (created)
 		{
@@ -249,15 +270,40 @@ public:
 		const float maxDist = streamConfigHelper.getDistanceSqr();
 		if (streamConfigHelper.shouldStream(player.getID(), now))
 		{
-			for (ITextLabel* textLabel : storage)
-			{
-				updateLabelStateForPlayer(static_cast<TextLabel*>(textLabel), player, maxDist);
-			}
+			streamIndex.forEachCandidate(
+				storage, player, player.getPosition(), player.getVirtualWorld(), streamConfigHelper.getDistance(), [&](ITextLabel& textLabel)
+				{
+					updateLabelStateForPlayer(static_cast<TextLabel*>(&textLabel), player, maxDist);
+				},
+				[this](ITextLabel& textLabel)
+				{
+					return getAttachedPosition(textLabel);
+				});
 		}
 
 		return true;
 	}
 
+	/// Get the position of the player or vehicle a label is attached to, or the label's own if its parent doesn't exist
+	Vector3 getAttachedPosition(ITextLabel& label) const
+	{
+		const TextLabelAttachmentData& data = label.getAttachmentData();
+		IPlayer* textLabelPlayer = players->get(data.playerID);
+		if (textLabelPlayer)
+		{
+			return textLabelPlayer->getPosition();
+		}
+		else if (vehicles)
+		{
+			IVehicle* textLabelVehicle = vehicles->get(data.vehicleID);
+			if (textLabelVehicle)
+			{
+				return textLabelVehicle->getPosition();
+			}
+		}
+		return label.getPosition();
+	}
+
 	void updateLabelStateForPlayer(TextLabel* label, IPlayer& player, float maxDist)
 	{
 		const TextLabelAttachmentData& data = label->getAttachmentData();
@@ -308,6 +354,7 @@ public:
 			}
 			label->removeFor(pid, player);
 		}
+		streamIndex.removePlayer(player);
 		for (IPlayer* player : players->entries())
 		{
 			IPlayerTextLabelData* data = queryExtension<IPlayerTextLabelData>(player);
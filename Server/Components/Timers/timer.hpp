@@ -8,6 +8,8 @@
 
 #include <Server/Components/Timers/timers.hpp>
 
+class TimersComponent;
+
 class Timer final : public ITimer
 {
 private:
@@ -16,8 +18,17 @@ private:
 	const Milliseconds interval_;
 	TimePoint timeout_;
 	TimerTimeOutHandler* const handler_;
+	TimersComponent& component_;
+	size_t queueIndex_;
+	uint64_t order_;
+
+	/// Mark the timer as no longer running and let the component know
+	void stop();
 
 public:
+	/// The queue index of timers which aren't waiting in the component's queue
+	constexpr static const size_t NotQueued = size_t(-1);
+
 	inline TimePoint getTimeout() const
 	{
 		return timeout_;
@@ -28,12 +39,36 @@ public:
 		timeout_ = timeout;
 	}
 
-	Timer(TimerTimeOutHandler* handler, Milliseconds initial, Milliseconds interval, unsigned int count)
+	inline size_t getQueueIndex() const
+	{
+		return queueIndex_;
+	}
+
+	inline void setQueueIndex(size_t index)
+	{
+		queueIndex_ = index;
+	}
+
+	/// Get the order the timer was queued in, used to fire timers with the same time out in a stable order
+	inline uint64_t getOrder() const
+	{
+		return order_;
+	}
+
+	inline void setOrder(uint64_t order)
+	{
+		order_ = order;
+	}
+
+	Timer(TimersComponent& component, TimerTimeOutHandler* handler, Milliseconds initial, Milliseconds interval, unsigned int count)
 		: running_(true)
 		, count_(count)
 		, interval_(interval)
 		, timeout_(Time::now() + initial)
 		, handler_(handler)
+		, component_(component)
+		, queueIndex_(NotQueued)
+		, order_(0)
 	{
 	}
 
@@ -64,7 +99,7 @@ public:
 
 	void kill() override
 	{
-		running_ = false;
+		stop();
 	}
 
 	bool trigger() override
@@ -81,7 +116,7 @@ public:
 		--count_;
 		if (count_ == 0)
 		{
-			running_ = false;
+			stop();
 		}
 		return running_;
 	}
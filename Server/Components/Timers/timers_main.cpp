@@ -8,13 +8,131 @@
 
 #include "timer.hpp"
 #include <sdk.hpp>
-#include <list>
+#include <new>
+
+using namespace Impl;
 
 class TimersComponent final : public ITimersComponent, public CoreEventHandler
 {
 private:
 	ICore* core = nullptr;
-	std::list<Timer*> timers;
+	/// Running timers in a binary min-heap ordered by time out
+	DynamicArray<Timer*> queue;
+	/// Timers taken off the queue to be fired this tick
+	DynamicArray<Timer*> due;
+	/// Timers killed while queued, destroyed on the next tick
+	DynamicArray<Timer*> stopped;
+	/// Memory of destroyed timers to construct new ones in
+	DynamicArray<void*> freeTimers;
+	size_t running = 0;
+	uint64_t queueOrder = 0;
+
+	static bool before(const Timer* a, const Timer* b)
+	{
+		if (a->getTimeout() != b->getTimeout())
+		{
+			return a->getTimeout() < b->getTimeout();
+		}
+		return a->getOrder() < b->getOrder();
+	}
+
+	void place(Timer* timer, size_t index)
+	{
+		queue[index] = timer;
+		timer->setQueueIndex(index);
+	}
+
+	void siftUp(size_t index)
+	{
+		Timer* timer = queue[index];
+		while (index > 0)
+		{
+			const size_t parent = (index - 1) / 2;
+			if (!before(timer, queue[parent]))
+			{
+				break;
+			}
+			place(queue[parent], index);
+			index = parent;
+		}
+		place(timer, index);
+	}
+
+	void siftDown(size_t index)
+	{
+		Timer* timer = queue[index];
+		const size_t size = queue.size();
+		for (;;)
+		{
+			size_t child = index * 2 + 1;
+			if (child >= size)
+			{
+				break;
+			}
+			if (child + 1 < size && before(queue[child + 1], queue[child]))
+			{
+				++child;
+			}
+			if (!before(queue[child], timer))
+			{
+				break;
+			}
+			place(queue[child], index);
+			index = child;
+		}
+		place(timer, index);
+	}
+
+	void enqueue(Timer* timer)
+	{
+		timer->setOrder(queueOrder++);
+		queue.push_back(timer);
+		siftUp(queue.size() - 1);
+	}
+
+	void dequeue(Timer* timer)
+	{
+		const size_t index = timer->getQueueIndex();
+		Timer* last = queue.back();
+		queue.pop_back();
+		timer->setQueueIndex(Timer::NotQueued);
+		if (last != timer)
+		{
+			place(last, index);
+			if (index > 0 && before(last, queue[(index - 1) / 2]))
+			{
+				siftUp(index);
+			}
+			else
+			{
+				siftDown(index);
+			}
+		}
+	}
+
+	Timer* createTimer(TimerTimeOutHandler* handler, Milliseconds initial, Milliseconds interval, unsigned int count)
+	{
+		void* memory;
+		if (freeTimers.empty())
+		{
+			memory = ::operator new(sizeof(Timer));
+		}
+		else
+		{
+			memory = freeTimers.back();
+			freeTimers.pop_back();
+		}
+		Timer* timer = new (memory) Timer(*this, handler, initial, interval, count);
+		++running;
+		enqueue(timer);
+		return timer;
+	}
+
+	void destroyTimer(Timer* timer)
+	{
+		timer->~Timer();
+		freeTimers.push_back(timer);
+	}
 
 public:
 	StringView componentName() const override
@@ -40,64 +158,86 @@ public:
 			core->getEventDispatcher().removeEventHandler(this);
 		}
 
-		for (auto timer : timers)
+		// Handlers may kill other timers while being freed so take everything off the queue first
+		DynamicArray<Timer*> remaining;
+		remaining.swap(queue);
+		for (Timer* timer : remaining)
+		{
+			timer->setQueueIndex(Timer::NotQueued);
+		}
+		for (Timer* timer : remaining)
 		{
-			delete timer;
+			destroyTimer(timer);
+		}
+		for (Timer* timer : stopped)
+		{
+			destroyTimer(timer);
+		}
+		stopped.clear();
+		for (void* memory : freeTimers)
+		{
+			::operator delete(memory);
+		}
+		freeTimers.clear();
+	}
+
+	/// Called by a timer when it stops running, either killed or out of calls
+	void onTimerStopped(Timer& timer)
+	{
+		--running;
+		// Timers being fired are destroyed by onTick once their handler returns
+		if (timer.getQueueIndex() != Timer::NotQueued)
+		{
+			dequeue(&timer);
+			stopped.push_back(&timer);
 		}
-		timers.clear();
 	}
 
 	ITimer* create(TimerTimeOutHandler* handler, Milliseconds interval, bool repeating) override
 	{
-		Timer* timer = new Timer(handler, interval, interval, repeating ? 0 : 1);
-		timers.push_back(timer);
-		return timer;
+		return createTimer(handler, interval, interval, repeating ? 0 : 1);
 	}
 
 	ITimer* create(TimerTimeOutHandler* handler, Milliseconds initial, Milliseconds interval, unsigned int count) override
 	{
-		Timer* timer = new Timer(handler, initial, interval, count);
-		timers.push_back(timer);
-		return timer;
+		return createTimer(handler, initial, interval, count);
 	}
 
 	void onTick(Microseconds elapsed, TimePoint now) override
 	{
-		for (auto it = timers.begin(); it != timers.end();)
+		for (Timer* timer : stopped)
 		{
-			Timer* timer = *it;
-			bool deleteTimer = false;
-			if (!timer->running())
-			{
-				deleteTimer = true;
-			}
-			else
+			destroyTimer(timer);
+		}
+		stopped.clear();
+
+		// Take all due timers off the queue first so timers created or rescheduled by handlers wait for the next tick
+		const TimePoint current = Time::now();
+		while (!queue.empty() && duration_cast<Milliseconds>(current - queue.front()->getTimeout()).count() >= 0)
+		{
+			Timer* timer = queue.front();
+			dequeue(timer);
+			due.push_back(timer);
+		}
+
+		for (size_t i = 0; i != due.size(); ++i)
+		{
+			Timer* timer = due[i];
+			if (timer->running())
 			{
 				const TimePoint now = Time::now();
 				const Milliseconds diff = duration_cast<Milliseconds>(now - timer->getTimeout());
-				if (diff.count() >= 0)
+				timer->handler()->timeout(*timer);
+				if (timer->trigger())
 				{
-					timer->handler()->timeout(*timer);
-					if (timer->trigger())
-					{
-						timer->setTimeout(now + timer->interval() - diff);
-					}
-					else
-					{
-						deleteTimer = true;
-					}
+					timer->setTimeout(now + timer->interval() - diff);
+					enqueue(timer);
+					continue;
 				}
 			}
-			if (deleteTimer)
-			{
-				delete timer;
-				it = timers.erase(it);
-			}
-			else
-			{
-				++it;
-			}
+			destroyTimer(timer);
 		}
+		due.clear();
 	}
 
 	void free() override
@@ -113,14 +253,19 @@ public:
 
 	const size_t count() const override
 	{
-		return std::count_if(timers.begin(), timers.end(),
-			[](Timer* timer)
-			{
-				return timer->running();
-			});
+		return running;
 	}
 };
 
+void Timer::stop()
+{
+	if (running_)
+	{
+		running_ = false;
+		component_.onTimerStopped(*this);
+	}
+}
+
 COMPONENT_ENTRY_POINT()
 {
 	return new TimersComponent();
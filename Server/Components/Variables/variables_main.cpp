@@ -196,6 +196,7 @@ public:
 	{
 		this->core = core;
 		core->getPlayers().getPlayerConnectDispatcher().addEventHandler(this);
+		core->getPlayers().registerExtensionSlot(IPlayerVariableData::ExtensionIID);
 	}
 
 	void free() override
@@ -125,6 +125,7 @@ void Vehicle::streamInForPlayer(IPlayer& player)
 	}
 
 	streamedFor_.add(pid, player);
+	pool->getStreamIndex().streamedIn(player, poolID);
 
 	ScopedPoolReleaseLock lock(*pool, *this);
 	static_cast<DefaultEventDispatcher<VehicleEventHandler>&>(pool->getEventDispatcher()).dispatch(&VehicleEventHandler::onVehicleStreamIn, *lock.entry, player);
@@ -165,6 +166,7 @@ bool Vehicle::updateFromDriverSync(const VehicleDriverSyncPacket& vehicleSync, I
 	}
 
 	pos = vehicleSync.Position;
+	updateStreamIndex();
 	rot = vehicleSync.Rotation;
 	velocity = vehicleSync.Velocity;
 	landingGear = vehicleSync.LandingGear;
@@ -292,6 +294,7 @@ bool Vehicle::updateFromUnoccupied(const VehicleUnoccupiedSyncPacket& unoccupied
 	if (allowed)
 	{
 		pos = unoccupiedSync.Position;
+		updateStreamIndex();
 		rot.q = glm::quat_cast(glm::transpose(glm::mat3(unoccupiedSync.Roll, unoccupiedSync.Rotation, glm::cross(unoccupiedSync.Roll, unoccupiedSync.Rotation))));
 		velocity = unoccupiedSync.Velocity;
 		angularVelocity = unoccupiedSync.AngularVelocity;
@@ -315,6 +318,7 @@ bool Vehicle::updateFromTrailerSync(const VehicleTrailerSyncPacket& trailerSync,
 	}
 
 	pos = trailerSync.Position;
+	updateStreamIndex();
 	velocity = trailerSync.Velocity;
 	angularVelocity = trailerSync.TurnVelocity;
 	rot.q = glm::quat(trailerSync.Quat[0], trailerSync.Quat[1], trailerSync.Quat[2], trailerSync.Quat[3]);
@@ -652,6 +656,7 @@ float Vehicle::getHealth()
 void Vehicle::setPosition(Vector3 position)
 {
 	pos = position;
+	updateStreamIndex();
 	NetCode::RPC::SetVehiclePosition setVehiclePosition;
 	setVehiclePosition.VehicleID = poolID;
 	setVehiclePosition.position = position;
@@ -668,6 +673,7 @@ void Vehicle::setDead(IPlayer& killer)
 	deathData.dead = true;
 	deathData.time = Time::now();
 	deathData.killerID = killer.getID();
+	updateRespawnQueue();
 }
 
 bool Vehicle::isDead()
@@ -709,6 +715,23 @@ void Vehicle::_respawn()
 	cab = nullptr;
 	detaching = false;
 	params = VehicleParams {};
+	updateStreamIndex();
+}
+
+void Vehicle::updateStreamIndex()
+{
+	pool->getStreamIndex().update(*this);
+}
+
+void Vehicle::updateRespawnQueue()
+{
+	pool->queueRespawnCheck(*this);
+}
+
+void Vehicle::setVirtualWorld(int vw)
+{
+	virtualWorld_ = vw;
+	updateStreamIndex();
 }
 
 void Vehicle::respawn()
@@ -727,6 +750,7 @@ Seconds Vehicle::getRespawnDelay()
 void Vehicle::setRespawnDelay(Seconds delay)
 {
 	spawnData.respawnDelay = delay;
+	updateRespawnQueue();
 }
 
 void Vehicle::attachTrailer(IVehicle& trailer)
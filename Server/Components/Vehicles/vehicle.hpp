@@ -67,14 +67,19 @@ private:
 	uint32_t hydraThrustAngle = 0;
 	float trainSpeed = 0.0f;
 	int lastDriverPoolID = INVALID_PLAYER_ID;
+	TimePoint queuedRespawnCheck = TimePoint::max();
 
 	/// Update the vehicle occupied status - set beenOccupied to true and update the lastOccupied time.
 	void updateOccupied()
 	{
 		beenOccupied = true;
 		lastOccupiedChange = Time::now();
+		updateRespawnQueue();
 	}
 
+	/// Queue the vehicle in the component's respawn queue if it needs checking sooner than it's queued for
+	void updateRespawnQueue();
+
 	void setCab(Vehicle* cab)
 	{
 		this->cab = cab;
@@ -83,6 +88,9 @@ private:
 	/// Set vehicle to respawn without emitting onRespawn event
 	void _respawn();
 
+	/// Move the vehicle in the component's stream index after its position or virtual world changed
+	void updateStreamIndex();
+
 public:
 	int getLastDriverPoolID() const override
 	{
@@ -118,6 +126,37 @@ public:
 		deathData.time = time;
 	}
 
+	/// Get the time of the vehicle's earliest entry in the respawn queue, TimePoint::max() if it isn't queued
+	TimePoint getQueuedRespawnCheck() const
+	{
+		return queuedRespawnCheck;
+	}
+
+	void setQueuedRespawnCheck(TimePoint time)
+	{
+		queuedRespawnCheck = time;
+	}
+
+	/// Get when the vehicle's respawn state next needs checking, TimePoint::max() if it's occupied or never respawns
+	TimePoint getNextRespawnCheck(Milliseconds deathRespawnDelay)
+	{
+		if (isOccupied())
+		{
+			return TimePoint::max();
+		}
+		if (deathData.dead)
+		{
+			// The death event is due on the next tick
+			return deathData.time != TimePoint() ? TimePoint() : lastOccupiedChange + deathRespawnDelay;
+		}
+		const int model = spawnData.modelID;
+		if (!beenOccupied || spawnData.respawnDelay <= Seconds(0) || model == 537 || model == 538 || model == 569 || model == 570)
+		{
+			return TimePoint::max();
+		}
+		return lastOccupiedChange + spawnData.respawnDelay;
+	}
+
 	void removeFor(int pid, IPlayer& player)
 	{
 		if (streamedFor_.valid(pid))
@@ -159,10 +198,7 @@ public:
 		return virtualWorld_;
 	}
 
-	void setVirtualWorld(int vw) override
-	{
-		virtualWorld_ = vw;
-	}
+	void setVirtualWorld(int vw) override;
 
 	void setSiren(bool status) override
 	{
@@ -222,6 +258,9 @@ public:
 			int ignore;
 			getRandomVehicleColour(spawnData.modelID, spawnData.colour1 == -1 ? spawnData.colour1 : ignore, spawnData.colour2 == -1 ? spawnData.colour2 : ignore);
 		}
+
+		// The respawn delay may have changed, a fresh vehicle is never due so nothing is queued from the constructor
+		updateRespawnQueue();
 	}
 
 	const VehicleSpawnData& getSpawnData() override
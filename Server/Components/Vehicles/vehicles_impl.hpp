@@ -9,10 +9,12 @@
 #pragma once
 
 #include "vehicle.hpp"
+#include <Impl/spatial_index_impl.hpp>
 #include <Server/Components/Vehicles/vehicle_components.hpp>
 #include <Server/Components/Vehicles/vehicle_models.hpp>
 #include <Server/Components/Vehicles/vehicles.hpp>
 #include <netcode.hpp>
+#include <queue>
 
 using namespace Impl;
 
@@ -20,12 +22,19 @@ class VehiclesComponent final : public IVehiclesComponent, public CoreEventHandl
 {
 private:
 	ICore* core = nullptr;
+	/// Declared before the storage so it outlives the entries it indexes
+	PoolStreamIndex<IVehicle> streamIndex;
 	MarkedPoolStorage<Vehicle, IVehicle, 1, VEHICLE_POOL_SIZE> storage;
 	DefaultEventDispatcher<VehicleEventHandler> eventDispatcher;
 	StaticArray<uint8_t, MAX_VEHICLE_MODELS> preloadModels;
 	StreamConfigHelper streamConfigHelper;
 	int* deathRespawnDelay = nullptr;
 
+	/// Vehicles to check for respawning by when they're due, earliest first
+	/// Entries which aren't the vehicle's earliest one are left in and skipped when they come up
+	std::priority_queue<Pair<TimePoint, int>, DynamicArray<Pair<TimePoint, int>>, std::greater<Pair<TimePoint, int>>> respawnQueue;
+	DynamicArray<int> dueRespawnChecks;
+
 	struct PlayerEnterVehicleHandler : public SingleNetworkInEventHandler
 	{
 		VehiclesComponent& self;
@@ -302,6 +311,23 @@ public:
 		return eventDispatcher;
 	}
 
+	PoolStreamIndex<IVehicle>& getStreamIndex()
+	{
+		return streamIndex;
+	}
+
+	/// Queue a vehicle to be checked for respawning when it's next due, call when its occupants, death or respawn delay change
+	/// Only adds an entry if it's due before the vehicle's queued one, which rechecks and requeues it when it comes up
+	void queueRespawnCheck(Vehicle& vehicle)
+	{
+		const TimePoint due = vehicle.getNextRespawnCheck(Milliseconds(deathRespawnDelay ? *deathRespawnDelay : 0));
+		if (due < vehicle.getQueuedRespawnCheck())
+		{
+			vehicle.setQueuedRespawnCheck(due);
+			respawnQueue.emplace(due, vehicle.getID());
+		}
+	}
+
 	void onPoolEntryDestroyed(IPlayer& player) override
 	{
 		PlayerVehicleData* data = queryExtension<PlayerVehicleData>(player);
@@ -315,6 +341,7 @@ public:
 		{
 			static_cast<Vehicle*>(v)->removeFor(pid, player);
 		}
+		streamIndex.removePlayer(player);
 	}
 
 	VehiclesComponent()
@@ -325,6 +352,7 @@ public:
 		, vehicleDeathHandler(*this)
 	{
 		preloadModels.fill(0);
+		storage.getEventDispatcher().addEventHandler(&streamIndex);
 	}
 
 	~VehiclesComponent()
@@ -349,6 +377,7 @@ public:
 		core->getEventDispatcher().addEventHandler(this);
 		core->getPlayers().getPlayerUpdateDispatcher().addEventHandler(this);
 		core->getPlayers().getPlayerConnectDispatcher().addEventHandler(this);
+		core->getPlayers().registerExtensionSlot(IPlayerVehicleData::ExtensionIID);
 		core->getPlayers().getPlayerChangeDispatcher().addEventHandler(this);
 		core->getPlayers().getPoolEventDispatcher().addEventHandler(this);
 		NetCode::RPC::OnPlayerEnterVehicle::addEventHandler(*core, &playerEnterVehicleHandler);
@@ -487,47 +516,81 @@ public:
 
 	void onTick(Microseconds elapsed, TimePoint now) override
 	{
-		for (IVehicle* v : storage)
+		// Only the vehicles which are due are checked, in ID order like when checking them all
+		while (!respawnQueue.empty() && respawnQueue.top().first <= now)
+		{
+			const Pair<TimePoint, int> entry = respawnQueue.top();
+			respawnQueue.pop();
+			Vehicle* vehicle = storage.get(entry.second);
+			if (vehicle && vehicle->getQueuedRespawnCheck() == entry.first)
+			{
+				vehicle->setQueuedRespawnCheck(TimePoint::max());
+				dueRespawnChecks.push_back(entry.second);
+			}
+		}
+		if (dueRespawnChecks.empty())
 		{
-			Vehicle* vehicle = static_cast<Vehicle*>(v);
-			const Seconds delay = vehicle->getRespawnDelay();
+			return;
+		}
+		std::sort(dueRespawnChecks.begin(), dueRespawnChecks.end());
 
-			if (!vehicle->isOccupied())
+		for (int id : dueRespawnChecks)
+		{
+			Vehicle* vehicle = storage.get(id);
+			if (vehicle)
 			{
-				TimePoint lastOccupied = vehicle->getLastOccupiedTime();
-				if (vehicle->isDead())
+				checkRespawn(*vehicle, now);
+
+				// The death event may have destroyed it
+				vehicle = storage.get(id);
+				if (vehicle)
 				{
-					auto& deathData = vehicle->getDeathData();
-					if (deathData.time != TimePoint())
-					{
-						vehicle->setTimeOfDeath(TimePoint());
-						vehicle->setLastOccupiedTime(std::max(deathData.time, lastOccupied));
-						IPlayer* killer = getPlayers().get(deathData.killerID);
-						if (killer)
-						{
-							ScopedPoolReleaseLock lock(*this, *vehicle);
-							eventDispatcher.dispatch(&VehicleEventHandler::onVehicleDeath, *lock.entry, *killer);
-						}
-					}
-					if (now - vehicle->getLastOccupiedTime() >= Milliseconds(*deathRespawnDelay))
+					queueRespawnCheck(*vehicle);
+				}
+			}
+		}
+		dueRespawnChecks.clear();
+	}
+
+	void checkRespawn(Vehicle& vehicle, TimePoint now)
+	{
+		const Seconds delay = vehicle.getRespawnDelay();
+
+		if (!vehicle.isOccupied())
+		{
+			TimePoint lastOccupied = vehicle.getLastOccupiedTime();
+			if (vehicle.isDead())
+			{
+				auto& deathData = vehicle.getDeathData();
+				if (deathData.time != TimePoint())
+				{
+					vehicle.setTimeOfDeath(TimePoint());
+					vehicle.setLastOccupiedTime(std::max(deathData.time, lastOccupied));
+					IPlayer* killer = getPlayers().get(deathData.killerID);
+					if (killer)
 					{
-						vehicle->respawn();
+						ScopedPoolReleaseLock lock(*this, vehicle);
+						eventDispatcher.dispatch(&VehicleEventHandler::onVehicleDeath, *lock.entry, *killer);
 					}
 				}
-				else if (vehicle->hasBeenOccupied() && delay > Seconds(0))
+				if (now - vehicle.getLastOccupiedTime() >= Milliseconds(*deathRespawnDelay))
 				{
+					vehicle.respawn();
+				}
+			}
+			else if (vehicle.hasBeenOccupied() && delay > Seconds(0))
+			{
 
-					// Trains shouldn't be respawned.
-					const int model = vehicle->getModel();
-					if (model == 537 || model == 538 || model == 569 || model == 570)
-					{
-						continue;
-					}
+				// Trains shouldn't be respawned.
+				const int model = vehicle.getModel();
+				if (model == 537 || model == 538 || model == 569 || model == 570)
+				{
+					return;
+				}
 
-					if (now - vehicle->getLastOccupiedTime() >= delay)
-					{
-						vehicle->respawn();
-					}
+				if (now - vehicle.getLastOccupiedTime() >= delay)
+				{
+					vehicle.respawn();
 				}
 			}
 		}
@@ -537,6 +600,7 @@ public:
 	{
 		// Destroy all stored entity instances.
 		storage.clear();
+		respawnQueue = decltype(respawnQueue)();
 	}
 
 	void onPlayerStateChange(IPlayer& player, PlayerState newState, PlayerState oldState) override
@@ -580,29 +644,61 @@ public:
 		const float maxDist = streamConfigHelper.getDistanceSqr();
 		if (streamConfigHelper.shouldStream(player.getID(), now))
 		{
-			for (IVehicle* v : storage)
+			const Vector3 pos = player.getPosition();
+			const int vw = player.getVirtualWorld();
+			auto updateStream = [&](IVehicle& v)
 			{
-				Vehicle* vehicle = static_cast<Vehicle*>(v);
+				Vehicle* vehicle = static_cast<Vehicle*>(&v);
 
 				// Trains carriages are created/destroyed by client.
 				const int model = vehicle->getModel();
 				if (model == 569 || model == 570)
 				{
-					continue;
+					return;
 				}
 
-				const Vector2 dist2D = vehicle->getPosition() - player.getPosition();
-				const bool shouldBeStreamedIn = state != PlayerState_None && player.getVirtualWorld() == vehicle->getVirtualWorld() && (playerVehicle == vehicle || glm::dot(dist2D, dist2D) < maxDist);
+				const Vector2 dist2D = vehicle->getPosition() - pos;
+				const float distSqr = glm::dot(dist2D, dist2D);
+				const bool shouldBeStreamedIn = state != PlayerState_None && vw == vehicle->getVirtualWorld() && (playerVehicle == vehicle || distSqr < maxDist);
 
 				const bool isStreamedIn = vehicle->isStreamedInForPlayer(player);
 				if (!isStreamedIn && shouldBeStreamedIn)
 				{
-					vehicle->streamInForPlayer(player);
+					// The player's own vehicle skips the queue
+					if (playerVehicle == vehicle)
+					{
+						vehicle->streamInForPlayer(player);
+					}
+					else
+					{
+						streamIndex.queueStreamIn(*vehicle, distSqr);
+					}
 				}
 				else if (isStreamedIn && !shouldBeStreamedIn)
 				{
 					vehicle->streamOutForPlayer(player);
 				}
+			};
+
+			streamIndex.forEachCandidate(storage, player, pos, vw, streamConfigHelper.getDistance(), updateStream);
+
+			// The player's own vehicle is streamed regardless of distance so it may not be among the candidates
+			if (playerVehicle && !playerVehicle->isStreamedInForPlayer(player))
+			{
+				updateStream(*playerVehicle);
+			}
+
+			// Stream outs are done by now so the nearest vehicles get the room they left
+			const int numStreamed = playerVehicleData ? playerVehicleData->getNumStreamed() : MAX_STREAMED_VEHICLES;
+			const size_t room = size_t(std::max(MAX_STREAMED_VEHICLES - numStreamed, 0));
+			const size_t budget = streamConfigHelper.getStreamInBudget();
+			const bool waiting = streamIndex.streamInNearest(storage, std::min(budget, room), [&player](IVehicle& vehicle)
+				{
+					vehicle.streamInForPlayer(player);
+				});
+			if (waiting && budget < room)
+			{
+				streamConfigHelper.requestStream(player.getID());
 			}
 		}
 		return true;
@@ -0,0 +1,262 @@
+/*
+ *  This Source Code Form is subject to the terms of the Mozilla Public License,
+ *  v. 2.0. If a copy of the MPL was not distributed with this file, You can
+ *  obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ *  The original code is copyright (c) 2022, open.mp team and contributors.
+ */
+
+#include <Server/Components/Vehicles/vehicles.hpp>
+#include <sdk.hpp>
+
+using namespace Impl;
+
+/// Respawn delay of the test vehicles, long enough that only a requeued respawn check respawns them in time
+const Seconds testLongRespawnDelay(60);
+
+/// Respawn delay set through the spawn data once a player left the test vehicle
+const Seconds testShortRespawnDelay(2);
+
+/// How late a respawn may be, respawns are checked on ticks
+const Milliseconds testRespawnTolerance(1000);
+
+/// How long the vehicle which was never occupied is watched for respawning
+const Seconds testIdleDuration(5);
+
+/// Checks vehicles respawn from their queued respawn checks:
+/// a vehicle which was never occupied never respawns, even after its respawn delay and spawn data change,
+/// and a vehicle a player left respawns after the delay set through its spawn data, not the one it had when it was left
+/// The second check needs a player: a vehicle is created next to each player when they spawn, drive it and get out
+struct VehiclesTestComponent final : public IComponent, public CoreEventHandler, public PlayerSpawnEventHandler, public VehicleEventHandler, public PoolEventHandler<IVehicle>, public NoCopy
+{
+	/// Core
+	ICore* core = nullptr;
+
+	/// Vehicles component
+	IVehiclesComponent* vehicles = nullptr;
+
+	/// Vehicle which is never occupied and must never respawn
+	IVehicle* idleVehicle = nullptr;
+
+	/// When the idle vehicle stops being watched
+	TimePoint idleUntil;
+
+	/// Vehicle a player left, waiting for it to respawn
+	IVehicle* leftVehicle = nullptr;
+
+	/// When the left vehicle is due to respawn
+	TimePoint leftDue;
+
+	/// Vehicles created for players to drive
+	FlatPtrHashSet<IVehicle> playerVehicles;
+
+	/// Failed checks
+	int errors = 0;
+
+	/// Gets the component UID
+	/// @returns Component UID
+	UID getUID() override
+	{
+		return 0x81d7f3a26c05be49;
+	}
+
+	/// Gets the component name
+	/// @returns Component name
+	StringView componentName() const override
+	{
+		return "Vehicles test";
+	}
+
+	/// Gets the component type
+	/// @returns Component type
+	ComponentType componentType() const override
+	{
+		return ComponentType::Other;
+	}
+
+	/// Gets the component version
+	/// @return Component version
+	SemanticVersion componentVersion() const override
+	{
+		return SemanticVersion(OMP_VERSION_MAJOR, OMP_VERSION_MINOR, OMP_VERSION_PATCH, BUILD_NUMBER);
+	}
+
+	/// Called for every component after components have been loaded
+	/// @param c Core
+	void onLoad(ICore* c) override
+	{
+		core = c;
+		core->getEventDispatcher().addEventHandler(this);
+		core->getPlayers().getPlayerSpawnDispatcher().addEventHandler(this);
+	}
+
+	/// Called when all components have been initialised
+	/// @param components Component list to query
+	void onInit(IComponentList* components) override
+	{
+		vehicles = components->queryComponent<IVehiclesComponent>();
+		if (vehicles)
+		{
+			vehicles->getEventDispatcher().addEventHandler(this);
+			vehicles->getPoolEventDispatcher().addEventHandler(this);
+		}
+	}
+
+	/// Creates the vehicle which is never occupied and changes its respawn delay both ways
+	void onReady() override
+	{
+		if (!vehicles)
+		{
+			core->printLn("[ERROR] Vehicles test: the vehicles component isn't loaded.");
+			return;
+		}
+
+		idleVehicle = vehicles->create(false, 411, Vector3(0.0f, 0.0f, 3.0f), 0.0f, 1, 1, testLongRespawnDelay);
+		if (!idleVehicle)
+		{
+			check(false, "Couldn't create the idle vehicle.");
+			return;
+		}
+		idleVehicle->setRespawnDelay(Seconds(1));
+		VehicleSpawnData data = idleVehicle->getSpawnData();
+		data.respawnDelay = Seconds(1);
+		idleVehicle->setSpawnData(data);
+		idleUntil = Time::now() + testIdleDuration;
+		core->printLn("Vehicles test: watching a vehicle which was never occupied, spawn and leave a vehicle to check respawning");
+	}
+
+	/// Counts a failed check
+	/// @param condition Checked condition
+	/// @param description What was checked
+	void check(bool condition, const char* description)
+	{
+		if (!condition)
+		{
+			core->printLn("[ERROR] Vehicles test: %s", description);
+			++errors;
+		}
+	}
+
+	/// Creates a vehicle next to a player who spawned, with a respawn delay longer than the check waits
+	void onPlayerSpawn(IPlayer& player) override
+	{
+		if (!vehicles)
+		{
+			return;
+		}
+
+		IVehicle* vehicle = vehicles->create(false, 411, player.getPosition() + Vector3(4.0f, 0.0f, 0.0f), 0.0f, 1, 1, testLongRespawnDelay);
+		if (vehicle)
+		{
+			vehicle->setVirtualWorld(player.getVirtualWorld());
+			playerVehicles.insert(vehicle);
+			player.sendClientMessage(Colour::White(), "Vehicles test: get in the vehicle next to you and leave it to check it respawns in time.");
+		}
+	}
+
+	/// Checks which vehicles respawned and whether they were due
+	void onVehicleSpawn(IVehicle& vehicle) override
+	{
+		const TimePoint now = Time::now();
+		if (&vehicle == idleVehicle)
+		{
+			check(false, "A vehicle which was never occupied respawned.");
+		}
+		else if (&vehicle == leftVehicle)
+		{
+			const long long early = std::chrono::duration_cast<Milliseconds>(leftDue - now).count();
+			check(early <= 0, "A vehicle respawned before the respawn delay set through its spawn data.");
+			core->printLn("Vehicles test: a vehicle respawned %lld ms after it was due", -early);
+			leftVehicle = nullptr;
+			vehicle.setRespawnDelay(testLongRespawnDelay);
+		}
+	}
+
+	/// Forgets destroyed vehicles
+	void onPoolEntryDestroyed(IVehicle& vehicle) override
+	{
+		playerVehicles.erase(&vehicle);
+		if (&vehicle == idleVehicle)
+		{
+			idleVehicle = nullptr;
+		}
+		if (&vehicle == leftVehicle)
+		{
+			leftVehicle = nullptr;
+		}
+	}
+
+	/// Shortens the respawn delay of a vehicle a player left through its spawn data, and checks the vehicles are respawned in time
+	void onTick(Microseconds elapsed, TimePoint now) override
+	{
+		if (idleVehicle && now >= idleUntil)
+		{
+			core->printLn("Vehicles test: a vehicle which was never occupied wasn't respawned");
+			vehicles->release(idleVehicle->getID());
+			idleVehicle = nullptr;
+		}
+
+		if (leftVehicle)
+		{
+			if (now > leftDue + testRespawnTolerance)
+			{
+				check(false, "A vehicle wasn't respawned after the respawn delay set through its spawn data.");
+				leftVehicle->setRespawnDelay(testLongRespawnDelay);
+				leftVehicle = nullptr;
+			}
+			return;
+		}
+
+		for (IVehicle* vehicle : playerVehicles)
+		{
+			if (vehicle->hasBeenOccupied() && !vehicle->isOccupied() && !vehicle->isDead())
+			{
+				// Queued for the long delay when it was left, the spawn data must queue it again
+				VehicleSpawnData data = vehicle->getSpawnData();
+				data.respawnDelay = testShortRespawnDelay;
+				vehicle->setSpawnData(data);
+				leftVehicle = vehicle;
+				leftDue = vehicle->getLastOccupiedTime() + testShortRespawnDelay;
+				core->printLn("Vehicles test: a vehicle was left, it should respawn in %d seconds", int(testShortRespawnDelay.count()));
+				break;
+			}
+		}
+	}
+
+	/// Called when another component is about to be freed
+	/// @param component The component being freed
+	void onFree(IComponent* component) override
+	{
+		if (component == vehicles)
+		{
+			vehicles = nullptr;
+			idleVehicle = nullptr;
+			leftVehicle = nullptr;
+			playerVehicles.clear();
+		}
+	}
+
+	/// Frees this component, it isn't allocated
+	void free() override
+	{
+		if (vehicles)
+		{
+			vehicles->getEventDispatcher().removeEventHandler(this);
+			vehicles->getPoolEventDispatcher().removeEventHandler(this);
+		}
+		core->getPlayers().getPlayerSpawnDispatcher().removeEventHandler(this);
+		core->getEventDispatcher().removeEventHandler(this);
+	}
+
+	void reset() override
+	{
+		idleVehicle = nullptr;
+		leftVehicle = nullptr;
+		playerVehicles.clear();
+	}
+} vehiclesTestComponent;
+
+COMPONENT_ENTRY_POINT()
+{
+	return &vehiclesTestComponent;
+}
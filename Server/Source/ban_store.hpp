@@ -0,0 +1,316 @@
+/*
+ *  This Source Code Form is subject to the terms of the Mozilla Public License,
+ *  v. 2.0. If a copy of the MPL was not distributed with this file, You can
+ *  obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ *  The original code is copyright (c) 2022, open.mp team and contributors.
+ */
+
+#pragma once
+
+#include <Impl/ban_index_impl.hpp>
+#include <atomic>
+#include <fstream>
+#include <ghc/filesystem.hpp>
+#include <network.hpp>
+#include <thread>
+#include <types.hpp>
+
+using namespace Impl;
+
+/// The server's bans, indexed by address and saved through an append-only journal of changes next to the bans file
+/// Every ban is kept with its JSON record so the bans file can be rewritten without serialising them again
+/// Once the journal holds more changes than there are bans a background thread folds it into the bans file
+class BanStore final : public NoCopy
+{
+public:
+	static constexpr const char* FileName = "bans.json";
+	static constexpr const char* JournalFileName = "bans.journal";
+
+	/// The journal being folded into the bans file, replayed before the journal when a compaction didn't finish
+	static constexpr const char* CompactingFileName = "bans.journal.compacting";
+
+	/// Changes journalled before compacting when there are fewer bans than this
+	static constexpr size_t MinCompactChanges = 1024;
+
+	BanStore() = default;
+
+	/// Keep the bans file and its journals in another directory than the working one, the path must end with a separator
+	explicit BanStore(StringView directory)
+		: fileName_(String(directory) + FileName)
+		, journalFileName_(String(directory) + JournalFileName)
+		, compactingFileName_(String(directory) + CompactingFileName)
+	{
+	}
+
+	~BanStore()
+	{
+		flush();
+		wait();
+	}
+
+	/// The bans file to load before replaying the journals
+	const String& fileName() const
+	{
+		return fileName_;
+	}
+
+	size_t size() const
+	{
+		return entries_.size();
+	}
+
+	const BanEntry& get(size_t index) const
+	{
+		return entries_[index];
+	}
+
+	/// Whether an address or range is banned as written
+	bool contains(StringView address) const
+	{
+		return index_.find(address) != BanIndex::NotFound;
+	}
+
+	/// Whether any ban covers an address
+	bool isBanned(StringView address) const
+	{
+		return index_.matches(address);
+	}
+
+	/// Add a ban with its JSON record, returns false if its address is already banned
+	bool add(const BanEntry& entry, String record, bool journal = true)
+	{
+		if (!index_.insert(entry.address, entries_.size()))
+		{
+			return false;
+		}
+
+		if (journal)
+		{
+			journalChange("add", record);
+		}
+		entries_.emplace_back(entry);
+		records_.emplace_back(std::move(record));
+		return true;
+	}
+
+	/// Remove the ban on an address, returns false if it isn't banned as written
+	bool remove(StringView address, bool journal = true)
+	{
+		const size_t index = index_.find(address);
+		if (index == BanIndex::NotFound)
+		{
+			return false;
+		}
+		removeAt(index, journal);
+		return true;
+	}
+
+	/// Remove a ban by position, the last ban takes its place
+	void removeAt(size_t index, bool journal = true)
+	{
+		if (journal)
+		{
+			journalChange("remove", records_[index]);
+		}
+
+		index_.erase(entries_[index].address);
+		if (index != entries_.size() - 1)
+		{
+			entries_[index] = entries_.back();
+			records_[index] = std::move(records_.back());
+			index_.move(entries_[index].address, index);
+		}
+		entries_.pop_back();
+		records_.pop_back();
+	}
+
+	void clear(bool journal = true)
+	{
+		if (journal)
+		{
+			pending_ += "{\"op\":\"clear\"}\n";
+			++changes_;
+		}
+
+		entries_.clear();
+		records_.clear();
+		index_.clear();
+	}
+
+	/// Write the pending changes and forget every ban so they can be loaded again
+	void reset()
+	{
+		flush();
+		wait();
+		journal_.close();
+		clear(false);
+		changes_ = 0;
+	}
+
+	/// Call a handler with every change in the journals in the order they were made, call after reset() and loading the bans file
+	template <typename F>
+	void replay(F handler)
+	{
+		String line;
+		for (const String* path : { &compactingFileName_, &journalFileName_ })
+		{
+			std::ifstream file(*path, std::ios_base::in | std::ios_base::binary);
+			while (file.good() && std::getline(file, line))
+			{
+				if (!line.empty())
+				{
+					handler(StringView(line));
+					++changes_;
+				}
+			}
+		}
+	}
+
+	/// Append the changes made since the last call to the journal and compact it in the background once it's grown enough
+	void write()
+	{
+		flush();
+		if (changes_ >= std::max(MinCompactChanges, entries_.size()))
+		{
+			compact(false);
+		}
+	}
+
+	/// Fold the journal left by the last run into the bans file, or create it if it's missing
+	void settle()
+	{
+		std::error_code ec;
+		if (changes_ != 0 || !pending_.empty() || !ghc::filesystem::exists(fileName_, ec))
+		{
+			compact(true);
+		}
+	}
+
+	/// Rewrite the bans file with every ban and drop the journal, done in the background unless waiting
+	/// A compaction which is still running when another one is requested without waiting postpones it to the next write
+	void compact(bool waitForIt)
+	{
+		if (compactor_.joinable())
+		{
+			if (!waitForIt && !compacted_)
+			{
+				return;
+			}
+			compactor_.join();
+		}
+
+		flush();
+		journal_.close();
+
+		std::error_code ec;
+		if (ghc::filesystem::exists(journalFileName_, ec))
+		{
+			if (ghc::filesystem::exists(compactingFileName_, ec))
+			{
+				// The last compaction failed, keep its changes ahead of the newer ones
+				std::ofstream compacting(compactingFileName_, std::ios_base::out | std::ios_base::binary | std::ios_base::app);
+				std::ifstream journal(journalFileName_, std::ios_base::in | std::ios_base::binary);
+				compacting << journal.rdbuf();
+				compacting.close();
+				journal.close();
+				if (!compacting.fail())
+				{
+					ghc::filesystem::remove(journalFileName_, ec);
+				}
+			}
+			else
+			{
+				ghc::filesystem::rename(journalFileName_, compactingFileName_, ec);
+			}
+		}
+
+		changes_ = 0;
+		compacted_ = false;
+		compactor_ = std::thread(&BanStore::writeSnapshot, this, records_);
+		if (waitForIt)
+		{
+			compactor_.join();
+		}
+	}
+
+private:
+	/// Wait for the running compaction
+	void wait()
+	{
+		if (compactor_.joinable())
+		{
+			compactor_.join();
+		}
+	}
+
+	void journalChange(StringView op, StringView record)
+	{
+		pending_ += "{\"op\":\"";
+		pending_ += op;
+		pending_ += "\",\"ban\":";
+		pending_ += record;
+		pending_ += "}\n";
+		++changes_;
+	}
+
+	void flush()
+	{
+		if (pending_.empty())
+		{
+			return;
+		}
+
+		if (!journal_.is_open())
+		{
+			journal_.clear();
+			journal_.open(journalFileName_, std::ios_base::out | std::ios_base::binary | std::ios_base::app);
+		}
+		if (journal_.good())
+		{
+			journal_.write(pending_.data(), pending_.size());
+			journal_.flush();
+		}
+		pending_.clear();
+	}
+
+	/// Write the bans file from the compaction thread, the journal being compacted is only removed once the file is replaced
+	void writeSnapshot(DynamicArray<String> records)
+	{
+		const String temporary = fileName_ + ".tmp";
+		std::ofstream file(temporary, std::ios_base::out | std::ios_base::binary | std::ios_base::trunc);
+		file << "[";
+		for (size_t i = 0; i < records.size(); ++i)
+		{
+			file << (i ? ",\n    " : "\n    ") << records[i];
+		}
+		file << "\n]\n";
+		file.close();
+
+		std::error_code ec;
+		if (!file.fail())
+		{
+			ghc::filesystem::rename(temporary, fileName_, ec);
+			if (!ec)
+			{
+				ghc::filesystem::remove(compactingFileName_, ec);
+			}
+		}
+		compacted_ = true;
+	}
+
+	String fileName_ = FileName;
+	String journalFileName_ = JournalFileName;
+	String compactingFileName_ = CompactingFileName;
+
+	DynamicArray<BanEntry> entries_;
+	DynamicArray<String> records_; ///< The JSON record of each ban, in the same order
+	BanIndex index_;
+
+	String pending_; ///< Journal lines not written yet
+	size_t changes_ = 0; ///< Changes in the journal and pending
+	std::ofstream journal_;
+
+	std::thread compactor_;
+	std::atomic_bool compacted_ = true;
+};
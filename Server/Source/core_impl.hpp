@@ -8,7 +8,11 @@
 
 #pragma once
 
+#include "ban_store.hpp"
+#include "http_client.hpp"
+#include "log_writer.hpp"
 #include "player_pool.hpp"
+#include "profiler.hpp"
 #include "util.hpp"
 #include <Impl/network_impl.hpp>
 #include <Server/Components/Classes/classes.hpp>
@@ -37,12 +41,6 @@
 
 using namespace Impl;
 
-#pragma clang diagnostic push
-#pragma clang diagnostic ignored "-Wlogical-op-parentheses"
-#define CPPHTTPLIB_OPENSSL_SUPPORT
-#include <httplib.h>
-#pragma clang diagnostic pop
-
 #include <openssl/sha.h>
 
 typedef std::variant<int, String, float, DynamicArray<String>, bool> ConfigStorage;
@@ -78,6 +76,7 @@ static const std::map<String, ConfigStorage> Defaults {
 	{ "game.use_player_marker_draw_radius", false },
 	{ "game.use_player_ped_anims", false },
 	{ "game.use_stunt_bonuses", true },
+	{ "game.use_textdraw_auto_update", false },
 	{ "game.use_manual_engine_and_lights", false },
 	{ "game.use_vehicle_friendly_fire", false },
 	{ "game.use_zone_names", false },
@@ -100,6 +99,7 @@ static const std::map<String, ConfigStorage> Defaults {
 	{ "logging.timestamp_format", String("[%Y-%m-%dT%H:%M:%S%z]") },
 	{ "logging.use_timestamp", true },
 	{ "logging.use_prefix", true },
+	{ "logging.use_async_writer", false },
 	// network
 	{ "network.bind", String("") },
 	{ "network.public_addr", String("") }, // Used by webserver
@@ -117,8 +117,16 @@ static const std::map<String, ConfigStorage> Defaults {
 	{ "network.on_foot_sync_rate", 30 },
 	{ "network.player_marker_sync_rate", 2500 },
 	{ "network.player_timeout", 10000 },
+	{ "network.query_rate_limit", 20 },
+	{ "network.query_update_rate", 250 },
 	{ "network.stream_radius", 200.f },
 	{ "network.stream_rate", 1000 },
+	{ "network.stream_in_budget", 50 },
+	{ "network.object_creation_budget", 1024 },
+	{ "network.use_object_streamer", false },
+	{ "network.http_threads", 4 },
+	{ "network.http_queue_size", 1024 },
+	{ "network.object_stream_radius", 300.f },
 	{ "network.time_sync_rate", 30000 },
 	{ "network.use_lan_mode", false },
 	{ "network.allow_037_clients", true },
@@ -288,6 +296,19 @@ public:
 		return components.try_emplace(component->getUID(), component);
 	}
 
+	/// Find the component an object belongs to by comparing most derived addresses
+	IComponent* findByObject(const void* object)
+	{
+		for (const auto& pair : components)
+		{
+			if (dynamic_cast<const void*>(pair.second) == object)
+			{
+				return pair.second;
+			}
+		}
+		return nullptr;
+	}
+
 	size_t size() const
 	{
 		return components.size();
@@ -302,8 +323,6 @@ static constexpr const char* TimeFormat = "%Y-%m-%dT%H:%M:%S%z";
 class Config final : public IEarlyConfig
 {
 private:
-	static constexpr const char* BansFileName = "bans.json";
-
 	IUnicodeComponent* unicode = nullptr;
 	ICore& core;
 	String ConfigFileName = "config.json";
@@ -556,67 +575,41 @@ public:
 
 	void addBan(const BanEntry& entry) override
 	{
-		bans.emplace_back(entry);
+		if (!bans.contains(entry.address))
+		{
+			bans.add(entry, banRecord(entry));
+		}
 	}
 
 	void removeBan(const BanEntry& entry) override
 	{
-		auto ban_itr = std::find_if(bans.begin(), bans.end(), [&](const BanEntry& ban)
-			{
-				return ban.address == entry.address;
-			});
-
-		if (ban_itr != bans.end())
+		if (bans.remove(entry.address))
 		{
-			bans.erase(ban_itr);
 			writeBans();
 		}
 	}
 
 	void removeBan(size_t index) override
 	{
-		bans.erase(bans.begin() + index);
+		bans.removeAt(index);
 	}
 
 	void reloadBans() override
 	{
 		for (INetwork* network : core.getNetworks())
 		{
-			for (BanEntry ban : bans)
+			for (size_t i = 0; i < bans.size(); ++i)
 			{
-				network->unban(ban);
+				network->unban(bans.get(i));
 			}
 		}
 
-		bans.clear();
 		loadBans();
 	}
 
 	void writeBans() override
 	{
-		optimiseBans();
-
-		nlohmann::json top = nlohmann::json::array();
-		for (const BanEntry& entry : bans)
-		{
-			nlohmann::json obj;
-			OptimisedString addressUTF8 = unicode ? unicode->toUTF8(entry.address) : OptimisedString(entry.address);
-			OptimisedString nameUTF8 = unicode ? unicode->toUTF8(entry.name) : OptimisedString(entry.name);
-			OptimisedString reasonUTF8 = unicode ? unicode->toUTF8(entry.reason) : OptimisedString(entry.reason);
-			obj["address"] = StringView(addressUTF8);
-			obj["player"] = StringView(nameUTF8);
-			obj["reason"] = StringView(reasonUTF8);
-			char iso8601[28] = { 0 };
-			std::time_t now = WorldTime::to_time_t(entry.time);
-			std::strftime(iso8601, sizeof(iso8601), TimeFormat, std::localtime(&now));
-			obj["time"] = iso8601;
-			top.push_back(obj);
-		}
-		std::ofstream file(BansFileName);
-		if (file.good())
-		{
-			file << top.dump(4, ' ', false, nlohmann::detail::error_handler_t::ignore);
-		}
+		bans.write();
 	}
 
 	void clearBans() override
@@ -627,10 +620,7 @@ public:
 
 	bool isBanned(const BanEntry& entry) const override
 	{
-		return std::any_of(bans.begin(), bans.end(), [&](const BanEntry& ban)
-			{
-				return entry.address == ban.address;
-			});
+		return bans.isBanned(entry.address);
 	}
 
 	size_t getBansCount() const override
@@ -640,13 +630,13 @@ public:
 
 	const BanEntry& getBan(size_t index) const override
 	{
-		return bans[index];
+		return bans.get(index);
 	}
 
-	void optimiseBans()
+	/// Fold the ban changes journalled by the last run into the bans file
+	void settleBans()
 	{
-		std::sort(bans.begin(), bans.end());
-		bans.erase(std::unique(bans.begin(), bans.end()), bans.end());
+		bans.settle();
 	}
 
 	bool writeDefault(ComponentList& components)
@@ -757,7 +747,9 @@ public:
 private:
 	void loadBans()
 	{
-		std::ifstream ifs(BansFileName);
+		bans.reset();
+
+		std::ifstream ifs(bans.fileName());
 		if (ifs.good())
 		{
 			nlohmann::json props = nlohmann::json::parse(ifs, nullptr, false /* allow_exceptions */, true /* ignore_comments */);
@@ -766,19 +758,72 @@ private:
 				const auto& arr = props.get<nlohmann::json::array_t>();
 				for (const auto& arrVal : arr)
 				{
-					std::tm time = {};
-					std::istringstream(arrVal["time"].get<String>()) >> std::get_time(&time, TimeFormat);
-					time_t t =
+					bans.add(banFromJSON(arrVal), arrVal.dump(-1, ' ', false, nlohmann::detail::error_handler_t::ignore), false /* journal */);
+				}
+			}
+		}
+
+		bans.replay([this](StringView line)
+			{
+				nlohmann::json change = nlohmann::json::parse(line.begin(), line.end(), nullptr, false /* allow_exceptions */);
+				if (change.is_discarded() || !change.is_object())
+				{
+					// Cut short when the server stopped while writing it
+					return;
+				}
+
+				const String op = change.value("op", "");
+				if (op == "clear")
+				{
+					bans.clear(false /* journal */);
+					return;
+				}
+
+				auto ban = change.find("ban");
+				if (ban == change.end() || !ban->is_object())
+				{
+					return;
+				}
+				else if (op == "add")
+				{
+					bans.add(banFromJSON(*ban), ban->dump(-1, ' ', false, nlohmann::detail::error_handler_t::ignore), false /* journal */);
+				}
+				else if (op == "remove")
+				{
+					bans.remove(ban->value("address", ""), false /* journal */);
+				}
+			});
+	}
+
+	static BanEntry banFromJSON(const nlohmann::json& obj)
+	{
+		std::tm time = {};
+		std::istringstream(obj.value("time", "")) >> std::get_time(&time, TimeFormat);
+		time_t t =
 #if defined(WIN32) || defined(_WIN32) || defined(__WIN32__)
-						_mkgmtime(&time);
+			_mkgmtime(&time);
 #else
-						timegm(&time);
+			timegm(&time);
 #endif
 
-					bans.emplace_back(BanEntry(arrVal["address"].get<String>(), arrVal["player"].get<String>(), arrVal["reason"].get<String>(), WorldTime::from_time_t(t)));
-				}
-			}
-		}
+		return BanEntry(obj.value("address", ""), obj.value("player", ""), obj.value("reason", ""), WorldTime::from_time_t(t));
+	}
+
+	/// Serialise a ban as it's stored in the bans file and journal
+	String banRecord(const BanEntry& entry) const
+	{
+		nlohmann::json obj;
+		OptimisedString addressUTF8 = unicode ? unicode->toUTF8(entry.address) : OptimisedString(entry.address);
+		OptimisedString nameUTF8 = unicode ? unicode->toUTF8(entry.name) : OptimisedString(entry.name);
+		OptimisedString reasonUTF8 = unicode ? unicode->toUTF8(entry.reason) : OptimisedString(entry.reason);
+		obj["address"] = StringView(addressUTF8);
+		obj["player"] = StringView(nameUTF8);
+		obj["reason"] = StringView(reasonUTF8);
+		char iso8601[28] = { 0 };
+		std::time_t now = WorldTime::to_time_t(entry.time);
+		std::strftime(iso8601, sizeof(iso8601), TimeFormat, std::localtime(&now));
+		obj["time"] = iso8601;
+		return obj.dump(-1, ' ', false, nlohmann::detail::error_handler_t::ignore);
 	}
 
 	bool getFromKey(StringView input, int index, const ConfigStorage*& output) const
@@ -818,144 +863,12 @@ private:
 		return processed;
 	}
 
-	DynamicArray<BanEntry> bans;
+	BanStore bans;
 	std::map<String, ConfigStorage> processed;
 	FlatHashMap<String, Pair<bool, String>> aliases;
 };
 
-class HTTPAsyncIO
-{
-public:
-	HTTPAsyncIO(HTTPResponseHandler* handler, HTTPRequestType type, StringView url, StringView data, bool force_v4 = false, StringView bindAddr = "")
-		: handler(handler)
-		, type(type)
-		, url(url)
-		, data(data)
-		, force_v4(force_v4)
-		, bindAddr(bindAddr)
-		, finished(false)
-		, response(0)
-	{
-		thread = std::thread(&threadProc, this);
-	}
-
-	~HTTPAsyncIO()
-	{
-		if (thread.joinable())
-		{
-			thread.join();
-		}
-	}
-
-	bool tryExec()
-	{
-		if (finished)
-		{
-			handler->onHTTPResponse(response, body);
-			return true;
-		}
-		else
-		{
-			return false;
-		}
-	}
-
-private:
-	static void threadProc(HTTPAsyncIO* params)
-	{
-		constexpr StringView http = "http://";
-		constexpr StringView https = "https://";
-
-		HTTPRequestType type = params->type;
-		StringView url = params->url;
-		StringView data = params->data;
-
-		// Deconstruct because a certain someone decided it would be a good idea to have http:// be optional
-		StringView urlNoPrefix = url;
-		bool secure = false;
-		int idx;
-		if ((idx = url.find(http)) == 0)
-		{
-			urlNoPrefix = url.substr(http.size());
-			secure = false;
-		}
-		else if ((idx = url.find(https)) == 0)
-		{
-			urlNoPrefix = url.substr(https.size());
-			secure = true;
-		}
-
-		// Deconstruct further
-		StringView domain = urlNoPrefix;
-		StringView path = "/";
-		if ((idx = urlNoPrefix.find_first_of('/')) != StringView::npos)
-		{
-			domain = urlNoPrefix.substr(0, idx);
-			path = urlNoPrefix.substr(idx);
-		}
-
-		// Reconstruct
-		String domainStr = String(secure ? https : http) + String(domain);
-
-		// Set up request
-		httplib::Client request(domainStr.c_str());
-		request.set_default_headers({ { "User-Agent", "open.mp server" } });
-		request.enable_server_certificate_verification(true);
-		request.set_follow_location(true);
-		request.set_connection_timeout(Seconds(5));
-		request.set_read_timeout(Seconds(60));
-		request.set_write_timeout(Seconds(5));
-		request.set_keep_alive(true);
-
-		if (params->force_v4)
-			request.set_address_family(AF_INET);
-
-		if (!params->bindAddr.empty())
-			request.set_interface(params->bindAddr);
-
-		// Run request
-		httplib::Result res(nullptr, httplib::Error::Canceled);
-		switch (type)
-		{
-		case HTTPRequestType_Get:
-			res = request.Get(path.data());
-			break;
-		case HTTPRequestType_Post:
-			res = request.Post(path.data(), String(data), "application/x-www-form-urlencoded");
-			break;
-		case HTTPRequestType_Head:
-			res = request.Head(path.data());
-			break;
-		}
-
-		if (res)
-		{
-			params->body = res.value().body;
-			params->response = res.value().status;
-		}
-		else
-		{
-			params->response = int(res.error());
-		}
-
-		params->finished.store(true);
-	}
-
-	std::thread thread;
-	HTTPResponseHandler* handler;
-	HTTPRequestType type;
-	String url;
-	String data;
-
-	bool force_v4;
-	String bindAddr;
-
-	std::atomic_bool finished;
-	int response;
-	String body;
-};
-
-class Core final : public ICore, public PlayerConnectEventHandler, public ConsoleEventHandler
+class Core final : public ICore, public PlayerConnectEventHandler, public ConsoleEventHandler, public LogSink
 {
 private:
 	DefaultEventDispatcher<CoreEventHandler> eventDispatcher;
@@ -973,7 +886,13 @@ private:
 	unsigned ticksPerSecond;
 	unsigned ticksThisSecond;
 	TimePoint ticksPerSecondLastUpdate;
-	std::set<HTTPAsyncIO*> httpFutures;
+	HTTPClientPool httpClients;
+	bool httpQueueFull = false;
+	TickProfiler profiler;
+	int tickSection;
+	int httpSection;
+	/// Profiler sections for core event handlers' ticks, named after their owner
+	FlatHashMap<CoreEventHandler*, int> tickSections;
 
 	bool* EnableZoneNames;
 	bool* UsePlayerPedAnims;
@@ -1004,6 +923,7 @@ private:
 	bool EnableLogTimestamp;
 	bool EnableLogPrefix;
 	String LogTimestampFormat;
+	LogWriter logWriter;
 	String LogFileName;
 
 	void addComponent(IComponent* component)
@@ -1373,8 +1293,11 @@ public:
 			return false;
 		}
 
-		fclose(logFile);
-		logFile = ::fopen(LogFileName.c_str(), "a");
+		logWriter.pause([this]()
+			{
+				fclose(logFile);
+				logFile = ::fopen(LogFileName.c_str(), "a");
+			});
 		return true;
 	}
 
@@ -1405,26 +1328,120 @@ public:
 			}
 			++ticksThisSecond;
 
-			eventDispatcher.dispatch(&CoreEventHandler::onTick, us, now);
-
-			for (auto it = httpFutures.begin(); it != httpFutures.end();)
 			{
-				HTTPAsyncIO* httpIO = *it;
-				if (httpIO->tryExec())
+				ProfileScope tickScope(&profiler, tickSection);
+				if (profiler.isProfiling())
 				{
-					delete httpIO;
-					it = httpFutures.erase(it);
+					eventDispatcher.all([this, us, now](CoreEventHandler* handler)
+						{
+							ProfileScope scope(&profiler, getTickSection(handler));
+							handler->onTick(us, now);
+						});
 				}
 				else
 				{
-					++it;
+					eventDispatcher.dispatch(&CoreEventHandler::onTick, us, now);
 				}
+
+				ProfileScope httpScope(&profiler, httpSection);
+				httpClients.deliver();
 			}
 
 			std::this_thread::sleep_until(now + sleepDuration);
 		}
 	}
 
+	int getTickSection(CoreEventHandler* handler)
+	{
+		auto it = tickSections.find(handler);
+		if (it != tickSections.end())
+		{
+			return it->second;
+		}
+
+		String name = "tick:";
+		const void* object = dynamic_cast<const void*>(handler);
+		if (handler == &players)
+		{
+			name += "Players";
+		}
+		else if (IComponent* component = components.findByObject(object))
+		{
+			name += String(component->componentName());
+		}
+		else if (std::any_of(networks.begin(), networks.end(), [object](INetwork* network)
+					 {
+						 return dynamic_cast<const void*>(network) == object;
+					 }))
+		{
+			name += "Network";
+		}
+		else
+		{
+			name += "Unknown";
+		}
+
+		const int section = profiler.getSection(name);
+		tickSections.emplace(handler, section);
+		return section;
+	}
+
+	void onProfileCommand(StringView parameters, const ConsoleCommandSenderData& sender)
+	{
+		const size_t split = parameters.find(' ');
+		const StringView action = parameters.substr(0, split);
+		if (action == "start")
+		{
+			profiler.start();
+			console->sendMessage(sender, "Profiling started.");
+		}
+		else if (action == "stop")
+		{
+			profiler.stop();
+			console->sendMessage(sender, "Profiling stopped.");
+		}
+		else if (action == "reset")
+		{
+			profiler.clear();
+			console->sendMessage(sender, "Profiler timings cleared.");
+		}
+		else if (action == "show")
+		{
+			char line[256];
+			snprintf(line, sizeof(line), "Profiled for %.3f seconds:", profiler.elapsed().count() / 1000000.0);
+			console->sendMessage(sender, line);
+			size_t shown = 0;
+			for (const TickProfiler::Section* section : profiler.sorted())
+			{
+				if (shown++ == 20)
+				{
+					break;
+				}
+				snprintf(line, sizeof(line), "  %s: %llu calls, %.3f ms total, %.1f us avg, %lld us max", section->name.c_str(), (unsigned long long)section->calls, section->total.count() / 1000.0, double(section->total.count()) / section->calls, (long long)section->max.count());
+				console->sendMessage(sender, line);
+			}
+		}
+		else if (action == "dump")
+		{
+			// Always the same file, console and RCON users must not be able to pick which file gets overwritten
+			const String path = "profile.json";
+			std::ofstream file(path);
+			if (file.good())
+			{
+				file << profiler.toJSON().dump(4);
+				console->sendMessage(sender, "Profiler timings written to \"" + path + "\".");
+			}
+			else
+			{
+				console->sendMessage(sender, "Unable to write profiler timings to \"" + path + "\".");
+			}
+		}
+		else
+		{
+			console->sendMessage(sender, "Usage: profile <start|stop|reset|show|dump>");
+		}
+	}
+
 	void setThreadSleep(Microseconds value) override
 	{
 		sleepTimer = value;
@@ -1485,10 +1502,16 @@ public:
 		, ticksPerSecond(0u)
 		, ticksThisSecond(0u)
 		, EnableLogTimestamp(false)
+		, logWriter(*this)
 	{
 		// Initialize start time
 		getTickCount();
 
+		addExtension(&profiler, false);
+		tickSection = profiler.getSection("tick");
+		httpSection = profiler.getSection("tick:http");
+		players.setProfiler(profiler);
+
 		players.getPlayerConnectDispatcher().addEventHandler(this, EventPriority_FairlyLow);
 
 		// Read config params before loading config file
@@ -1626,8 +1649,14 @@ public:
 		EnableLogPrefix = *config.getBool("logging.use_prefix");
 		LogTimestampFormat = String(config.getString("logging.timestamp_format"));
 
-		config.optimiseBans();
-		config.writeBans();
+		if (*config.getBool("logging.use_async_writer"))
+		{
+			logWriter.start();
+		}
+
+		httpClients.start(*config.getInt("network.http_threads"), *config.getInt("network.http_queue_size"));
+
+		config.settleBans();
 		components.load(this);
 		config.init(components);
 		players.init(components); // Players must ALWAYS be initialised before components
@@ -1653,10 +1682,14 @@ public:
 
 		players.getPlayerConnectDispatcher().removeEventHandler(this);
 
+		// Responses can't be delivered to components once they're gone
+		httpClients.stop();
+
 		players.free();
 		networks.clear();
 		components.free();
 
+		logWriter.stop();
 		if (logFile)
 		{
 			fclose(logFile);
@@ -1730,7 +1763,7 @@ public:
 		va_end(args);
 	}
 
-	void logToStream(FILE* stream, const char* iso8601, const char* prefix, const char* message)
+	void logToStream(FILE* stream, const char* iso8601, const char* prefix, const char* message, bool flush = true)
 	{
 		if (iso8601[0])
 		{
@@ -1743,28 +1776,37 @@ public:
 		}
 		fputs(message, stream);
 		fputs("\n", stream);
-		fflush(stream);
-	}
-
-	virtual void vlogLn(LogLevel level, const char* fmt, va_list args) override
-	{
-		vlogLnInternal(level, false, fmt, args);
-	}
-
-	virtual void vlogLnU8(LogLevel level, const char* fmt, va_list args) override
-	{
-		vlogLnInternal(level, true, fmt, args);
+		if (flush)
+		{
+			fflush(stream);
+		}
 	}
 
-	virtual void vlogLnInternal(LogLevel level, bool utf8, const char* fmt, va_list args)
+	/// Format the log timestamp of a time, reusing the last one for the same second
+	/// The cache is per thread as workers such as the database thread log too
+	const char* getLogTimestamp(std::time_t time)
 	{
-#ifndef _DEBUG
-		if (level == LogLevel::Debug)
+		thread_local std::time_t logTimestampTime = -1;
+		thread_local char logTimestamp[32] = { 0 };
+		if (time != logTimestampTime)
 		{
-			return;
-		}
+			logTimestampTime = time;
+			logTimestamp[0] = 0;
+			// std::localtime returns a shared buffer, use the reentrant versions
+			std::tm local {};
+#ifdef _WIN32
+			localtime_s(&local, &time);
+#else
+			localtime_r(&time, &local);
 #endif
+			std::strftime(logTimestamp, sizeof(logTimestamp), LogTimestampFormat.c_str(), &local);
+		}
+		return logTimestamp;
+	}
 
+	/// Write a log line to the console and the log file
+	void writeLogLine(LogLevel level, bool utf8, const char* iso8601, const char* prefix, const char* message, bool flush)
+	{
 #ifdef BUILD_WINDOWS
 		_lock_locales();
 		UINT oldCP = 0;
@@ -1787,15 +1829,64 @@ public:
 		}
 #endif
 
+		FILE* stream
+			= stdout;
+		if (level == LogLevel::Error)
+		{
+			stream = stderr;
+		}
+		logToStream(stream, iso8601, prefix, message, flush);
+		if (logFile)
+		{
+			logToStream(logFile, iso8601, prefix, message, flush);
+		}
+
 #ifdef BUILD_WINDOWS
+		if (utf8)
+		{
+			if (oldLocaleSaved)
+			{
+				std::setlocale(LC_CTYPE, oldLocale);
+			}
+			SetConsoleOutputCP(oldCP);
+		}
+		_unlock_locales();
+#endif
+	}
+
+	void writeLogBatch(Span<const LogEntry> entries) override
+	{
+		for (const LogEntry& entry : entries)
+		{
+			writeLogLine(entry.level, entry.utf8, entry.timestamp ? getLogTimestamp(entry.time) : "", entry.prefix, entry.message.c_str(), false);
+		}
+		fflush(stdout);
+		fflush(stderr);
+		if (logFile)
+		{
+			fflush(logFile);
+		}
+	}
+
+	virtual void vlogLn(LogLevel level, const char* fmt, va_list args) override
+	{
+		vlogLnInternal(level, false, fmt, args);
+	}
+
+	virtual void vlogLnU8(LogLevel level, const char* fmt, va_list args) override
+	{
+		vlogLnInternal(level, true, fmt, args);
+	}
+
+	virtual void vlogLnInternal(LogLevel level, bool utf8, const char* fmt, va_list args)
+	{
+#ifndef _DEBUG
 		if (level == LogLevel::Debug)
 		{
-			char debugStr[4096] = { 0 };
-			const int written = vsnprintf(debugStr, sizeof(debugStr) - 1, fmt, args);
-			debugStr[written] = '\n';
-			OutputDebugString(debugStr);
+			return;
 		}
 #endif
+
 		const char* prefix = nullptr;
 		if (EnableLogPrefix)
 		{
@@ -1815,54 +1906,44 @@ public:
 			}
 		}
 
-		char iso8601[32] = { 0 };
-		if (EnableLogTimestamp && !LogTimestampFormat.empty())
-		{
-			std::time_t now = WorldTime::to_time_t(WorldTime::now());
-			std::strftime(iso8601, sizeof(iso8601), LogTimestampFormat.c_str(), std::localtime(&now));
-		}
-
+		// Format straight into the stack buffer, only formatting again if the string doesn't fit
 		char main[4096];
-		std::unique_ptr<char[]> fallback; // In case the string is larger than 4096
-		Span<char> buf(main, sizeof(main));
+		std::unique_ptr<char[]> fallback;
+		const char* message = main;
 
 		va_list args_copy;
 		va_copy(args_copy, args);
-		const int len = vsnprintf(nullptr, 0, fmt, args_copy);
+		const int len = vsnprintf(main, sizeof(main), fmt, args_copy);
 		va_end(args_copy);
 
-		if (len > sizeof(main))
+		if (len < 0)
 		{
-			// Stack won't fit our string; allocate space for it
-			fallback.reset(new char[len]);
-			buf = Span<char>(fallback.get(), len);
+			main[0] = 0;
 		}
-		buf[0] = 0;
-		vsnprintf(buf.data(), buf.size(), fmt, args);
-
-		FILE* stream
-			= stdout;
-		if (level == LogLevel::Error)
-		{
-			stream = stderr;
-		}
-		logToStream(stream, iso8601, prefix, buf.data());
-		if (logFile)
+		else if (size_t(len) >= sizeof(main))
 		{
-			logToStream(logFile, iso8601, prefix, buf.data());
+			// Stack won't fit our string; allocate space for it
+			fallback.reset(new char[len + 1]);
+			vsnprintf(fallback.get(), len + 1, fmt, args);
+			message = fallback.get();
 		}
 
 #ifdef BUILD_WINDOWS
-		if (utf8)
+		if (level == LogLevel::Debug)
 		{
-			if (oldLocaleSaved)
-			{
-				std::setlocale(LC_CTYPE, oldLocale);
-			}
-			SetConsoleOutputCP(oldCP);
+			OutputDebugString(message);
+			OutputDebugString("\n");
 		}
-		_unlock_locales();
 #endif
+
+		const bool timestamp = EnableLogTimestamp && !LogTimestampFormat.empty();
+		const std::time_t now = timestamp ? WorldTime::to_time_t(WorldTime::now()) : 0;
+		if (logWriter.running())
+		{
+			logWriter.push(LogEntry { level, utf8, timestamp, prefix, now, message });
+			return;
+		}
+		writeLogLine(level, utf8, timestamp ? getLogTimestamp(now) : "", prefix, message, true);
 	}
 
 	IPlayerPool& getPlayers() override
@@ -2010,8 +2091,22 @@ public:
 
 	void requestHTTP(HTTPResponseHandler* handler, HTTPRequestType type, StringView url, StringView data) override
 	{
-		HTTPAsyncIO* httpIO = new HTTPAsyncIO(handler, type, url, data);
-		httpFutures.emplace(httpIO);
+		pushHTTPRequest(HTTPRequest { handler, type, String(url), String(data), false, "" });
+	}
+
+	void pushHTTPRequest(HTTPRequest&& request)
+	{
+		const String url = request.url;
+		if (httpClients.push(std::move(request)))
+		{
+			httpQueueFull = false;
+		}
+		else if (!httpQueueFull)
+		{
+			// Only logged once until the queue has room again so a flood of requests doesn't flood the log too
+			httpQueueFull = true;
+			logLn(LogLevel::Warning, "HTTP request queue is full, failing requests such as %.*s until it has room (network.http_queue_size).", PRINT_VIEW(url));
+		}
 	}
 
 	bool sha256(StringView password, StringView salt, StaticArray<char, 64 + 1>& output) const override
@@ -2049,6 +2144,8 @@ public:
 		commands.emplace("reloadlog");
 		commands.emplace("config");
 		commands.emplace("varlist");
+		commands.emplace("streamstats");
+		commands.emplace("profile");
 	}
 
 	bool onConsoleText(StringView command, StringView parameters, const ConsoleCommandSenderData& sender) override
@@ -2080,6 +2177,16 @@ public:
 			updateNetworks();
 			return true;
 		}
+		else if (command == "streamstats")
+		{
+			console->sendMessage(sender, "Player streaming evaluated " + std::to_string(players.lastTickStreamCandidates) + " candidates and streamed in " + std::to_string(players.lastTickStreamIns) + " players last tick.");
+			return true;
+		}
+		else if (command == "profile")
+		{
+			onProfileCommand(parameters, sender);
+			return true;
+		}
 		else if (command == "varlist")
 		{
 			console->sendMessage(sender, "Console variables:");
@@ -2111,7 +2218,6 @@ public:
 
 	void requestHTTP4(HTTPResponseHandler* handler, HTTPRequestType type, StringView url, StringView data) override
 	{
-		HTTPAsyncIO* httpIO = new HTTPAsyncIO(handler, type, url, data, true, config.getString("network.bind"));
-		httpFutures.emplace(httpIO);
+		pushHTTPRequest(HTTPRequest { handler, type, String(url), String(data), true, String(config.getString("network.bind")) });
 	}
 };
\ No newline at end of file
@@ -0,0 +1,322 @@
+/*
+ *  This Source Code Form is subject to the terms of the Mozilla Public License,
+ *  v. 2.0. If a copy of the MPL was not distributed with this file, You can
+ *  obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ *  The original code is copyright (c) 2022, open.mp team and contributors.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <core.hpp>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <types.hpp>
+
+#pragma clang diagnostic push
+#pragma clang diagnostic ignored "-Wlogical-op-parentheses"
+#define CPPHTTPLIB_OPENSSL_SUPPORT
+#include <httplib.h>
+#pragma clang diagnostic pop
+
+using namespace Impl;
+
+/// A request made with ICore::requestHTTP, answered on the main thread
+struct HTTPRequest
+{
+	HTTPResponseHandler* handler;
+	HTTPRequestType type;
+	String url;
+	String data;
+	bool forceV4;
+	String bindAddr;
+	int response;
+	String body;
+};
+
+/// Runs HTTP requests on a fixed set of worker threads which keep their connections open between requests to the same host
+/// Responses are queued and handed to their handlers by deliver(), which the main thread calls once per tick
+class HTTPClientPool final : public NoCopy
+{
+public:
+	/// Connections kept open by each worker, the least recently used one is closed above this
+	static constexpr size_t MaxConnectionsPerWorker = 16;
+
+	~HTTPClientPool()
+	{
+		stop();
+	}
+
+	bool running() const
+	{
+		return running_;
+	}
+
+	void start(size_t workers, size_t maxQueued)
+	{
+		if (running_)
+		{
+			return;
+		}
+
+		running_ = true;
+		maxQueued_ = std::max<size_t>(maxQueued, 1);
+		workers_.resize(std::max<size_t>(workers, 1));
+		for (std::unique_ptr<Worker>& worker : workers_)
+		{
+			worker = std::make_unique<Worker>();
+			worker->thread = std::thread(&HTTPClientPool::run, this, std::ref(*worker));
+		}
+	}
+
+	/// Cancel the requests being made and drop the queued ones and responses which weren't delivered
+	void stop()
+	{
+		{
+			std::scoped_lock lock(mutex_);
+			if (!running_)
+			{
+				return;
+			}
+			running_ = false;
+			queue_.clear();
+		}
+		wake_.notify_all();
+
+		for (std::unique_ptr<Worker>& worker : workers_)
+		{
+			{
+				std::scoped_lock lock(worker->mutex);
+				if (worker->active)
+				{
+					worker->active->stop();
+				}
+			}
+			worker->thread.join();
+		}
+		workers_.clear();
+
+		std::scoped_lock lock(completedMutex_);
+		completed_.clear();
+		completedCount_ = 0;
+	}
+
+	/// Queue a request, returns false if the queue is full in which case the handler gets an error response on the next delivery
+	bool push(HTTPRequest&& request)
+	{
+		{
+			std::scoped_lock lock(mutex_);
+			if (running_ && queue_.size() < maxQueued_)
+			{
+				queue_.emplace_back(std::move(request));
+				wake_.notify_one();
+				return true;
+			}
+		}
+
+		request.response = int(httplib::Error::Canceled);
+		complete(std::move(request));
+		return false;
+	}
+
+	/// Call the handlers of the requests which finished since the last call, only locks when there are any
+	void deliver()
+	{
+		if (completedCount_.load(std::memory_order_acquire) == 0)
+		{
+			return;
+		}
+
+		{
+			std::scoped_lock lock(completedMutex_);
+			delivering_.swap(completed_);
+			completedCount_ = 0;
+		}
+
+		for (HTTPRequest& request : delivering_)
+		{
+			request.handler->onHTTPResponse(request.response, request.body);
+		}
+		delivering_.clear();
+	}
+
+private:
+	/// A connection to a host, reused by requests to the same host made with the same options
+	struct Connection
+	{
+		String key;
+		std::unique_ptr<httplib::Client> client;
+	};
+
+	struct Worker
+	{
+		std::thread thread;
+		std::mutex mutex;
+		httplib::Client* active = nullptr; ///< The client making a request, stopped to cancel it
+	};
+
+	/// Split a URL into the scheme and host, and the path, http:// is optional
+	static void splitURL(StringView url, String& host, String& path)
+	{
+		constexpr StringView http = "http://";
+		constexpr StringView https = "https://";
+
+		StringView urlNoPrefix = url;
+		bool secure = false;
+		if (url.find(http) == 0)
+		{
+			urlNoPrefix = url.substr(http.size());
+		}
+		else if (url.find(https) == 0)
+		{
+			urlNoPrefix = url.substr(https.size());
+			secure = true;
+		}
+
+		StringView domain = urlNoPrefix;
+		path = "/";
+		const size_t idx = urlNoPrefix.find_first_of('/');
+		if (idx != StringView::npos)
+		{
+			domain = urlNoPrefix.substr(0, idx);
+			path = String(urlNoPrefix.substr(idx));
+		}
+
+		host = String(secure ? https : http) + String(domain);
+	}
+
+	/// Get the connection to a host, most recently used last
+	static httplib::Client& connect(DynamicArray<Connection>& connections, const String& host, const HTTPRequest& request)
+	{
+		String key = host + (request.forceV4 ? "|4|" : "||") + request.bindAddr;
+		for (auto it = connections.begin(); it != connections.end(); ++it)
+		{
+			if (it->key == key)
+			{
+				std::rotate(it, it + 1, connections.end());
+				return *connections.back().client;
+			}
+		}
+
+		if (connections.size() >= MaxConnectionsPerWorker)
+		{
+			connections.erase(connections.begin());
+		}
+
+		std::unique_ptr<httplib::Client> client = std::make_unique<httplib::Client>(host.c_str());
+		client->set_default_headers({ { "User-Agent", "open.mp server" } });
+		client->enable_server_certificate_verification(true);
+		client->set_follow_location(true);
+		client->set_connection_timeout(Seconds(5));
+		client->set_read_timeout(Seconds(60));
+		client->set_write_timeout(Seconds(5));
+		client->set_keep_alive(true);
+
+		if (request.forceV4)
+		{
+			client->set_address_family(AF_INET);
+		}
+
+		if (!request.bindAddr.empty())
+		{
+			client->set_interface(request.bindAddr);
+		}
+
+		connections.push_back(Connection { std::move(key), std::move(client) });
+		return *connections.back().client;
+	}
+
+	static void execute(httplib::Client& client, const String& path, HTTPRequest& request)
+	{
+		httplib::Result res(nullptr, httplib::Error::Canceled);
+		switch (request.type)
+		{
+		case HTTPRequestType_Get:
+			res = client.Get(path.c_str());
+			break;
+		case HTTPRequestType_Post:
+			res = client.Post(path.c_str(), request.data, "application/x-www-form-urlencoded");
+			break;
+		case HTTPRequestType_Head:
+			res = client.Head(path.c_str());
+			break;
+		}
+
+		if (res)
+		{
+			request.body = std::move(res.value().body);
+			request.response = res.value().status;
+		}
+		else
+		{
+			request.response = int(res.error());
+		}
+	}
+
+	void run(Worker& worker)
+	{
+		DynamicArray<Connection> connections;
+		String host;
+		String path;
+		for (;;)
+		{
+			HTTPRequest request;
+			{
+				std::unique_lock lock(mutex_);
+				wake_.wait(lock, [this]()
+					{
+						return !queue_.empty() || !running_;
+					});
+				if (!running_)
+				{
+					break;
+				}
+				request = std::move(queue_.front());
+				queue_.pop_front();
+			}
+
+			splitURL(request.url, host, path);
+			httplib::Client& client = connect(connections, host, request);
+			{
+				// Checked under the worker's lock so stop() either sees the client or the worker sees it stopping
+				std::scoped_lock lock(worker.mutex);
+				if (!running_)
+				{
+					break;
+				}
+				worker.active = &client;
+			}
+
+			execute(client, path, request);
+
+			{
+				std::scoped_lock lock(worker.mutex);
+				worker.active = nullptr;
+			}
+			complete(std::move(request));
+		}
+	}
+
+	void complete(HTTPRequest&& request)
+	{
+		std::scoped_lock lock(completedMutex_);
+		completed_.emplace_back(std::move(request));
+		completedCount_.store(completed_.size(), std::memory_order_release);
+	}
+
+	DynamicArray<std::unique_ptr<Worker>> workers_;
+	std::atomic_bool running_ = false;
+	std::mutex mutex_;
+	std::condition_variable wake_;
+	std::deque<HTTPRequest> queue_;
+	size_t maxQueued_ = 0;
+
+	std::mutex completedMutex_;
+	std::atomic_size_t completedCount_ = 0;
+	DynamicArray<HTTPRequest> completed_;
+	DynamicArray<HTTPRequest> delivering_;
+};
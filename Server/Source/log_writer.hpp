@@ -0,0 +1,164 @@
+/*
+ *  This Source Code Form is subject to the terms of the Mozilla Public License,
+ *  v. 2.0. If a copy of the MPL was not distributed with this file, You can
+ *  obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ *  The original code is copyright (c) 2022, open.mp team and contributors.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <core.hpp>
+#include <ctime>
+#include <mutex>
+#include <thread>
+#include <types.hpp>
+
+using namespace Impl;
+
+/// A formatted log line waiting to be written
+struct LogEntry
+{
+	LogLevel level;
+	bool utf8;
+	bool timestamp; ///< Whether to write the time the line was logged at
+	const char* prefix;
+	std::time_t time;
+	String message;
+};
+
+/// Writes batches of log lines, called from the log writer's thread
+struct LogSink
+{
+	virtual void writeLogBatch(Span<const LogEntry> entries) = 0;
+};
+
+/// Writes log lines from a background thread so logging never waits on the console or disk
+/// Lines are written in the order they're pushed, in batches with one flush per batch
+class LogWriter final : public NoCopy
+{
+public:
+	/// Queued message bytes above which messages and debug lines are dropped and warnings and errors wait for the writer
+	static constexpr size_t MaxQueuedBytes = 4 * 1024 * 1024;
+
+	LogWriter(LogSink& sink)
+		: sink_(sink)
+		, running_(false)
+	{
+	}
+
+	~LogWriter()
+	{
+		stop();
+	}
+
+	bool running() const
+	{
+		return running_;
+	}
+
+	void start()
+	{
+		if (!running_)
+		{
+			running_ = true;
+			thread_ = std::thread(&LogWriter::run, this);
+		}
+	}
+
+	/// Write everything queued and stop the thread
+	void stop()
+	{
+		if (thread_.joinable())
+		{
+			{
+				std::scoped_lock lock(mutex_);
+				running_ = false;
+			}
+			wake_.notify_all();
+			thread_.join();
+		}
+	}
+
+	void push(LogEntry&& entry)
+	{
+		{
+			std::unique_lock lock(mutex_);
+			if (queuedBytes_ >= MaxQueuedBytes)
+			{
+				if (entry.level == LogLevel::Debug || entry.level == LogLevel::Message)
+				{
+					++dropped_;
+					return;
+				}
+				space_.wait(lock, [this]()
+					{
+						return queuedBytes_ < MaxQueuedBytes || !running_;
+					});
+			}
+			queuedBytes_ += entry.message.size();
+			queue_.emplace_back(std::move(entry));
+		}
+		wake_.notify_one();
+	}
+
+	/// Run fn while no lines are being written, e.g. to reopen the log file
+	template <typename Fn>
+	void pause(Fn fn)
+	{
+		std::scoped_lock lock(writeMutex_);
+		fn();
+	}
+
+private:
+	void run()
+	{
+		DynamicArray<LogEntry> batch;
+		for (;;)
+		{
+			size_t dropped;
+			{
+				std::unique_lock lock(mutex_);
+				wake_.wait(lock, [this]()
+					{
+						return !queue_.empty() || !running_;
+					});
+				if (queue_.empty() && !running_)
+				{
+					break;
+				}
+				batch.swap(queue_);
+				queuedBytes_ = 0;
+				dropped = dropped_;
+				dropped_ = 0;
+			}
+			space_.notify_all();
+
+			if (dropped)
+			{
+				const LogEntry& first = batch.front();
+				LogEntry warning { LogLevel::Warning, false, first.timestamp, first.prefix ? "[Warning] " : nullptr, first.time, "Dropped " + std::to_string(dropped) + " log messages, the log writer couldn't keep up." };
+				batch.emplace(batch.begin(), std::move(warning));
+			}
+
+			{
+				std::scoped_lock lock(writeMutex_);
+				sink_.writeLogBatch(Span<const LogEntry>(batch.data(), batch.size()));
+			}
+			batch.clear();
+		}
+	}
+
+	LogSink& sink_;
+	std::thread thread_;
+	std::atomic_bool running_;
+	std::mutex mutex_;
+	std::mutex writeMutex_;
+	std::condition_variable wake_;
+	std::condition_variable space_;
+	DynamicArray<LogEntry> queue_;
+	size_t queuedBytes_ = 0;
+	size_t dropped_ = 0;
+};
@@ -52,12 +52,90 @@ EPlayerNameStatus Player::setName(StringView name)
 	return EPlayerNameStatus::Updated;
 }
 
-void Player::updateMarkers(Milliseconds updateRate, bool limit, float radius, TimePoint now)
+/// Marker moves smaller than this many units aren't sent, radar blips can't show them anyway
+static constexpr int MarkerMoveThreshold = 2;
+/// Every this many marker updates all markers are sent again in case a packet was lost
+static constexpr unsigned MarkerRefreshInterval = 5;
+
+bool Player::addExtension(IExtension* ext, bool autoDeleteExt)
+{
+	if (!IExtensible::addExtension(ext, autoDeleteExt))
+	{
+		return false;
+	}
+	const int slot = pool_.getExtensionSlot(ext->getExtensionID());
+	if (slot != -1)
+	{
+		extensionSlots_[slot] = ext;
+	}
+	return true;
+}
+
+bool Player::removeExtension(UID id)
+{
+	if (!IExtensible::removeExtension(id))
+	{
+		return false;
+	}
+	const int slot = pool_.getExtensionSlot(id);
+	if (slot != -1)
+	{
+		extensionSlots_[slot] = nullptr;
+	}
+	return true;
+}
+
+int Player::getExtensionSlot(UID id) const
+{
+	return pool_.getExtensionSlot(id);
+}
+
+void Player::updateMarkers(bool limit, float radius)
 {
-	if (duration_cast<Milliseconds>(now - lastMarkerUpdate_) > updateRate)
+	if (sentMarkers_.empty())
+	{
+		sentMarkers_.resize(PLAYER_POOL_SIZE, SentMarker { false, false, 0, 0, 0 });
+	}
+
+	const bool refresh = markerUpdates_++ % MarkerRefreshInterval == 0;
+	const Vector2 pos = pos_;
+	DynamicArray<NetCode::Packet::PlayerMarkersSync::Marker>& markers = pool_.markersBuffer;
+	markers.clear();
+
+	for (IPlayer* other : pool_.storage.entries())
 	{
-		lastMarkerUpdate_ = now;
-		NetCode::Packet::PlayerMarkersSync markersSync(pool_, *this, limit, radius);
+		if (other == this)
+		{
+			continue;
+		}
+
+		const int pid = static_cast<Player*>(other)->poolID;
+		const PlayerPool::MarkerSnapshot& snapshot = pool_.markerSnapshots[pid];
+
+		// get other player's color; first check if it has a custom one set with IPlayer::setOtherColour or not, if not, use their global colour
+		Colour colour;
+		bool hasPlayerSpecificColour = getOtherColour(*other, colour);
+		if (!hasPlayerSpecificColour)
+		{
+			colour = other->getColour();
+		}
+
+		const Vector2 dist2D = snapshot.pos - pos;
+		const bool visible = snapshot.active && virtualWorld_ == snapshot.virtualWorld && colour.a > 0 && (!limit || glm::dot(dist2D, dist2D) < radius * radius);
+
+		SentMarker& sent = sentMarkers_[pid];
+		if (!refresh && sent.sent && sent.visible == visible && (!visible || (std::abs(sent.x - snapshot.x) < MarkerMoveThreshold && std::abs(sent.y - snapshot.y) < MarkerMoveThreshold && std::abs(sent.z - snapshot.z) < MarkerMoveThreshold)))
+		{
+			continue;
+		}
+
+		sent = SentMarker { true, visible, snapshot.x, snapshot.y, snapshot.z };
+		markers.push_back(NetCode::Packet::PlayerMarkersSync::Marker { uint16_t(pid), visible, snapshot.x, snapshot.y, snapshot.z });
+	}
+
+	if (!markers.empty())
+	{
+		NetCode::Packet::PlayerMarkersSync markersSync(Span<const NetCode::Packet::PlayerMarkersSync::Marker>(markers.data(), markers.size()));
 		PacketHelper::send(markersSync, *this);
 	}
 }
@@ -236,6 +314,7 @@ void Player::streamInForPlayer(IPlayer& other)
 		{
 			++numStreamed;
 			streamedFor_.add(pid, other);
+			static_cast<Player&>(other).streamedPlayers_.add(poolID, *this);
 			NetCode::RPC::PlayerStreamIn playerStreamInRPC(other.getClientVersion() == ClientVersion::ClientVersion_SAMP_03DL);
 			playerStreamInRPC.PlayerID = poolID;
 
@@ -277,6 +356,60 @@ void Player::streamInForPlayer(IPlayer& other)
 	}
 }
 
+void Player::setVirtualWorld(int vw)
+{
+	if (vw == virtualWorld_)
+	{
+		return;
+	}
+
+	virtualWorld_ = vw;
+	pool_.updateStreamIndex(*this);
+
+	if (version_ == ClientVersion::ClientVersion_SAMP_037)
+		return;
+
+	NetCode::RPC::SetPlayerVirtualWorld setWorld;
+	setWorld.worldId = vw;
+	PacketHelper::send(setWorld, *this);
+}
+
+void Player::broadcastSyncPacket(Span<uint8_t> data, int channel) const
+{
+	// Hand the packet to the network once for all recipients so its buffer is shared rather than set up per peer
+	DynamicArray<IPlayer*>& recipients = pool_.syncPacketRecipients;
+	recipients.clear();
+	INetwork* network = nullptr;
+	for (IPlayer* p : streamedFor_.entries())
+	{
+		Player* player = static_cast<Player*>(p);
+		if (player == this || !shouldSendSyncPacket(player))
+		{
+			continue;
+		}
+
+		INetwork* peerNetwork = player->netData_.network;
+		if (network == nullptr)
+		{
+			network = peerNetwork;
+		}
+
+		if (peerNetwork == network)
+		{
+			recipients.push_back(player);
+		}
+		else
+		{
+			player->sendPacket(data, channel);
+		}
+	}
+
+	if (network && !recipients.empty())
+	{
+		network->sendPacketToMany(Span<IPlayer* const>(recipients.data(), recipients.size()), data, channel);
+	}
+}
+
 void Player::setSkin(int skin, bool send = true)
 {
 	uint32_t customSkin = 0;
@@ -353,6 +486,7 @@ void Player::streamOutForPlayer(IPlayer& other)
 	{
 		--static_cast<Player&>(other).numStreamed_;
 		streamedFor_.remove(pid, other);
+		static_cast<Player&>(other).streamedPlayers_.remove(poolID, *this);
 		NetCode::RPC::PlayerStreamOut playerStreamOutRPC;
 		playerStreamOutRPC.PlayerID = poolID;
 		PacketHelper::send(playerStreamOutRPC, other);
@@ -69,6 +69,8 @@ struct Player final : public IPlayer, public PoolIDProvider, public NoCopy
 	Colour colour_;
 	FlatHashMap<int, Colour> othersColours_;
 	UniqueIDArray<IPlayer, PLAYER_POOL_SIZE> streamedFor_;
+	/// Players streamed in for this player, the reverse of streamedFor_
+	UniqueIDArray<IPlayer, PLAYER_POOL_SIZE> streamedPlayers_;
 	int virtualWorld_;
 	int team_;
 	uint32_t skin_;
@@ -102,7 +104,15 @@ struct Player final : public IPlayer, public PoolIDProvider, public NoCopy
 	bool enableCameraTargeting_;
 	bool widescreen_;
 	uint16_t numStreamed_;
-	TimePoint lastMarkerUpdate_;
+	/// The state of every other player's marker as last sent to this player
+	struct SentMarker
+	{
+		bool sent;
+		bool visible;
+		int16_t x, y, z;
+	};
+	DynamicArray<SentMarker> sentMarkers_;
+	unsigned markerUpdates_;
 	int cameraTargetPlayer_, cameraTargetVehicle_, cameraTargetObject_, cameraTargetActor_;
 	int targetPlayer_, targetActor_;
 	TimePoint chatBubbleExpiration_;
@@ -140,10 +150,37 @@ struct Player final : public IPlayer, public PoolIDProvider, public NoCopy
 
 	IFixesComponent* fixesComponent_;
 
+	/// The extensions with a slot registered in the pool, also kept in miscExtensions for components querying by UID
+	StaticArray<IExtension*, PlayerExtensionSlotCount> extensionSlots_;
+
 	void clearExtensions()
 	{
 		freeExtensions();
 		miscExtensions.clear();
+		extensionSlots_.fill(nullptr);
+	}
+
+	bool addExtension(IExtension* ext, bool autoDeleteExt) override;
+
+	bool removeExtension(IExtension* ext) override
+	{
+		return removeExtension(ext->getExtensionID());
+	}
+
+	bool removeExtension(UID id) override;
+
+	IExtension* getExtensionInSlot(int slot) override
+	{
+		return (slot >= 0 && slot < PlayerExtensionSlotCount) ? extensionSlots_[slot] : nullptr;
+	}
+
+	int getExtensionSlot(UID id) const override;
+
+	/// Fill a newly registered slot with the extension if it was added before the slot existed
+	void fillExtensionSlot(int slot, UID id)
+	{
+		auto it = miscExtensions.find(id);
+		extensionSlots_[slot] = it == miscExtensions.end() ? nullptr : it->second.first;
 	}
 
 	void reset()
@@ -181,9 +218,11 @@ struct Player final : public IPlayer, public PoolIDProvider, public NoCopy
 
 		streamedFor_.clear();
 		streamedFor_.add(poolID, *this);
+		streamedPlayers_.clear();
 
 		othersColours_.clear();
-		lastMarkerUpdate_ = TimePoint();
+		sentMarkers_.clear();
+		markerUpdates_ = 0;
 		cameraTargetPlayer_ = INVALID_PLAYER_ID;
 		cameraTargetVehicle_ = INVALID_VEHICLE_ID;
 		cameraTargetObject_ = INVALID_OBJECT_ID;
@@ -237,7 +276,7 @@ struct Player final : public IPlayer, public PoolIDProvider, public NoCopy
 		, enableCameraTargeting_(false)
 		, widescreen_(0)
 		, numStreamed_(0)
-		, lastMarkerUpdate_()
+		, markerUpdates_(0)
 		, cameraTargetPlayer_(INVALID_PLAYER_ID)
 		, cameraTargetVehicle_(INVALID_VEHICLE_ID)
 		, cameraTargetObject_(INVALID_OBJECT_ID)
@@ -266,6 +305,7 @@ struct Player final : public IPlayer, public PoolIDProvider, public NoCopy
 	{
 		weapons_.fill({ 0, 0 });
 		skillLevels_.fill(MAX_SKILL_LEVEL);
+		extensionSlots_.fill(nullptr);
 	}
 
 	void ban(StringView reason) override;
@@ -430,21 +470,7 @@ struct Player final : public IPlayer, public PoolIDProvider, public NoCopy
 
 	/// Attempt to broadcast a packet derived from NetworkPacketBase to the player's streamed peers
 	/// @param packet The packet to send
-	void broadcastSyncPacket(Span<uint8_t> data, int channel) const override
-	{
-		for (IPlayer* p : streamedFor_.entries())
-		{
-			Player* player = static_cast<Player*>(p);
-			if (player == this)
-			{
-				continue;
-			}
-			if (shouldSendSyncPacket(player))
-			{
-				player->sendPacket(data, channel);
-			}
-		}
-	}
+	void broadcastSyncPacket(Span<uint8_t> data, int channel) const override;
 
 	void createExplosion(Vector3 vec, int type, float radius) override
 	{
@@ -1539,29 +1565,24 @@ removeWeapon_has_weapon:
 		return virtualWorld_;
 	}
 
-	void setVirtualWorld(int vw) override
-	{
-		if (vw == virtualWorld_)
-		{
-			return;
-		}
-
-		virtualWorld_ = vw;
-
-		if (version_ == ClientVersion::ClientVersion_SAMP_037)
-			return;
-
-		NetCode::RPC::SetPlayerVirtualWorld setWorld;
-		setWorld.worldId = vw;
-		PacketHelper::send(setWorld, *this);
-	}
+	void setVirtualWorld(int vw) override;
 
 	void setTransform(GTAQuat tm) override
 	{
 		rotTransform_ = tm;
 	}
 
-	void updateMarkers(Milliseconds updateRate, bool limit, float radius, TimePoint now);
+	/// Send the changes to other players' markers since the last update, using the marker states computed by the pool
+	void updateMarkers(bool limit, float radius);
+
+	/// Forget the marker sent for a player so it's sent again in full, e.g. after their ID was freed
+	void resetSentMarker(int pid)
+	{
+		if (size_t(pid) < sentMarkers_.size())
+		{
+			sentMarkers_[pid].sent = false;
+		}
+	}
 
 	void updateGameTime(Milliseconds syncRate, TimePoint now)
 	{
@@ -9,6 +9,7 @@
 #pragma once
 
 #include "player_impl.hpp"
+#include <Impl/spatial_index_impl.hpp>
 #include <Server/Components/Console/console.hpp>
 
 struct PlayerPool final : public IPlayerPool, public NetworkEventHandler, public PlayerUpdateEventHandler, public CoreEventHandler
@@ -35,10 +36,33 @@ struct PlayerPool final : public IPlayerPool, public NetworkEventHandler, public
 	ICustomModelsComponent* modelsComponent = nullptr;
 	IFixesComponent* fixesComponent_ = nullptr;
 	StreamConfigHelper streamConfigHelper;
+	SpatialIndex<IPlayer> streamIndex;
+	DynamicArray<Pair<IPlayer*, Vector3>> streamCandidatesBuffer;
+	StreamInQueue<IPlayer*> streamInQueue;
+	size_t streamCandidates = 0;
+	size_t lastTickStreamCandidates = 0;
+	size_t streamIns = 0;
+	size_t lastTickStreamIns = 0;
+	/// Recipients of the sync packet being broadcast, reused between packets
+	DynamicArray<IPlayer*> syncPacketRecipients;
+	/// A player's marker as seen by everyone, computed once per marker update
+	struct MarkerSnapshot
+	{
+		bool active;
+		int virtualWorld;
+		Vector2 pos;
+		int16_t x, y, z;
+	};
+	StaticArray<MarkerSnapshot, PLAYER_POOL_SIZE> markerSnapshots;
+	/// Markers of the packet being built, reused between recipients
+	DynamicArray<NetCode::Packet::PlayerMarkersSync::Marker> markersBuffer;
+	TimePoint lastMarkersUpdate;
 	int* markersShow;
 	int* markersUpdateRate;
 	bool* markersLimit;
 	float* markersLimitRadius;
+	/// Slots given to player extensions with registerExtensionSlot, in registration order
+	FlatHashMap<UID, int> extensionSlots;
 	int* gameTimeUpdateRate;
 	bool* useAllAnimations_;
 	bool* validateAnimations_;
@@ -46,6 +70,21 @@ struct PlayerPool final : public IPlayerPool, public NetworkEventHandler, public
 	int* maxBots;
 	StaticArray<bool, 256> allowNickCharacter;
 
+	/// Record dispatch times of the player events into the profiler
+	void setProfiler(ITickProfilerExtension& profiler)
+	{
+		playerSpawnDispatcher.setProfileSection(&profiler, profiler.getSection("event:PlayerSpawn"));
+		playerConnectDispatcher.setProfileSection(&profiler, profiler.getSection("event:PlayerConnect"));
+		playerStreamDispatcher.setProfileSection(&profiler, profiler.getSection("event:PlayerStream"));
+		playerTextDispatcher.setProfileSection(&profiler, profiler.getSection("event:PlayerText"));
+		playerShotDispatcher.setProfileSection(&profiler, profiler.getSection("event:PlayerShot"));
+		playerChangeDispatcher.setProfileSection(&profiler, profiler.getSection("event:PlayerChange"));
+		playerDamageDispatcher.setProfileSection(&profiler, profiler.getSection("event:PlayerDamage"));
+		playerClickDispatcher.setProfileSection(&profiler, profiler.getSection("event:PlayerClick"));
+		playerCheckDispatcher.setProfileSection(&profiler, profiler.getSection("event:PlayerCheck"));
+		playerUpdateDispatcher.setProfileSection(&profiler, profiler.getSection("event:PlayerUpdate"));
+	}
+
 	struct PlayerRequestSpawnRPCHandler : public SingleNetworkInEventHandler
 	{
 		PlayerPool& self;
@@ -462,6 +501,7 @@ struct PlayerPool final : public IPlayerPool, public NetworkEventHandler, public
 				}
 
 				player.setArmedWeapon(0);
+				self.updateStreamIndex(player);
 
 				// Make sure to restream player on spawn
 				for (IPlayer* other : self.storage.entries())
@@ -730,6 +770,7 @@ struct PlayerPool final : public IPlayerPool, public NetworkEventHandler, public
 			}
 
 			player.setState(PlayerState_OnFoot);
+			self.updateStreamIndex(player);
 
 			TimePoint now = Time::now();
 			bool allowedupdate = self.playerUpdateDispatcher.stopAtFalse(
@@ -802,6 +843,7 @@ struct PlayerPool final : public IPlayerPool, public NetworkEventHandler, public
 					});
 			}
 			player.setState(PlayerState_Spectating);
+			self.updateStreamIndex(player);
 
 			TimePoint now = Time::now();
 			if (self.playerUpdateDispatcher.stopAtFalse([&peer, now](PlayerUpdateEventHandler* handler)
@@ -1126,6 +1168,13 @@ struct PlayerPool final : public IPlayerPool, public NetworkEventHandler, public
 					});
 			}
 			player.setState(PlayerState_Driver);
+			self.updateStreamIndex(player);
+
+			// Passengers are streamed from the vehicle's position, which only the driver updates.
+			for (IPlayer* passenger : vehicle.getPassengers())
+			{
+				self.updateStreamIndex(static_cast<Player&>(*passenger));
+			}
 
 			if (vehicleOk)
 			{
@@ -1193,6 +1242,34 @@ struct PlayerPool final : public IPlayerPool, public NetworkEventHandler, public
 		}
 	} playerWeaponsUpdateHandler;
 
+	int registerExtensionSlot(UID id) override
+	{
+		auto it = extensionSlots.find(id);
+		if (it != extensionSlots.end())
+		{
+			return it->second;
+		}
+		if (extensionSlots.size() >= PlayerExtensionSlotCount)
+		{
+			return -1;
+		}
+
+		const int slot = int(extensionSlots.size());
+		extensionSlots.emplace(id, slot);
+		for (IPlayer* p : storage.entries())
+		{
+			static_cast<Player*>(p)->fillExtensionSlot(slot, id);
+		}
+		return slot;
+	}
+
+	/// Get the slot registered for an extension UID, or -1 if it doesn't have one
+	int getExtensionSlot(UID id) const
+	{
+		auto it = extensionSlots.find(id);
+		return it == extensionSlots.end() ? -1 : it->second;
+	}
+
 	Colour getDefaultColour(int pid) const override
 	{
 		// Predefined set of colours. (https://github.com/Open-GTO/sa-mp-fixes/blob/master/fixes.inc#L3846
@@ -1380,6 +1457,7 @@ struct PlayerPool final : public IPlayerPool, public NetworkEventHandler, public
 					});
 			}
 			player.setState(PlayerState_Passenger);
+			self.updateStreamIndex(player);
 
 			if (vehicleOk)
 			{
@@ -1741,6 +1819,7 @@ struct PlayerPool final : public IPlayerPool, public NetworkEventHandler, public
 			if (player.streamedFor_.valid(other->poolID))
 			{
 				--other->numStreamed_;
+				other->streamedPlayers_.remove(player.poolID, player);
 			}
 			if (other->streamedFor_.valid(player.poolID))
 			{
@@ -1752,8 +1831,12 @@ struct PlayerPool final : public IPlayerPool, public NetworkEventHandler, public
 			{
 				other->othersColours_.erase(it);
 			}
+
+			other->resetSentMarker(player.poolID);
 		}
 
+		streamIndex.remove(player.poolID);
+
 		playerConnectDispatcher.dispatch(&PlayerConnectEventHandler::onPlayerDisconnect, player, reason);
 
 		NetCode::RPC::PlayerQuit packet;
@@ -2012,64 +2095,140 @@ struct PlayerPool final : public IPlayerPool, public NetworkEventHandler, public
 		Player& player = static_cast<Player&>(p);
 		const float maxDist = streamConfigHelper.getDistanceSqr();
 		const Milliseconds gameTimeUpdateRateMS(*gameTimeUpdateRate);
-		const Milliseconds markersUpdateRateMS(*markersUpdateRate);
 		const bool shouldStream = streamConfigHelper.shouldStream(player.poolID, now);
 
 		player.updateGameTime(gameTimeUpdateRateMS, now);
 
-		if (*markersShow == PlayerMarkerMode_Global)
-		{
-			player.updateMarkers(markersUpdateRateMS, *markersLimit, *markersLimitRadius, now);
-		}
-
 		if (shouldStream)
 		{
-			for (IPlayer* other : storage.entries())
+			// Candidates are everyone in the neighbouring cells plus everyone currently streamed in,
+			// so players who moved away still get streamed out.
+			StaticBitset<PLAYER_POOL_SIZE> seen;
+			streamCandidatesBuffer.clear();
+			for (IPlayer* other : player.streamedPlayers_.entries())
+			{
+				const int pid = static_cast<Player*>(other)->poolID;
+				seen.set(pid);
+				streamCandidatesBuffer.emplace_back(other, streamIndex.contains(pid) ? streamIndex.getPosition(pid) : other->getPosition());
+			}
+			streamIndex.query(player.pos_, player.virtualWorld_, streamConfigHelper.getDistance(), [&seen, this](IPlayer& other, Vector3 pos)
+				{
+					const int pid = static_cast<Player&>(other).poolID;
+					if (!seen.test(pid))
+					{
+						seen.set(pid);
+						streamCandidatesBuffer.emplace_back(&other, pos);
+					}
+				});
+			streamCandidates += streamCandidatesBuffer.size();
+
+			for (const Pair<IPlayer*, Vector3>& candidate : streamCandidatesBuffer)
 			{
+				IPlayer* other = candidate.first;
 				if (&player == other)
 				{
 					continue;
 				}
 
-				Vector3 otherPos = other->getPosition();
 				const PlayerState state = other->getState();
-
-				// Use vehicle pos if player is passenger to keep paused players synced.
-				if (state == PlayerState_Passenger)
-				{
-					auto vehicleData = queryExtension<IPlayerVehicleData>(other);
-
-					if (vehicleData)
-					{
-						auto vehicle = vehicleData->getVehicle();
-
-						if (vehicle)
-						{
-							otherPos = vehicle->getPosition();
-						}
-					}
-				}
-
-				const Vector2 dist2D = player.pos_ - otherPos;
-				const bool shouldBeStreamedIn = state != PlayerState_Spectating && state != PlayerState_None && other->getVirtualWorld() == player.virtualWorld_ && glm::dot(dist2D, dist2D) < maxDist;
+				const Vector2 dist2D = player.pos_ - candidate.second;
+				const float distSqr = glm::dot(dist2D, dist2D);
+				const bool shouldBeStreamedIn = state != PlayerState_Spectating && state != PlayerState_None && other->getVirtualWorld() == player.virtualWorld_ && distSqr < maxDist;
 
 				const bool isStreamedIn = other->isStreamedInForPlayer(player);
 				if (!isStreamedIn && shouldBeStreamedIn)
 				{
-					other->streamInForPlayer(player);
+					streamInQueue.push(other, distSqr);
 				}
 				else if (isStreamedIn && !shouldBeStreamedIn)
 				{
 					other->streamOutForPlayer(player);
 				}
 			}
+
+			const size_t room = size_t(std::max(MAX_STREAMED_PLAYERS - int(player.numStreamed_), 0));
+			const size_t budget = streamConfigHelper.getStreamInBudget();
+			const bool waiting = streamInQueue.streamNearest(std::min(budget, room), [&player, this](IPlayer* other)
+				{
+					other->streamInForPlayer(player);
+					if (other->isStreamedInForPlayer(player))
+					{
+						++streamIns;
+					}
+				});
+			if (waiting && budget < room)
+			{
+				streamConfigHelper.requestStream(player.poolID);
+			}
 		}
 
 		return true;
 	}
 
+	/// Refresh the player's cell in the streaming index from their synced position
+	void updateStreamIndex(Player& player)
+	{
+		Vector3 pos = player.pos_;
+
+		// Use vehicle pos if player is passenger to keep paused players synced.
+		if (player.state_ == PlayerState_Passenger)
+		{
+			auto vehicleData = queryExtension<IPlayerVehicleData>(player);
+
+			if (vehicleData)
+			{
+				auto vehicle = vehicleData->getVehicle();
+
+				if (vehicle)
+				{
+					pos = vehicle->getPosition();
+				}
+			}
+		}
+
+		streamIndex.update(player.poolID, player, pos, player.virtualWorld_);
+	}
+
+	/// Compute every player's marker once and send each player the markers which changed for them
+	void updateMarkers()
+	{
+		for (IPlayer* p : storage.entries())
+		{
+			Player* player = static_cast<Player*>(p);
+			MarkerSnapshot& snapshot = markerSnapshots[player->poolID];
+			const PlayerState state = player->getState();
+			snapshot.active = state != PlayerState_None && state != PlayerState_Spectating;
+			snapshot.virtualWorld = player->virtualWorld_;
+			snapshot.pos = player->pos_;
+			snapshot.x = int(player->pos_.x);
+			snapshot.y = int(player->pos_.y);
+			snapshot.z = int(player->pos_.z);
+		}
+
+		for (IPlayer* p : storage.entries())
+		{
+			// Markers used to go out from onPlayerUpdate, keep skipping players who aren't sending sync yet
+			Player* player = static_cast<Player*>(p);
+			if (player->getState() != PlayerState_None)
+			{
+				player->updateMarkers(*markersLimit, *markersLimitRadius);
+			}
+		}
+	}
+
 	void onTick(Microseconds elapsed, TimePoint now) override
 	{
+		lastTickStreamCandidates = streamCandidates;
+		streamCandidates = 0;
+		lastTickStreamIns = streamIns;
+		streamIns = 0;
+
+		if (*markersShow == PlayerMarkerMode_Global && now - lastMarkersUpdate > Milliseconds(*markersUpdateRate))
+		{
+			lastMarkersUpdate = now;
+			updateMarkers();
+		}
+
 		for (auto it = storage.entries().begin(); it != storage.entries().end();)
 		{
 			Player* player = static_cast<Player*>(*it);
@@ -0,0 +1,168 @@
+/*
+ *  This Source Code Form is subject to the terms of the Mozilla Public License,
+ *  v. 2.0. If a copy of the MPL was not distributed with this file, You can
+ *  obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ *  The original code is copyright (c) 2022, open.mp team and contributors.
+ */
+
+#pragma once
+
+#include <nlohmann/json.hpp>
+#include <profiler.hpp>
+#include <types.hpp>
+
+using namespace Impl;
+
+class TickProfiler final : public ITickProfilerExtension
+{
+public:
+	/// Histogram bucket i counts runs shorter than 2^i microseconds, the last one counts everything longer
+	static constexpr size_t HistogramBuckets = 24;
+
+	struct Section
+	{
+		String name;
+		uint64_t calls = 0;
+		Microseconds total = Microseconds(0);
+		Microseconds max = Microseconds(0);
+		StaticArray<uint64_t, HistogramBuckets> histogram;
+
+		Section(StringView name)
+			: name(name)
+		{
+			histogram.fill(0);
+		}
+	};
+
+	bool isProfiling() const override
+	{
+		return profiling_;
+	}
+
+	int getSection(StringView name) override
+	{
+		auto it = ids_.find(String(name));
+		if (it != ids_.end())
+		{
+			return it->second;
+		}
+		const int id = sections_.size();
+		sections_.emplace_back(name);
+		ids_.emplace(String(name), id);
+		return id;
+	}
+
+	void record(int section, Microseconds time) override
+	{
+		if (section < 0 || section >= int(sections_.size()))
+		{
+			return;
+		}
+
+		Section& entry = sections_[section];
+		++entry.calls;
+		entry.total += time;
+		if (time > entry.max)
+		{
+			entry.max = time;
+		}
+
+		size_t bucket = 0;
+		for (uint64_t us = time.count(); us != 0 && bucket != HistogramBuckets - 1; us >>= 1)
+		{
+			++bucket;
+		}
+		++entry.histogram[bucket];
+	}
+
+	void start()
+	{
+		if (!profiling_)
+		{
+			profiling_ = true;
+			started_ = Time::now();
+		}
+	}
+
+	void stop()
+	{
+		if (profiling_)
+		{
+			profiling_ = false;
+			elapsed_ += duration_cast<Microseconds>(Time::now() - started_);
+		}
+	}
+
+	/// Clear all timings, section IDs stay valid
+	void clear()
+	{
+		for (Section& section : sections_)
+		{
+			section = Section(section.name);
+		}
+		elapsed_ = Microseconds(0);
+		started_ = Time::now();
+	}
+
+	/// Get the total time spent profiling
+	Microseconds elapsed() const
+	{
+		return elapsed_ + (profiling_ ? duration_cast<Microseconds>(Time::now() - started_) : Microseconds(0));
+	}
+
+	/// Get the sections which ran at least once, longest total time first
+	DynamicArray<const Section*> sorted() const
+	{
+		DynamicArray<const Section*> ret;
+		for (const Section& section : sections_)
+		{
+			if (section.calls)
+			{
+				ret.push_back(&section);
+			}
+		}
+		std::sort(ret.begin(), ret.end(), [](const Section* a, const Section* b)
+			{
+				return a->total > b->total;
+			});
+		return ret;
+	}
+
+	nlohmann::json toJSON() const
+	{
+		nlohmann::json sections = nlohmann::json::array();
+		for (const Section* section : sorted())
+		{
+			nlohmann::json obj;
+			obj["name"] = section->name;
+			obj["calls"] = section->calls;
+			obj["total_us"] = section->total.count();
+			obj["max_us"] = section->max.count();
+			obj["histogram"] = section->histogram;
+			sections.push_back(obj);
+		}
+
+		nlohmann::json top;
+		top["profiling"] = profiling_;
+		top["elapsed_us"] = elapsed().count();
+		top["sections"] = sections;
+		return top;
+	}
+
+	void freeExtension() override
+	{
+	}
+
+	void reset() override
+	{
+		// Timings carry on over GMX, use the console command to clear them
+	}
+
+private:
+	bool profiling_ = false;
+	TimePoint started_;
+	Microseconds elapsed_ = Microseconds(0);
+	DynamicArray<Section> sections_;
+	FlatHashMap<String, int> ids_;
+};
@@ -1840,56 +1840,44 @@ namespace Packet
 
 	struct PlayerMarkersSync : NetworkPacketBase<208, NetworkPacketType::Packet, OrderingChannel_SyncPacket>
 	{
+		/// A player's marker, players not in the packet keep their marker as it is on the client
+		struct Marker
+		{
+			uint16_t PlayerID;
+			bool Visible;
+			int16_t X;
+			int16_t Y;
+			int16_t Z;
+		};
 
-		IPlayerPool& Pool;
-		IPlayer& FromPlayer;
-		bool Limit;
-		float Radius;
+		Span<const Marker> Markers;
+
+		PlayerMarkersSync(Span<const Marker> markers)
+			: Markers(markers)
+		{
+		}
 
-		PlayerMarkersSync(IPlayerPool& pool, IPlayer& from, bool limit, float radius)
-			: Pool(pool)
-			, FromPlayer(from)
-			, Limit(limit)
-			, Radius(radius)
+		size_t expectedSize() const
 		{
+			return 5 + Markers.size() * 9;
 		}
 
 		void write(NetworkBitStream& bs) const
 		{
-			const int virtualWorld = FromPlayer.getVirtualWorld();
-			const Vector3 pos = FromPlayer.getPosition();
-			const FlatPtrHashSet<IPlayer>& players = Pool.entries();
 			bs.writeUINT8(NetCode::Packet::PlayerMarkersSync::PacketID);
 
 			// TODO isNPC
 
-			bs.writeUINT32(players.size() - 1);
-			for (IPlayer* other : players)
+			bs.writeUINT32(Markers.size());
+			for (const Marker& marker : Markers)
 			{
-				if (other == &FromPlayer)
-				{
-					continue;
-				}
-
-				// get other player's color; first check if it has a custom one set with IPlayer::setOtherColour or not, if not, use their global colour
-				Colour colour;
-				bool hasPlayerSpecificColour = FromPlayer.getOtherColour(*other, colour);
-				if (!hasPlayerSpecificColour)
-				{
-					colour = other->getColour();
-				}
-
-				const Vector3 otherPos = other->getPosition();
-				const PlayerState otherState = other->getState();
-				bool streamMarker = otherState != PlayerState_None && otherState != PlayerState_Spectating && virtualWorld == other->getVirtualWorld() && colour.a > 0 && (!Limit || glm::dot(Vector2(pos), Vector2(otherPos)) < Radius * Radius);
-
-				bs.writeUINT16(other->getID());
-				bs.writeBIT(streamMarker);
-				if (streamMarker)
+				bs.writeUINT16(marker.PlayerID);
+				bs.writeBIT(marker.Visible);
+				if (marker.Visible)
 				{
-					bs.writeINT16(int(otherPos.x));
-					bs.writeINT16(int(otherPos.y));
-					bs.writeINT16(int(otherPos.z));
+					bs.writeINT16(marker.X);
+					bs.writeINT16(marker.Y);
+					bs.writeINT16(marker.Z);
 				}
 			}
 		}
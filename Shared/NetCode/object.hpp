@@ -19,6 +19,12 @@ namespace NetCode
 {
 namespace RPC
 {
+	/// Get the bytes a material is expected to take in a packet, compressed text is assumed to not grow
+	inline size_t getMaterialSizeHint(const ObjectMaterialData& data)
+	{
+		return 16 + data.textOrTXD.length() + data.fontOrTexture.length();
+	}
+
 	struct SetPlayerObjectMaterial : NetworkPacketBase<84, NetworkPacketType::RPC, OrderingChannel_SyncRPC>
 	{
 		int ObjectID;
@@ -30,6 +36,11 @@ namespace RPC
 		{
 		}
 
+		size_t expectedSize() const
+		{
+			return 4 + getMaterialSizeHint(MaterialData);
+		}
+
 		bool read(NetworkBitStream& bs)
 		{
 			return false;
@@ -84,6 +95,19 @@ namespace RPC
 		{
 		}
 
+		size_t expectedSize() const
+		{
+			size_t size = 64;
+			for (const ObjectMaterialData& data : Materials)
+			{
+				if (data.used)
+				{
+					size += getMaterialSizeHint(data);
+				}
+			}
+			return size;
+		}
+
 		bool read(NetworkBitStream& bs)
 		{
 			return false;
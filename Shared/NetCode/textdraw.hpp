@@ -40,6 +40,11 @@ namespace RPC
 		int Color2;
 		HybridString<256> Text;
 
+		size_t expectedSize() const
+		{
+			return 67 + Text.length();
+		}
+
 		bool read(NetworkBitStream& bs)
 		{
 			return false;
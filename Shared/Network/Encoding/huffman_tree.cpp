@@ -156,6 +156,43 @@ void DataStructures::HuffmanEncodingTree::GenerateFromFrequencyTable(unsigned in
         // Reset the bitstream for the next iteration
         bitStream.reset();
     }
+
+    GenerateLookupTables();
+}
+
+void DataStructures::HuffmanEncodingTree::GenerateLookupTables(void)
+{
+    accumulateCodes = true;
+    for (int counter = 0; counter < 256; counter++) {
+        const CharacterEncoding& encoding = encodingTable[counter];
+
+        // Codes are written with shifts of a 64 bit accumulator holding less than a byte of previous codes
+        if (encoding.bitLength > MaxAccumulatedCodeBits) {
+            accumulateCodes = false;
+            codeTable[counter] = 0;
+            continue;
+        }
+
+        uint64_t code = 0;
+        for (int bit = 0; bit < encoding.bitLength; bit++)
+            code = (code << 1) | ((encoding.encoding[bit >> 3] >> (7 - (bit & 7))) & 1);
+        codeTable[counter] = code;
+    }
+
+    for (int index = 0; index < (1 << LookupBits); index++) {
+        HuffmanEncodingTreeNode* node = root;
+        int bit = 0;
+        while (bit < LookupBits && node->left) {
+            node = ((index >> (LookupBits - 1 - bit)) & 1) ? node->right : node->left;
+            ++bit;
+        }
+
+        if (node->left == nullptr) {
+            decodeTable[index] = { nullptr, node->value, (unsigned char)bit };
+        } else {
+            decodeTable[index] = { node, 0, 0 };
+        }
+    }
 }
 
 // Pass an array of bytes to array and a preallocated BitStream to receive the output
@@ -163,11 +200,59 @@ void DataStructures::HuffmanEncodingTree::EncodeArray(unsigned char* input, unsi
 {
     unsigned counter;
 
-    // For each input byte, Write out the corresponding series of 1's and 0's that give the encoded representation
+    if (!accumulateCodes) {
+        for (counter = 0; counter < sizeInBytes; counter++)
+            output->WriteBits(encodingTable[input[counter]].encoding, encodingTable[input[counter]].bitLength, false); // Data is left aligned
+
+        PadToByteBoundary(output);
+        return;
+    }
+
+    // Collect the codes in an accumulator and write whole bytes of them to the output in chunks
+    unsigned char buffer[256];
+    int bufferBytes = 0;
+    uint64_t accumulator = 0;
+    int accumulatedBits = 0;
+
     for (counter = 0; counter < sizeInBytes; counter++) {
-        output->WriteBits(encodingTable[input[counter]].encoding, encodingTable[input[counter]].bitLength, false); // Data is left aligned
+        const int bitLength = encodingTable[input[counter]].bitLength;
+        if (accumulatedBits + bitLength > 64) {
+            while (accumulatedBits >= 8) {
+                accumulatedBits -= 8;
+                buffer[bufferBytes++] = (unsigned char)(accumulator >> accumulatedBits);
+            }
+
+            if (bufferBytes > int(sizeof(buffer)) - 8) {
+                output->WriteBits(buffer, bytesToBits(bufferBytes), false);
+                bufferBytes = 0;
+            }
+        }
+
+        accumulator = (accumulator << bitLength) | codeTable[input[counter]];
+        accumulatedBits += bitLength;
+    }
+
+    while (accumulatedBits >= 8) {
+        accumulatedBits -= 8;
+        buffer[bufferBytes++] = (unsigned char)(accumulator >> accumulatedBits);
+    }
+
+    if (accumulatedBits > 0) {
+        // The remaining bits are left aligned in the last byte
+        buffer[bufferBytes] = (unsigned char)(accumulator << (8 - accumulatedBits));
+    }
+
+    if (bufferBytes > 0 || accumulatedBits > 0) {
+        output->WriteBits(buffer, bytesToBits(bufferBytes) + accumulatedBits, false);
     }
 
+    PadToByteBoundary(output);
+}
+
+void DataStructures::HuffmanEncodingTree::PadToByteBoundary(NetworkBitStream* output)
+{
+    unsigned counter;
+
     // Byte align the output so the unassigned remaining bits don't equate to some actual value
     if (output->GetNumberOfBitsUsed() % 8 != 0) {
         // Find an input that is longer than the remaining bits.  Write out part of it to pad the output to be byte aligned.
@@ -183,7 +268,81 @@ void DataStructures::HuffmanEncodingTree::EncodeArray(unsigned char* input, unsi
     }
 }
 
+namespace {
+/// Get count bits from offset in a bitstream's data, count must be between 1 and 24
+uint32_t PeekBits(const unsigned char* data, int offset, int count)
+{
+    const int first = offset >> 3;
+    const int last = (offset + count - 1) >> 3;
+    uint32_t word = 0;
+    for (int i = first; i <= last; i++)
+        word = (word << 8) | data[i];
+    return (word >> (bytesToBits(last - first + 1) - (offset & 7) - count)) & ((uint32_t(1) << count) - 1);
+}
+}
+
 unsigned DataStructures::HuffmanEncodingTree::DecodeArray(NetworkBitStream* input, unsigned& sizeInBits, unsigned maxCharsToWrite, unsigned char* output, bool skip)
+{
+    // Reads past the end of the stream give 0 bits without moving the read offset, leave that to the bit by bit decoder
+    if (input->GetNumberOfUnreadBits() < int(sizeInBits))
+        return DecodeBits(input, sizeInBits, maxCharsToWrite, output, skip);
+
+    const unsigned char* data = input->GetData();
+    int offset = input->GetReadOffset();
+    unsigned outputWriteIndex = 0;
+
+    // Resolve up to LookupBits bits per step with the decode table, only walking the tree for longer codes.
+    // Bits left over which don't make a full code are the padding written by EncodeArray and are skipped.
+    while (sizeInBits) {
+        if (outputWriteIndex == maxCharsToWrite) {
+            if (skip) {
+                offset += sizeInBits;
+                sizeInBits = 0;
+            }
+
+            input->SetReadOffset(offset);
+            return maxCharsToWrite;
+        }
+
+        const int peekBits = sizeInBits < unsigned(LookupBits) ? int(sizeInBits) : LookupBits;
+        const DecodeEntry& entry = decodeTable[PeekBits(data, offset, peekBits) << (LookupBits - peekBits)];
+
+        if (entry.bitLength != 0 && entry.bitLength <= peekBits) {
+            output[outputWriteIndex++] = entry.value;
+            offset += entry.bitLength;
+            sizeInBits -= entry.bitLength;
+            continue;
+        }
+
+        if (peekBits < LookupBits) {
+            offset += sizeInBits;
+            sizeInBits = 0;
+            break;
+        }
+
+        HuffmanEncodingTreeNode* currentNode = entry.node;
+        offset += LookupBits;
+        sizeInBits -= LookupBits;
+        while (sizeInBits && currentNode->left) {
+            if (data[offset >> 3] & (0x80 >> (offset & 7)))
+                currentNode = currentNode->right;
+            else
+                currentNode = currentNode->left;
+
+            ++offset;
+            --sizeInBits;
+        }
+
+        if (currentNode->left == nullptr) {
+            output[outputWriteIndex++] = currentNode->value;
+        }
+    }
+
+    input->SetReadOffset(offset);
+    return outputWriteIndex;
+}
+
+unsigned DataStructures::HuffmanEncodingTree::DecodeBits(NetworkBitStream* input, unsigned& sizeInBits, unsigned maxCharsToWrite, unsigned char* output, bool skip)
 {
     HuffmanEncodingTreeNode* currentNode;
 
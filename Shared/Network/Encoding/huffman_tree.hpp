@@ -40,6 +40,9 @@ namespace DataStructures {
         unsigned DecodeArray(NetworkBitStream* input, unsigned& sizeInBits, unsigned maxCharsToWrite, unsigned char* output, bool skip = true);
         void DecodeArray(unsigned char* input, unsigned sizeInBits, NetworkBitStream* output);
 
+        /// Decode the bits one at a time by walking the tree, the reference the table driven DecodeArray() is checked against
+        unsigned DecodeBits(NetworkBitStream* input, unsigned& sizeInBits, unsigned maxCharsToWrite, unsigned char* output, bool skip);
+
         /// Given a frequency table of 256 elements, all with a frequency of 1 or more, generate the tree
         void GenerateFromFrequencyTable(unsigned int frequencyTable[256]);
 
@@ -47,6 +50,24 @@ namespace DataStructures {
         void FreeMemory(void);
 
     private:
+        /// Bits resolved by one decode table lookup
+        static constexpr int LookupBits = 10;
+
+        /// The result of decoding LookupBits bits from the root
+        struct DecodeEntry {
+            /// The node reached when the code is longer than LookupBits, decoding carries on bit by bit from it
+            HuffmanEncodingTreeNode* node;
+            unsigned char value;
+            /// The length of the code decoded, 0 when it's longer than LookupBits
+            unsigned char bitLength;
+        };
+
+        /// Build the tables used by EncodeArray and DecodeArray from the tree and encoding table
+        void GenerateLookupTables(void);
+
+        /// Pad the output of EncodeArray to a whole byte with part of a code longer than the padding
+        void PadToByteBoundary(NetworkBitStream* output);
+
         /// The root node of the tree
 
         HuffmanEncodingTreeNode* root;
@@ -60,6 +81,17 @@ namespace DataStructures {
 
         CharacterEncoding encodingTable[256];
 
+        /// Longest code EncodeArray() collects in its 64 bit accumulator, which holds up to 7 bits of previous codes
+        static constexpr int MaxAccumulatedCodeBits = 56;
+
+        /// Codes right aligned in an integer, for writing them with shifts
+        uint64_t codeTable[256];
+
+        /// Whether every code is at most MaxAccumulatedCodeBits long, a tree from a degenerate frequency table can have longer ones
+        bool accumulateCodes;
+
+        DecodeEntry decodeTable[1 << LookupBits];
+
         void InsertNodeIntoSortedList(HuffmanEncodingTreeNode* node, std::list<HuffmanEncodingTreeNode*>& huffmanEncodingTreeNodeList) const;
     };
 }
@@ -28,6 +28,75 @@
 #include <arpa/inet.h>
 #endif
 
+namespace {
+/// Heap buffers of bitstreams outgrowing the stack buffer, rounded up to power of two size classes.
+/// Released buffers are kept per thread and handed to the next bitstream of the same class, so
+/// building large packets every tick doesn't keep going through malloc and realloc.
+class BufferPool {
+public:
+    /// The smallest class, anything smaller fits the stack buffer
+    constexpr static const int MinClassSize = 512;
+    /// Buffers larger than the largest class (64KB) are allocated and freed directly
+    constexpr static const int ClassCount = 8;
+    /// Free buffers kept per class, the rest are freed
+    constexpr static const size_t MaxFreePerClass = 16;
+
+    ~BufferPool()
+    {
+        for (Impl::DynamicArray<unsigned char*>& buffers : free_) {
+            for (unsigned char* buffer : buffers) {
+                free(buffer);
+            }
+        }
+    }
+
+    /// Get a buffer of at least size bytes, size is updated to the buffer's capacity
+    unsigned char* allocate(int& size)
+    {
+        const int index = sizeClass(size);
+        if (index == -1) {
+            return (unsigned char*)malloc(size);
+        }
+        size = MinClassSize << index;
+        Impl::DynamicArray<unsigned char*>& buffers = free_[index];
+        if (buffers.empty()) {
+            return (unsigned char*)malloc(size);
+        }
+        unsigned char* buffer = buffers.back();
+        buffers.pop_back();
+        return buffer;
+    }
+
+    /// Return a buffer got from allocate() with its capacity
+    void release(unsigned char* buffer, int size)
+    {
+        const int index = sizeClass(size);
+        if (index == -1 || (MinClassSize << index) != size || free_[index].size() >= MaxFreePerClass) {
+            free(buffer);
+            return;
+        }
+        free_[index].push_back(buffer);
+    }
+
+private:
+    /// Get the class for a size, or -1 if it's too big for one
+    static int sizeClass(int size)
+    {
+        int index = 0;
+        while ((MinClassSize << index) < size) {
+            if (++index == ClassCount) {
+                return -1;
+            }
+        }
+        return index;
+    }
+
+    StaticArray<Impl::DynamicArray<unsigned char*>, ClassCount> free_;
+};
+
+thread_local BufferPool Buffers;
+}
+
 NetworkBitStream::NetworkBitStream()
 {
     numberOfBitsUsed = 0;
@@ -51,7 +120,7 @@ NetworkBitStream::NetworkBitStream(int initialBytesToAllocate)
         data = (unsigned char*)stackData;
         numberOfBitsAllocated = StackAllocationSize * 8;
     } else {
-        data = (unsigned char*)malloc(initialBytesToAllocate);
+        data = Buffers.allocate(initialBytesToAllocate);
         numberOfBitsAllocated = initialBytesToAllocate << 3;
     }
 
@@ -74,7 +143,9 @@ NetworkBitStream::NetworkBitStream(unsigned char* _data, unsigned int lengthInBy
                 data = (unsigned char*)stackData;
                 numberOfBitsAllocated = StackAllocationSize << 3;
             } else {
-                data = (unsigned char*)malloc(lengthInBytes);
+                int capacity = lengthInBytes;
+                data = Buffers.allocate(capacity);
+                numberOfBitsAllocated = capacity << 3;
             }
 
             assert(data);
@@ -97,8 +168,8 @@ void NetworkBitStream::SetNumberOfBitsAllocated(const unsigned int lengthInBits)
 
 NetworkBitStream::~NetworkBitStream()
 {
-    if (copyData && numberOfBitsAllocated > StackAllocationSize << 3)
-        free(data); // Use realloc and free so we are more efficient than delete and new for resizing
+    if (copyData && data && data != stackData)
+        Buffers.release(data, bitsToBytes(numberOfBitsAllocated));
 }
 
 void NetworkBitStream::reset(void)
@@ -531,7 +602,7 @@ void NetworkBitStream::AddBitsAndReallocate(const int numberOfBitsToWrite)
         // Less memory efficient but saves on news and deletes
         newNumberOfBitsAllocated = (numberOfBitsToWrite + numberOfBitsUsed) * 2;
         //		int newByteOffset = bitsToBytes( numberOfBitsAllocated );
-        // Use realloc and free so we are more efficient than delete and new for resizing
+        // Heap buffers come from the per-thread pool and are rounded up to its size class
         int amountToAllocate = bitsToBytes(newNumberOfBitsAllocated);
         if (data == (unsigned char*)stackData) {
 
@@ -540,21 +611,33 @@ void NetworkBitStream::AddBitsAndReallocate(const int numberOfBitsToWrite)
             assert(copyData == true);
 
             if (amountToAllocate > StackAllocationSize) {
-                data = (unsigned char*)malloc(amountToAllocate);
+                data = Buffers.allocate(amountToAllocate);
+                newNumberOfBitsAllocated = bytesToBits(amountToAllocate);
 
                 // need to copy the stack data over to our new memory area too
                 memcpy((void*)data, (void*)stackData, bitsToBytes(numberOfBitsAllocated));
             }
         } else {
             if (copyData == true) {
-                data = (unsigned char*)realloc(data, amountToAllocate);
-                assert(data);
+                unsigned char* new_data = Buffers.allocate(amountToAllocate);
+                assert(new_data);
+                memcpy((void*)new_data, (void*)data, bitsToBytes(numberOfBitsAllocated));
+                Buffers.release(data, bitsToBytes(numberOfBitsAllocated));
+                newNumberOfBitsAllocated = bytesToBits(amountToAllocate);
+                data = new_data;
             } else {
                 copyData = true;
-                unsigned char* new_data = amountToAllocate < StackAllocationSize ? (unsigned char*)stackData : (unsigned char*)malloc(amountToAllocate);
+                unsigned char* new_data;
+                if (amountToAllocate < StackAllocationSize) {
+                    new_data = (unsigned char*)stackData;
+                    amountToAllocate = StackAllocationSize;
+                } else {
+                    new_data = Buffers.allocate(amountToAllocate);
+                }
                 assert(new_data);
                 memcpy((void*)new_data, (void*)data, bitsToBytes(numberOfBitsAllocated));
-                numberOfBitsAllocated = new_data == stackData ? bytesToBits(StackAllocationSize) : amountToAllocate;
+                numberOfBitsAllocated = bytesToBits(amountToAllocate);
+                newNumberOfBitsAllocated = numberOfBitsAllocated;
                 data = new_data;
             }
         }
@@ -46,6 +46,20 @@ std::true_type is_network_packet_impl(NetworkPacketBase<PktID, PktType, PktChann
 template <typename T>
 using is_network_packet = decltype(is_network_packet_impl(std::declval<T&>()));
 
+/// Get the bytes a packet is expected to write, so its bitstream is allocated once up front
+/// Packets which may outgrow the bitstream's stack buffer declare it with a `size_t expectedSize() const` method
+template <typename Packet>
+auto getPacketSizeHint(const Packet& packet, int) -> decltype(int(packet.expectedSize()))
+{
+    return int(packet.expectedSize());
+}
+
+template <typename Packet>
+int getPacketSizeHint(const Packet& packet, long)
+{
+    return 0;
+}
+
 struct PacketHelper {
     /// Attempt to send a packet derived from NetworkPacketBase to the peer
     /// @param packet The packet to send
@@ -53,7 +67,7 @@ struct PacketHelper {
     template <typename Packet, typename E = std::enable_if_t<is_network_packet<Packet>::value>>
     static bool send(const Packet& packet, IPlayer& peer)
     {
-        NetworkBitStream bs;
+        NetworkBitStream bs(getPacketSizeHint(packet, 0));
         packet.write(bs);
         if constexpr (Packet::PacketType == NetworkPacketType::RPC) {
             return peer.sendRPC(Packet::PacketID, Span<uint8_t>(bs.GetData(), bs.GetNumberOfBitsUsed()), Packet::PacketChannel);
@@ -69,7 +83,7 @@ struct PacketHelper {
     template <typename Packet, typename E = std::enable_if_t<is_network_packet<Packet>::value>>
     static void broadcastToSome(const Packet& packet, const FlatPtrHashSet<IPlayer>& players, const IPlayer* skipFrom = nullptr)
     {
-        NetworkBitStream bs;
+        NetworkBitStream bs(getPacketSizeHint(packet, 0));
         packet.write(bs);
         for (IPlayer* peer : players) {
             if (peer != skipFrom) {
@@ -89,7 +103,7 @@ struct PacketHelper {
     template <typename Packet, typename E = std::enable_if_t<is_network_packet<Packet>::value>>
     static void broadcastToStreamed(const Packet& packet, IPlayer& player, bool skipFrom = false)
     {
-        NetworkBitStream bs;
+        NetworkBitStream bs(getPacketSizeHint(packet, 0));
         packet.write(bs);
         if constexpr (Packet::PacketType == NetworkPacketType::RPC) {
             return player.broadcastRPCToStreamed(Packet::PacketID, Span<uint8_t>(bs.GetData(), bs.GetNumberOfBitsUsed()), Packet::PacketChannel, skipFrom);
@@ -103,7 +117,7 @@ struct PacketHelper {
     static void broadcastSyncPacket(const Packet& packet, IPlayer& player)
     {
         static_assert(Packet::PacketType == NetworkPacketType::Packet, "broadcastSyncPacket can only be used with NetworkPacketType::Packet");
-        NetworkBitStream bs;
+        NetworkBitStream bs(getPacketSizeHint(packet, 0));
         packet.write(bs);
         return player.broadcastSyncPacket(Span<uint8_t>(bs.GetData(), bs.GetNumberOfBitsUsed()), Packet::PacketChannel);
     }
@@ -115,7 +129,7 @@ struct PacketHelper {
     template <typename Packet, typename E = std::enable_if_t<is_network_packet<Packet>::value, Packet>>
     static void broadcast(const Packet& packet, IPlayerPool& players, const IPlayer* skipFrom = nullptr)
     {
-        NetworkBitStream bs;
+        NetworkBitStream bs(getPacketSizeHint(packet, 0));
         packet.write(bs);
         if constexpr (Packet::PacketType == NetworkPacketType::RPC) {
             players.broadcastRPC(Packet::PacketID, Span<uint8_t>(bs.GetData(), bs.GetNumberOfBitsUsed()), Packet::PacketChannel, skipFrom);